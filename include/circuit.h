@@ -0,0 +1,437 @@
+#ifndef _circuit_h_
+#define _circuit_h_
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <memory>
+
+#include "matrix.h"
+#include "reversible.h"
+
+namespace mx
+{
+    /**
+     * The maximum number of qubits of dense matrix conversion
+     */
+    const size_t MAX_DENSE_QUBITS = 30;
+
+    /**
+     * The maximum number of register qubits
+     */
+    const size_t MAX_QUBITS = 64;
+
+    /**
+     * The kernel applying the gate to the state vector
+     */
+    enum class GateKernel
+    {
+        matrix,
+        fourier,
+        inverseFourier,
+        hadamard,
+        oracle,
+        reversible,
+        power
+    };
+
+    class Circuit;
+
+    /**
+     * The gate applied to a set of register qubits
+     */
+    class Gate
+    {
+        std::string _name;
+        Matrix _base;
+        indices_t _bits;
+        indices_t _controls;
+        GateKernel _kernel;
+        std::vector<uint64_t> _marked;
+        std::vector<ReversibleOp> _network;
+        std::shared_ptr<const Circuit> _circuit;
+        uint64_t _exponent;
+
+        void validateQubits(void) const;
+        void applySingle(std::complex<double> *cells, const size_t size) const;
+
+    public:
+        /**
+         * Creates the gate
+         * @param name the gate name
+         * @param base the base gate matrix (2^k x 2^k)
+         * @param bits the register qubit of each gate qubit (internal[i] <- bits[i])
+         * @param controls the control qubits (the base gate applies only if all the controls are 1)
+         */
+        Gate(const std::string &name, const Matrix &base, const indices_t &bits, const indices_t &controls = {});
+
+        /**
+         * Creates the gate applied by a dedicated kernel without base matrix
+         * @param name the gate name
+         * @param kernel the kernel
+         * @param bits the register qubit of each gate qubit
+         */
+        Gate(const std::string &name, const GateKernel kernel, const indices_t &bits);
+
+        /**
+         * Creates the phase oracle gate negating the amplitudes of the marked register values
+         * @param name the gate name
+         * @param bits the register qubit of each gate qubit from the least significant
+         * @param marked the marked register values (less than 2^k)
+         */
+        Gate(const std::string &name, const indices_t &bits, const std::vector<uint64_t> &marked);
+
+        /**
+         * Creates the reversible network gate mapping the basis states by bit operations
+         * @param name the gate name
+         * @param bits the register qubit of each gate qubit
+         * @param network the operations in application order on the gate qubits
+         */
+        Gate(const std::string &name, const indices_t &bits, const std::vector<ReversibleOp> &network);
+
+        /**
+         * Creates the power gate repeating the circuit on the gate qubits
+         * @param name the gate name
+         * @param bits the register qubit of each gate qubit
+         * @param circuit the circuit on the gate qubits (0...k-1)
+         * @param exponent the number of repetitions
+         */
+        Gate(const std::string &name, const indices_t &bits, const std::shared_ptr<const Circuit> &circuit, const uint64_t exponent);
+
+        /**
+         * Returns the gate name
+         */
+        const std::string &name(void) const { return _name; }
+
+        /**
+         * Returns the base gate matrix (matrix kernel only)
+         */
+        const Matrix &base(void) const { return _base; }
+
+        /**
+         * Returns the register qubit of each gate qubit
+         */
+        const indices_t &bits(void) const { return _bits; }
+
+        /**
+         * Returns the control qubits
+         */
+        const indices_t &controls(void) const { return _controls; }
+
+        /**
+         * Returns the kernel
+         */
+        const GateKernel kernel(void) const { return _kernel; }
+
+        /**
+         * Returns the sorted marked register values (oracle kernel only)
+         */
+        const std::vector<uint64_t> &marked(void) const { return _marked; }
+
+        /**
+         * Returns the operations on the gate qubits (reversible kernel only)
+         */
+        const std::vector<ReversibleOp> &network(void) const { return _network; }
+
+        /**
+         * Returns the repeated circuit on the gate qubits (power kernel only)
+         */
+        const std::shared_ptr<const Circuit> &circuit(void) const { return _circuit; }
+
+        /**
+         * Returns the number of repetitions (power kernel only)
+         */
+        const uint64_t exponent(void) const { return _exponent; }
+
+        /**
+         * Returns true if the gate is the base matrix on the bits (matrix kernel without controls)
+         */
+        const bool isDense(void) const { return _kernel == GateKernel::matrix && _controls.empty(); }
+
+        /**
+         * Returns the gate qubits followed by the control qubits
+         */
+        const indices_t qubits(void) const;
+
+        /**
+         * Returns the number of register qubits required by the gate
+         */
+        const size_t numQubits(void) const;
+
+        /**
+         * Returns true if the base matrix has a single non zero cell for each column
+         * (the gate maps basis states to basis states with phase)
+         */
+        const bool isPermutation(void) const;
+
+        /**
+         * Returns true if the base matrix is diagonal (the gate only changes the phases)
+         */
+        const bool isDiagonal(void) const;
+
+        /**
+         * Returns the transpose conjugate gate
+         */
+        const Gate dagger(void) const;
+
+        /**
+         * Returns the complex conjugate gate
+         */
+        const Gate conj(void) const;
+
+        /**
+         * Returns the gates of the repeated circuit on the register qubits (power kernel only)
+         */
+        const std::vector<Gate> repeated(void) const;
+
+        /**
+         * Returns the same gate on other qubits
+         * @param bits the register qubit of each gate qubit
+         * @param controls the control qubits
+         */
+        const Gate remap(const indices_t &bits, const indices_t &controls) const;
+
+        /**
+         * Returns the equivalent dense gate on the gate and control qubits
+         * (the base matrix is the identity but for the block with all the controls set)
+         */
+        const Gate expand(void) const;
+
+        /**
+         * Returns the equivalent gates of at most 2 gate qubits in application order with the same controls.
+         * The Walsh-Hadamard transform splits in H gates, the Fourier transforms in H, controlled phase
+         * and SWAP gates; the other kernels return the gate itself
+         */
+        const std::vector<Gate> decomposed(void) const;
+
+        /**
+         * Returns the dense matrix of gate
+         */
+        const Matrix matrix(void) const;
+
+        /**
+         * Applies the gate in place to the dense state vector
+         * only to the amplitudes with all the control qubits set
+         * @param cells the state vector cells (2^n)
+         */
+        vu::ComplexVect &apply(vu::ComplexVect &cells) const;
+
+        /**
+         * Applies the gate in place to the dense state vector block
+         * @param cells the state vector cells
+         * @param size the number of cells (power of 2, at least 2^n)
+         */
+        void apply(std::complex<double> *cells, const size_t size) const;
+    };
+
+    /**
+     * The sequence of gates
+     */
+    class Circuit
+    {
+        std::vector<Gate> _gates;
+
+    public:
+        /**
+         * Creates the circuit
+         * @param gates the gates in application order
+         */
+        Circuit(const std::vector<Gate> &gates);
+
+        /**
+         * Creates the single gate circuit
+         * @param gate the gate
+         */
+        Circuit(const Gate &gate) : Circuit(std::vector<Gate>{gate}) {}
+
+        /**
+         * Returns the gates in application order
+         */
+        const std::vector<Gate> &gates(void) const { return _gates; }
+
+        /**
+         * Returns the number of register qubits required by the circuit
+         */
+        const size_t numQubits(void) const;
+
+        /**
+         * Returns the circuit applying the right circuit and then this circuit
+         */
+        const Circuit operator*(const Circuit &right) const;
+
+        /**
+         * Returns the transpose conjugate circuit
+         */
+        const Circuit dagger(void) const;
+
+        /**
+         * Returns the equivalent circuit with the layers of consecutive H gates on different qubits
+         * fused into Walsh-Hadamard transform gates and the runs of consecutive X, CNOT, CCNOT, SWAP gates
+         * compiled into reversible network gates
+         */
+        const Circuit fused(void) const;
+
+        /**
+         * Applies in place the fused circuit to the batch of kets stored as the columns of row major block.
+         * The gates apply once to the whole block with the column index as the least significant qubits
+         * @param cells the block cells (2^n x numCols)
+         * @param numCols the number of kets
+         */
+        vu::ComplexVect &apply(vu::ComplexVect &cells, const size_t numCols = 1) const;
+
+        /**
+         * Returns the dense matrix of circuit
+         */
+        const Matrix matrix(void) const;
+    };
+
+    /**
+     * Returns the X gate
+     * @param qubit the qubit
+     */
+    extern const Gate xGate(const size_t qubit);
+
+    /**
+     * Returns the Y gate
+     * @param qubit the qubit
+     */
+    extern const Gate yGate(const size_t qubit);
+
+    /**
+     * Returns the Z gate
+     * @param qubit the qubit
+     */
+    extern const Gate zGate(const size_t qubit);
+
+    /**
+     * Returns the H gate
+     * @param qubit the qubit
+     */
+    extern const Gate hGate(const size_t qubit);
+
+    /**
+     * Returns the S gate
+     * @param qubit the qubit
+     */
+    extern const Gate sGate(const size_t qubit);
+
+    /**
+     * Returns the T gate
+     * @param qubit the qubit
+     */
+    extern const Gate tGate(const size_t qubit);
+
+    /**
+     * Returns the SWAP gate
+     * @param qubit0 the first qubit
+     * @param qubit1 the second qubit
+     */
+    extern const Gate swapGate(const size_t qubit0, const size_t qubit1);
+
+    /**
+     * Returns the CNOT gate
+     * @param data the data qubit
+     * @param control the control qubit
+     */
+    extern const Gate cnotGate(const size_t data, const size_t control);
+
+    /**
+     * Returns the CCNOT gate
+     * @param data the data qubit
+     * @param control0 the first control qubit
+     * @param control1 the second control qubit
+     */
+    extern const Gate ccnotGate(const size_t data, const size_t control0, const size_t control1);
+
+    /**
+     * Returns the controlled gate
+     * @param base the base gate matrix (2^k x 2^k)
+     * @param controls the control qubits
+     * @param targets the target qubits (k qubits)
+     */
+    extern const Gate controlledGate(const Matrix &base, const indices_t &controls, const indices_t &targets);
+
+    /**
+     * Returns the quantum Fourier transform gate
+     * @param qubits the qubits from the least significant
+     * @param inverse true for the inverse transform
+     */
+    extern const Gate qftGate(const indices_t &qubits, const bool inverse);
+
+    /**
+     * Returns the Walsh-Hadamard transform gate (H on each qubit)
+     * @param qubits the qubits
+     */
+    extern const Gate hnGate(const indices_t &qubits);
+
+    /**
+     * Returns the phase oracle gate negating the amplitudes of the marked register values
+     * @param qubits the qubits from the least significant
+     * @param marked the marked register values
+     */
+    extern const Gate oracleGate(const indices_t &qubits, const std::vector<uint64_t> &marked);
+
+    /**
+     * Returns the reversible network operations of the classical reversible gate
+     * (X, CNOT, CCNOT, SWAP with any controls) on the register bits or empty if not reversible
+     * @param gate the gate
+     */
+    extern const std::vector<ReversibleOp> reversibleOps(const Gate &gate);
+
+    /**
+     * Returns the reversible network gate of the classical reversible gates
+     * @param gates the gates in application order
+     */
+    extern const Gate reversibleGate(const std::vector<Gate> &gates);
+
+    /**
+     * Returns the power gate of the circuit.
+     * It applies either the circuit repeatedly or the dense power by binary exponentiation,
+     * whichever has the lower cost for the applied state
+     * @param circuit the circuit
+     * @param exponent the exponent
+     */
+    extern const Gate powerGate(const Circuit &circuit, const uint64_t exponent);
+
+    /**
+     * Returns the RX gate (rotation around the X axis)
+     * @param qubit the qubit
+     * @param theta the rotation angle
+     */
+    extern const Gate rxGate(const size_t qubit, const double theta);
+
+    /**
+     * Returns the RY gate (rotation around the Y axis)
+     * @param qubit the qubit
+     * @param theta the rotation angle
+     */
+    extern const Gate ryGate(const size_t qubit, const double theta);
+
+    /**
+     * Returns the RZ gate (rotation around the Z axis)
+     * @param qubit the qubit
+     * @param theta the rotation angle
+     */
+    extern const Gate rzGate(const size_t qubit, const double theta);
+
+    /**
+     * Returns the phase gate diag(1, e^(i lambda))
+     * @param qubit the qubit
+     * @param lambda the phase angle
+     */
+    extern const Gate phaseGate(const size_t qubit, const double lambda);
+
+    /**
+     * Returns the general single qubit gate U3(theta, phi, lambda)
+     * @param qubit the qubit
+     * @param theta the rotation angle
+     * @param phi the first phase angle
+     * @param lambda the second phase angle
+     */
+    extern const Gate u3Gate(const size_t qubit, const double theta, const double phi, const double lambda);
+}
+
+extern std::ostream &operator<<(std::ostream &stream, const mx::Circuit &circuit);
+extern const std::string to_string(const mx::Circuit &circuit);
+
+#endif
@@ -0,0 +1,274 @@
+#ifndef _decisionDiagram_h_
+#define _decisionDiagram_h_
+
+#include <complex>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+
+#include "matrix.h"
+#include "circuit.h"
+#include "state.h"
+
+namespace mx
+{
+    /**
+     * The table of complex values unique within a tolerance
+     */
+    class ComplexTable
+    {
+        double _tolerance;
+        std::vector<std::complex<double>> _values;
+        std::unordered_map<uint64_t, std::vector<uint32_t>> _cells;
+
+        const uint64_t cellKey(const int64_t re, const int64_t im) const;
+
+    public:
+        /**
+         * The identifier of zero
+         */
+        static constexpr uint32_t ZERO = 0;
+
+        /**
+         * The identifier of one
+         */
+        static constexpr uint32_t ONE = 1;
+
+        /**
+         * Creates the table
+         * @param tolerance the tolerance of equal values
+         */
+        ComplexTable(const double tolerance);
+
+        /**
+         * Returns the identifier of the value equal to the given value within the tolerance
+         * @param value the value
+         */
+        const uint32_t lookup(const std::complex<double> &value);
+
+        /**
+         * Returns the value
+         * @param id the value identifier
+         */
+        const std::complex<double> &value(const uint32_t id) const { return _values[id]; }
+
+        /**
+         * Returns the number of values
+         */
+        const size_t size(void) const { return _values.size(); }
+    };
+
+    /**
+     * The decision diagram edge
+     */
+    struct DDEdge
+    {
+        uint32_t node;
+        uint32_t weight;
+
+        const bool operator==(const DDEdge &other) const { return node == other.node && weight == other.weight; }
+    };
+
+    /**
+     * The decision diagram node (2 edges for vectors, 4 edges for matrices)
+     */
+    struct DDNode
+    {
+        int level;
+        uint32_t numEdges;
+        DDEdge edges[4];
+    };
+
+    /**
+     * The quantum multiple-valued decision diagram package.
+     * The nodes are hash-consed in the unique table,
+     * the edge weights are normalized and stored in the complex table and
+     * the results of add and multiply operations are memoized in the compute tables
+     */
+    class DDPackage
+    {
+        struct NodeHash
+        {
+            const size_t operator()(const DDNode &node) const;
+        };
+        struct NodeEqual
+        {
+            const bool operator()(const DDNode &a, const DDNode &b) const;
+        };
+        struct PairHash
+        {
+            const size_t operator()(const std::pair<uint64_t, uint64_t> &key) const;
+        };
+
+        ComplexTable _complex;
+        std::vector<DDNode> _nodes;
+        std::unordered_map<DDNode, uint32_t, NodeHash, NodeEqual> _unique;
+        std::unordered_map<std::pair<uint64_t, uint64_t>, DDEdge, PairHash> _addTable;
+        std::unordered_map<uint64_t, DDEdge> _mulTable;
+
+        const DDEdge scale(const DDEdge &edge, const uint32_t weight);
+        const DDEdge multiplyNodes(const uint32_t left, const uint32_t right);
+        const DDEdge identity(const int level);
+        const DDEdge buildGate(const Gate &gate, const int level, const size_t row, const size_t col);
+        const DDEdge buildOracle(const Gate &gate, const int level, const std::vector<uint64_t> &marked);
+        const DDEdge buildKet(const vu::ComplexVect &cells, const int level, const size_t offset);
+
+    public:
+        /**
+         * The terminal node identifier
+         */
+        static constexpr uint32_t TERMINAL = 0;
+
+        /**
+         * The zero edge
+         */
+        static constexpr DDEdge ZERO_EDGE = {TERMINAL, ComplexTable::ZERO};
+
+        /**
+         * Creates the package
+         * @param tolerance the tolerance of equal complex values
+         */
+        DDPackage(const double tolerance = 1e-13);
+
+        /**
+         * Returns the node
+         * @param id the node identifier
+         */
+        const DDNode &node(const uint32_t id) const { return _nodes[id]; }
+
+        /**
+         * Returns the weight value of the edge
+         * @param edge the edge
+         */
+        const std::complex<double> &weight(const DDEdge &edge) const { return _complex.value(edge.weight); }
+
+        /**
+         * Returns the number of nodes
+         */
+        const size_t numNodes(void) const { return _nodes.size(); }
+
+        /**
+         * Returns the complex table
+         */
+        const ComplexTable &complexTable(void) const { return _complex; }
+
+        /**
+         * Returns the identifier of the complex value
+         * @param value the value
+         */
+        const uint32_t lookup(const std::complex<double> &value) { return _complex.lookup(value); }
+
+        /**
+         * Returns the normalized edge to the unique node
+         * @param level the node level (qubit index)
+         * @param edges the node edges
+         */
+        const DDEdge makeNode(const int level, const std::vector<DDEdge> &edges);
+
+        /**
+         * Returns the sum of diagrams
+         * @param left the left diagram
+         * @param right the right diagram
+         */
+        const DDEdge add(const DDEdge &left, const DDEdge &right);
+
+        /**
+         * Returns the product of a matrix diagram by a vector or matrix diagram
+         * @param left the matrix diagram
+         * @param right the vector or matrix diagram
+         */
+        const DDEdge multiply(const DDEdge &left, const DDEdge &right);
+
+        /**
+         * Returns the vector diagram of a dense ket
+         * @param ket the ket
+         * @param numQubits the number of qubits
+         */
+        const DDEdge ket(const Matrix &ket, const size_t numQubits);
+
+        /**
+         * Returns the matrix diagram of the gate.
+         * The controls and the oracles are built directly as nodes, the transforms as product of
+         * their decomposed gates, the other kernels by dense expansion
+         * @param gate the gate
+         * @param numQubits the number of qubits
+         */
+        const DDEdge gate(const Gate &gate, const size_t numQubits);
+
+        /**
+         * Returns the vector diagram extended with the added qubits in zero state
+         * @param root the vector diagram
+         * @param numQubits the number of qubits of vector
+         * @param newQubits the number of qubits of result
+         */
+        const DDEdge extend(const DDEdge &root, const size_t numQubits, const size_t newQubits);
+
+        /**
+         * Returns the amplitude of basis state
+         * @param root the vector diagram
+         * @param numQubits the number of qubits
+         * @param index the basis state index
+         */
+        const std::complex<double> amplitude(const DDEdge &root, const size_t numQubits, const uint64_t index) const;
+
+        /**
+         * Returns the number of nodes reachable from the edge
+         * @param root the diagram
+         */
+        const size_t size(const DDEdge &root) const;
+    };
+
+    /**
+     * The state stored as vector decision diagram
+     */
+    class DDState : public State
+    {
+        std::shared_ptr<DDPackage> _package;
+        DDEdge _root;
+        size_t _numQubits;
+
+    public:
+        /**
+         * Creates the state from a dense ket
+         * @param ket the ket
+         */
+        DDState(const Matrix &ket);
+
+        /**
+         * Creates the state
+         * @param package the package
+         * @param root the vector diagram
+         * @param numQubits the number of qubits
+         */
+        DDState(const std::shared_ptr<DDPackage> &package, const DDEdge &root, const size_t numQubits)
+            : _package(package), _root(root), _numQubits(numQubits) {}
+
+        /**
+         * Returns the package
+         */
+        const std::shared_ptr<DDPackage> &package(void) const { return _package; }
+
+        /**
+         * Returns the vector diagram
+         */
+        const DDEdge &root(void) const { return _root; }
+
+        /**
+         * Returns the number of nodes of diagram
+         */
+        const size_t size(void) const { return _package->size(_root); }
+
+        virtual const size_t numQubits(void) const override { return _numQubits; }
+
+        virtual const std::complex<double> at(const uint64_t index) const override;
+
+        virtual const std::vector<std::pair<uint64_t, std::complex<double>>> amplitudes(void) const override;
+
+        virtual const StatePtr transform(const Circuit &circuit) const override;
+
+        virtual const StatePtr project(const size_t qubit, const int outcome, const double probability) const override;
+    };
+}
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef _densityMatrix_h_
+#define _densityMatrix_h_
+
+#include <complex>
+#include <vector>
+
+#include "matrix.h"
+#include "circuit.h"
+
+namespace mx
+{
+    /**
+     * The maximum number of qubits of density matrix
+     */
+    const size_t MAX_DENSITY_QUBITS = MAX_DENSE_QUBITS / 2;
+
+    /**
+     * The density matrix of mixed state.
+     * The cells are stored as a state vector of 2n qubits,
+     * the high n qubits are the row index and the low n qubits are the column index
+     */
+    class DensityMatrix
+    {
+        size_t _numQubits;
+        vu::ComplexVect _cells;
+
+        void extend(const size_t numQubits);
+        void applySuperOperator(const Matrix &superOperator, const size_t qubit);
+
+    public:
+        /**
+         * Creates the pure state density matrix |ket><ket|
+         * @param ket the ket
+         */
+        DensityMatrix(const Matrix &ket);
+
+        /**
+         * Returns the number of qubits
+         */
+        const size_t numQubits(void) const { return _numQubits; }
+
+        /**
+         * Returns the cells (row major)
+         */
+        const vu::ComplexVect &cells(void) const { return _cells; }
+
+        /**
+         * Returns the dense matrix
+         */
+        const Matrix matrix(void) const;
+
+        /**
+         * Applies the gate (rho -> U rho U^) by a column pass and a row pass
+         * @param gate the gate
+         */
+        DensityMatrix &apply(const Gate &gate);
+
+        /**
+         * Applies the circuit
+         * @param circuit the circuit
+         */
+        DensityMatrix &apply(const Circuit &circuit);
+
+        /**
+         * Applies the single qubit channel (rho -> sum K rho K^)
+         * @param kraus the Kraus operators (2x2)
+         * @param qubit the qubit
+         */
+        DensityMatrix &applyChannel(const std::vector<Matrix> &kraus, const size_t qubit);
+
+        /**
+         * Applies the depolarizing channel (rho -> (1-p) rho + p/3 (X rho X + Y rho Y + Z rho Z))
+         * @param qubit the qubit
+         * @param p the error probability
+         */
+        DensityMatrix &depolarize(const size_t qubit, const double p);
+
+        /**
+         * Applies the amplitude damping channel (decay |1> -> |0> with probability gamma)
+         * @param qubit the qubit
+         * @param gamma the decay probability
+         */
+        DensityMatrix &dampAmplitude(const size_t qubit, const double gamma);
+
+        /**
+         * Applies the dephasing channel (rho -> (1-p) rho + p Z rho Z)
+         * @param qubit the qubit
+         * @param p the phase flip probability
+         */
+        DensityMatrix &dephase(const size_t qubit, const double p);
+
+        /**
+         * Returns the trace
+         */
+        const std::complex<double> trace(void) const;
+
+        /**
+         * Returns the expectation value of the operator tr(op rho)
+         * @param op the operator (2^n x 2^n)
+         */
+        const std::complex<double> expectation(const Matrix &op) const;
+
+        /**
+         * Returns the probability of qubit in state |1> (trace of projector)
+         * @param qubit the qubit
+         */
+        const double probability(const size_t qubit) const;
+
+        /**
+         * Returns the reduced density matrix on the kept qubits (partial trace of the others)
+         * @param keep the kept qubits (qubit keep[i] is the qubit i of the result)
+         * @param numThreads the number of threads (0 for hardware concurrency)
+         */
+        const Matrix partialTrace(const indices_t &keep, const size_t numThreads = 0) const;
+    };
+
+    /**
+     * Returns the reduced density matrix on the kept qubits of ket or operator
+     * by a strided accumulation over the traced basis states in O(2^n 2^k),
+     * without building the 4^n density matrix of the ket
+     * @param state the ket (2^n x 1) or the operator (2^n x 2^n)
+     * @param keep the kept qubits (qubit keep[i] is the qubit i of the result)
+     * @param numThreads the number of threads (0 for hardware concurrency)
+     */
+    extern const Matrix partialTrace(const Matrix &state, const indices_t &keep, const size_t numThreads = 0);
+}
+
+#endif
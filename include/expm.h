@@ -0,0 +1,59 @@
+#ifndef _expm_h_
+#define _expm_h_
+
+#include <complex>
+#include <functional>
+
+#include "matrix.h"
+#include "pauli.h"
+
+namespace mx
+{
+    /**
+     * The linear operator applied to the dense vector
+     */
+    typedef std::function<const vu::ComplexVect(const vu::ComplexVect &)> LinearOperator;
+
+    /**
+     * Returns the exponential of square matrix by scaling and squaring of the degree 13 Pade approximant
+     * @param a the matrix
+     */
+    extern const Matrix expm(const Matrix &a);
+
+    /**
+     * Returns the product of the matrix and the vector by parallel rows
+     * @param a the matrix
+     * @param v the vector
+     * @param numThreads the number of threads (0 for hardware concurrency)
+     */
+    extern const vu::ComplexVect multiply(const Matrix &a, const vu::ComplexVect &v, const size_t numThreads = 0);
+
+    /**
+     * Returns exp(t A) v by Arnoldi projections on Krylov subspaces
+     * without building the exponential of the operator.
+     * The time is split in steps of |t| norm(A) bounded to keep each projection accurate
+     * @param t the time
+     * @param a the operator
+     * @param norm the operator norm upper bound
+     * @param v the vector
+     */
+    extern const vu::ComplexVect expv(const std::complex<double> &t, const LinearOperator &a, const double norm, const vu::ComplexVect &v);
+
+    /**
+     * Returns exp(t A) v of dense matrix by Krylov subspaces
+     * @param t the time
+     * @param a the square matrix (size of v)
+     * @param v the vector
+     */
+    extern const vu::ComplexVect expv(const std::complex<double> &t, const Matrix &a, const vu::ComplexVect &v);
+
+    /**
+     * Returns exp(t H) v of Pauli sum by Krylov subspaces on the sparse Pauli string kernels
+     * @param t the time
+     * @param h the Pauli sum
+     * @param v the vector (2^n)
+     */
+    extern const vu::ComplexVect expv(const std::complex<double> &t, const PauliSum &h, const vu::ComplexVect &v);
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef _fourier_h_
+#define _fourier_h_
+
+#include <complex>
+
+#include "matrix.h"
+
+namespace mx
+{
+    /**
+     * Applies in place the quantum Fourier transform to the qubits of dense state vector
+     * |x> -> 1/sqrt(2^k) sum_y e^(2 pi i x y / 2^k) |y>
+     * by radix-2 butterflies with bit reversal (O(k 2^n))
+     * @param cells the state vector cells
+     * @param size the number of cells (power of 2, at least 2^n)
+     * @param qubits the register qubits of the transform from the least significant
+     * @param inverse true for the inverse transform
+     * @param numThreads the number of threads (0 for hardware concurrency)
+     */
+    extern void fourier(std::complex<double> *cells, const size_t size, const indices_t &qubits, const bool inverse, const size_t numThreads = 0);
+
+    /**
+     * Returns the dense matrix of quantum Fourier transform
+     * @param numQubits the number of qubits
+     * @param inverse true for the inverse transform
+     */
+    extern const Matrix fourierMatrix(const size_t numQubits, const bool inverse);
+
+    /**
+     * Applies in place the Walsh-Hadamard transform (H on each qubit) to the qubits of dense state vector
+     * by radix-4 butterflies on pairs of qubits (O(k 2^n))
+     * @param cells the state vector cells
+     * @param size the number of cells (power of 2, at least 2^n)
+     * @param qubits the register qubits of the transform
+     * @param numThreads the number of threads (0 for hardware concurrency)
+     */
+    extern void hadamard(std::complex<double> *cells, const size_t size, const indices_t &qubits, const size_t numThreads = 0);
+
+    /**
+     * Returns the dense matrix of Walsh-Hadamard transform
+     * @param numQubits the number of qubits
+     */
+    extern const Matrix hadamardMatrix(const size_t numQubits);
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef _hybrid_h_
+#define _hybrid_h_
+
+#include <complex>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+#include "matrix.h"
+#include "circuit.h"
+#include "state.h"
+
+namespace mx
+{
+    /**
+     * The Schrödinger-Feynman hybrid simulator.
+     * The register is split at the cut qubit into the low and high halves simulated as dense state vectors.
+     * The gates crossing the cut are decomposed into the sum of products of low and high operators (Schmidt terms),
+     * each choice of terms is a path and the state is the sum of the tensor product of the halves over all the paths
+     */
+    class HybridSimulator
+    {
+        /**
+         * The low and high gates of a term
+         */
+        struct Term
+        {
+            std::vector<Gate> low;
+            std::vector<Gate> high;
+        };
+
+        size_t _numQubits;
+        size_t _cut;
+        uint64_t _in;
+        size_t _numThreads;
+        std::vector<std::vector<Term>> _operations;
+
+        void addGate(const Gate &gate);
+        void run(const std::function<void(const size_t worker, const vu::ComplexVect &low, const vu::ComplexVect &high)> &consumer) const;
+
+    public:
+        /**
+         * Creates the simulator
+         * @param circuit the circuit
+         * @param in the input basis state
+         * @param cut the number of qubits of low half
+         * @param numThreads the number of parallel paths (0 for hardware concurrency)
+         */
+        HybridSimulator(const Circuit &circuit, const uint64_t in, const size_t cut, const size_t numThreads = 0);
+
+        /**
+         * Returns the number of qubits
+         */
+        const size_t numQubits(void) const { return _numQubits; }
+
+        /**
+         * Returns the number of qubits of low half
+         */
+        const size_t cut(void) const { return _cut; }
+
+        /**
+         * Returns the number of paths
+         */
+        const size_t numPaths(void) const;
+
+        /**
+         * Returns the number of parallel workers
+         */
+        const size_t numWorkers(void) const;
+
+        /**
+         * Returns the amplitudes of the output basis states
+         * @param outs the output basis states
+         */
+        const std::vector<std::complex<double>> amplitudes(const std::vector<uint64_t> &outs) const;
+
+        /**
+         * Returns the combined sparse state
+         */
+        const StatePtr state(void) const;
+    };
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef _mappedState_h_
+#define _mappedState_h_
+
+#include <complex>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "matrix.h"
+#include "circuit.h"
+#include "state.h"
+
+namespace mx
+{
+    /**
+     * The default number of qubits of the chunks (16MB)
+     */
+    const size_t DEFAULT_CHUNK_QUBITS = 20;
+
+    /**
+     * The maximum number of qubits of the memory mapped states
+     */
+    const size_t MAX_MAPPED_QUBITS = 40;
+
+    /**
+     * The dense state vector stored in a memory mapped file, larger than the memory.
+     * The gates are applied chunk by chunk in file order; the gates on qubits higher than
+     * the chunk qubits stream the groups of chunks differing by the high qubits through a buffer
+     */
+    class MappedState : public State
+    {
+        std::string _directory;
+        size_t _numQubits;
+        size_t _chunkQubits;
+        int _fd;
+        std::complex<double> *_cells;
+
+        void open(void);
+        void map(const size_t numQubits);
+        void unmap(void);
+
+    public:
+        /**
+         * Creates the state from a dense ket
+         * @param ket the ket
+         * @param chunkQubits the number of qubits of the chunks
+         * @param directory the directory of the mapped file (TMPDIR or /tmp if empty)
+         */
+        MappedState(const Matrix &ket, const size_t chunkQubits = DEFAULT_CHUNK_QUBITS, const std::string &directory = "");
+
+        /**
+         * Creates the copy of the state in a new mapped file
+         * @param other the state
+         */
+        MappedState(const MappedState &other);
+
+        ~MappedState();
+
+        MappedState &operator=(const MappedState &other) = delete;
+
+        /**
+         * Returns the number of qubits of the chunks
+         */
+        const size_t chunkQubits(void) const { return _chunkQubits; }
+
+        /**
+         * Applies the gate
+         * @param gate the gate
+         */
+        MappedState &apply(const Gate &gate);
+
+        /**
+         * Applies the circuit
+         * @param circuit the circuit
+         */
+        MappedState &apply(const Circuit &circuit);
+
+        virtual const size_t numQubits(void) const override { return _numQubits; }
+
+        virtual const std::complex<double> at(const uint64_t index) const override;
+
+        virtual const std::vector<std::pair<uint64_t, std::complex<double>>> amplitudes(void) const override;
+
+        virtual void forEach(const std::function<void(const uint64_t, const std::complex<double> &)> &f) const override;
+
+        virtual const StatePtr transform(const Circuit &circuit) const override;
+
+        virtual const StatePtr project(const size_t qubit, const int outcome, const double probability) const override;
+    };
+}
+
+#endif
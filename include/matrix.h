@@ -118,6 +118,12 @@ namespace mx
          */
         const Matrix transpose(void) const;
 
+        /**
+         * Returns the power of square matrix by binary exponentiation
+         * @param exponent the exponent
+         */
+        const Matrix power(const uint64_t exponent) const;
+
         const Matrix extendsCross(const int size) const;
         const Matrix extendsRows(const int numRows) const;
         const Matrix extendsCols(const int numCols) const;
@@ -133,6 +139,19 @@ namespace mx
     extern const Matrix I_KET;
     extern const Matrix MINUS_I_KET;
 
+    /**
+     * The base gate matrices
+     */
+    extern const Matrix X_GATE;
+    extern const Matrix Y_GATE;
+    extern const Matrix Z_GATE;
+    extern const Matrix H_GATE;
+    extern const Matrix S_GATE;
+    extern const Matrix T_GATE;
+    extern const Matrix CNOT_GATE;
+    extern const Matrix SWAP_GATE;
+    extern const Matrix CCNOT_GATE;
+
     /**
      * Returns the ket base
      * @state the state
@@ -243,6 +262,13 @@ namespace mx
      */
     const Matrix identity(const size_t size);
 
+    /**
+     * Checks for the valid bit map with different values each other
+     *
+     * @param bitMap the bit map
+     */
+    extern void validateBitMap(const indices_t &bitMap);
+
     extern const indices_t computeBitsPermutation(const indices_t &bitMap);
     extern const indices_t computeStatePermutation(const indices_t &bitPermutation);
     extern const indices_t inversePermutation(const indices_t s);
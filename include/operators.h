@@ -16,6 +16,9 @@ namespace qc
     typedef std::function<const Value *(const SourceContext &, const std::complex<double> &)> ComplexMapperFunction;
     typedef std::function<const Value *(const SourceContext &, const mx::Matrix &)> MatrixMapperFunction;
     typedef std::function<const Value *(const SourceContext &, const std::vector<Value *> &)> ListMapperFunction;
+    typedef std::function<const Value *(const SourceContext &, const mx::Circuit &)> CircuitMapperFunction;
+    typedef std::function<const Value *(const SourceContext &, const mx::State &)> StateMapperFunction;
+    typedef std::function<const Value *(const SourceContext &, const mx::PauliSum &)> PauliMapperFunction;
 
     typedef std::function<const Value *(const SourceContext &, const int, const int)> IntIntMapperFunction;
     typedef std::function<const Value *(const SourceContext &, const int, const std::complex<double> &)> IntComplexMapperFunction;
@@ -29,6 +32,17 @@ namespace qc
     typedef std::function<const Value *(const SourceContext &, const mx::Matrix &, const std::complex<double> &)> MatrixComplexMapperFunction;
     typedef std::function<const Value *(const SourceContext &, const mx::Matrix &, const mx::Matrix &)> MatrixMatrixMapperFunction;
 
+    typedef std::function<const Value *(const SourceContext &, const mx::Circuit &, const mx::Circuit &)> CircuitCircuitMapperFunction;
+    typedef std::function<const Value *(const SourceContext &, const mx::Circuit &, const mx::State &)> CircuitStateMapperFunction;
+    typedef std::function<const Value *(const SourceContext &, const mx::Circuit &, const mx::Matrix &)> CircuitMatrixMapperFunction;
+    typedef std::function<const Value *(const SourceContext &, const mx::Matrix &, const mx::State &)> MatrixStateMapperFunction;
+    typedef std::function<const Value *(const SourceContext &, const mx::State &, const mx::State &)> StateStateMapperFunction;
+    typedef std::function<const Value *(const SourceContext &, const mx::PauliSum &, const mx::PauliSum &)> PauliPauliMapperFunction;
+    typedef std::function<const Value *(const SourceContext &, const std::complex<double> &, const mx::PauliSum &)> ComplexPauliMapperFunction;
+    typedef std::function<const Value *(const SourceContext &, const mx::PauliSum &, const std::complex<double> &)> PauliComplexMapperFunction;
+    typedef std::function<const Value *(const SourceContext &, const mx::Circuit &, const mx::DensityMatrix &)> CircuitDensityMapperFunction;
+    typedef std::function<const Value *(const SourceContext &, const mx::Matrix &, const mx::DensityMatrix &)> MatrixDensityMapperFunction;
+
     class UnaryOperator
     {
     public:
@@ -49,6 +63,9 @@ namespace qc
         ChainUnaryOperator *mapInt(const IntMapperFunction &mapper) const;
         ChainUnaryOperator *mapComplex(const ComplexMapperFunction &mapper) const;
         ChainUnaryOperator *mapMatrix(const MatrixMapperFunction &mapper) const;
+        ChainUnaryOperator *mapCircuit(const CircuitMapperFunction &mapper) const;
+        ChainUnaryOperator *mapState(const StateMapperFunction &mapper) const;
+        ChainUnaryOperator *mapPauli(const PauliMapperFunction &mapper) const;
     };
 
     class UnaryErrorOperator : public ChainUnaryOperator
@@ -96,6 +113,39 @@ namespace qc
         virtual const Value *apply(const SourceContext &context, const Value &value) const override;
     };
 
+    class UnaryCircuitOperator : public ChainUnaryOperator
+    {
+        CircuitMapperFunction _mapper;
+
+    public:
+        UnaryCircuitOperator(const CircuitMapperFunction &mapper,
+                             const UnaryOperator *other) : ChainUnaryOperator(other), _mapper(mapper) {}
+
+        virtual const Value *apply(const SourceContext &context, const Value &value) const override;
+    };
+
+    class UnaryStateOperator : public ChainUnaryOperator
+    {
+        StateMapperFunction _mapper;
+
+    public:
+        UnaryStateOperator(const StateMapperFunction &mapper,
+                           const UnaryOperator *other) : ChainUnaryOperator(other), _mapper(mapper) {}
+
+        virtual const Value *apply(const SourceContext &context, const Value &value) const override;
+    };
+
+    class UnaryPauliOperator : public ChainUnaryOperator
+    {
+        PauliMapperFunction _mapper;
+
+    public:
+        UnaryPauliOperator(const PauliMapperFunction &mapper,
+                           const UnaryOperator *other) : ChainUnaryOperator(other), _mapper(mapper) {}
+
+        virtual const Value *apply(const SourceContext &context, const Value &value) const override;
+    };
+
     class BinaryOperator
     {
     public:
@@ -122,6 +172,16 @@ namespace qc
         ChainBinaryOperator *mapMatrixInt(const MatrixIntMapperFunction &mapper) const;
         ChainBinaryOperator *mapMatrixComplex(const MatrixComplexMapperFunction &mapper) const;
         ChainBinaryOperator *mapMatrixMatrix(const MatrixMatrixMapperFunction &mapper) const;
+        ChainBinaryOperator *mapCircuitCircuit(const CircuitCircuitMapperFunction &mapper) const;
+        ChainBinaryOperator *mapCircuitState(const CircuitStateMapperFunction &mapper) const;
+        ChainBinaryOperator *mapCircuitMatrix(const CircuitMatrixMapperFunction &mapper) const;
+        ChainBinaryOperator *mapMatrixState(const MatrixStateMapperFunction &mapper) const;
+        ChainBinaryOperator *mapStateState(const StateStateMapperFunction &mapper) const;
+        ChainBinaryOperator *mapPauliPauli(const PauliPauliMapperFunction &mapper) const;
+        ChainBinaryOperator *mapComplexPauli(const ComplexPauliMapperFunction &mapper) const;
+        ChainBinaryOperator *mapPauliComplex(const PauliComplexMapperFunction &mapper) const;
+        ChainBinaryOperator *mapCircuitDensity(const CircuitDensityMapperFunction &mapper) const;
+        ChainBinaryOperator *mapMatrixDensity(const MatrixDensityMapperFunction &mapper) const;
     };
 
     class BinaryErrorOperator : public ChainBinaryOperator
@@ -263,5 +323,130 @@ namespace qc
 
         virtual const Value *apply(const SourceContext &context, const Value &left, const Value &right) const override;
     };
+
+    /**
+     * Binary operator circuit, circuit
+     */
+    class CircuitCircuitOperator : public ChainBinaryOperator
+    {
+        CircuitCircuitMapperFunction _mapper;
+
+    public:
+        CircuitCircuitOperator(const CircuitCircuitMapperFunction &mapper, const BinaryOperator *other)
+            : ChainBinaryOperator(other), _mapper(mapper) {}
+
+        virtual const Value *apply(const SourceContext &context, const Value &left, const Value &right) const override;
+    };
+
+    /**
+     * Binary operator circuit, state
+     */
+    class CircuitStateOperator : public ChainBinaryOperator
+    {
+        CircuitStateMapperFunction _mapper;
+
+    public:
+        CircuitStateOperator(const CircuitStateMapperFunction &mapper, const BinaryOperator *other)
+            : ChainBinaryOperator(other), _mapper(mapper) {}
+
+        virtual const Value *apply(const SourceContext &context, const Value &left, const Value &right) const override;
+    };
+
+    /**
+     * Binary operator circuit, matrix
+     */
+    class CircuitMatrixOperator : public ChainBinaryOperator
+    {
+        CircuitMatrixMapperFunction _mapper;
+
+    public:
+        CircuitMatrixOperator(const CircuitMatrixMapperFunction &mapper, const BinaryOperator *other)
+            : ChainBinaryOperator(other), _mapper(mapper) {}
+
+        virtual const Value *apply(const SourceContext &context, const Value &left, const Value &right) const override;
+    };
+
+    class MatrixStateOperator : public ChainBinaryOperator
+    {
+        MatrixStateMapperFunction _mapper;
+
+    public:
+        MatrixStateOperator(const MatrixStateMapperFunction &mapper, const BinaryOperator *other)
+            : ChainBinaryOperator(other), _mapper(mapper) {}
+
+        virtual const Value *apply(const SourceContext &context, const Value &left, const Value &right) const override;
+    };
+
+    class StateStateOperator : public ChainBinaryOperator
+    {
+        StateStateMapperFunction _mapper;
+
+    public:
+        StateStateOperator(const StateStateMapperFunction &mapper, const BinaryOperator *other)
+            : ChainBinaryOperator(other), _mapper(mapper) {}
+
+        virtual const Value *apply(const SourceContext &context, const Value &left, const Value &right) const override;
+    };
+
+    class PauliPauliOperator : public ChainBinaryOperator
+    {
+        PauliPauliMapperFunction _mapper;
+
+    public:
+        PauliPauliOperator(const PauliPauliMapperFunction &mapper, const BinaryOperator *other)
+            : ChainBinaryOperator(other), _mapper(mapper) {}
+
+        virtual const Value *apply(const SourceContext &context, const Value &left, const Value &right) const override;
+    };
+
+    /**
+     * The operator of scalar (int or complex) and Pauli sum
+     */
+    class ComplexPauliOperator : public ChainBinaryOperator
+    {
+        ComplexPauliMapperFunction _mapper;
+
+    public:
+        ComplexPauliOperator(const ComplexPauliMapperFunction &mapper, const BinaryOperator *other)
+            : ChainBinaryOperator(other), _mapper(mapper) {}
+
+        virtual const Value *apply(const SourceContext &context, const Value &left, const Value &right) const override;
+    };
+
+    /**
+     * The operator of Pauli sum and scalar (int or complex)
+     */
+    class PauliComplexOperator : public ChainBinaryOperator
+    {
+        PauliComplexMapperFunction _mapper;
+
+    public:
+        PauliComplexOperator(const PauliComplexMapperFunction &mapper, const BinaryOperator *other)
+            : ChainBinaryOperator(other), _mapper(mapper) {}
+
+        virtual const Value *apply(const SourceContext &context, const Value &left, const Value &right) const override;
+    };
+
+    class CircuitDensityOperator : public ChainBinaryOperator
+    {
+        CircuitDensityMapperFunction _mapper;
+
+    public:
+        CircuitDensityOperator(const CircuitDensityMapperFunction &mapper, const BinaryOperator *other)
+            : ChainBinaryOperator(other), _mapper(mapper) {}
+
+        virtual const Value *apply(const SourceContext &context, const Value &left, const Value &right) const override;
+    };
+
+    class MatrixDensityOperator : public ChainBinaryOperator
+    {
+        MatrixDensityMapperFunction _mapper;
+
+    public:
+        MatrixDensityOperator(const MatrixDensityMapperFunction &mapper, const BinaryOperator *other)
+            : ChainBinaryOperator(other), _mapper(mapper) {}
+
+        virtual const Value *apply(const SourceContext &context, const Value &left, const Value &right) const override;
+    };
 }
 #endif
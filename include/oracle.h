@@ -0,0 +1,31 @@
+#ifndef _oracle_h_
+#define _oracle_h_
+
+#include <complex>
+#include <vector>
+
+#include "matrix.h"
+
+namespace mx
+{
+    /**
+     * Applies in place the phase oracle to the qubits of dense state vector
+     * |x> -> -|x> if the register value x of the qubits is marked else |x>
+     * by a single parallel sweep over the amplitudes
+     * @param cells the state vector cells
+     * @param size the number of cells (power of 2, at least 2^n)
+     * @param qubits the register qubits of the oracle from the least significant
+     * @param marked the sorted marked register values
+     * @param numThreads the number of threads (0 for hardware concurrency)
+     */
+    extern void phaseOracle(std::complex<double> *cells, const size_t size, const indices_t &qubits, const std::vector<uint64_t> &marked, const size_t numThreads = 0);
+
+    /**
+     * Returns the dense diagonal matrix of phase oracle
+     * @param numQubits the number of qubits
+     * @param marked the marked register values
+     */
+    extern const Matrix oracleMatrix(const size_t numQubits, const std::vector<uint64_t> &marked);
+}
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef _pauli_h_
+#define _pauli_h_
+
+#include <complex>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+#include "matrix.h"
+#include "state.h"
+
+namespace mx
+{
+    /**
+     * The maximum number of qubits of the Pauli strings
+     */
+    const size_t MAX_PAULI_QUBITS = 64;
+
+    /**
+     * The Pauli string i^phase P_x,z where P_x,z is the hermitian product of Pauli operators
+     * with X on the qubits of x mask, Z on the qubits of z mask and Y on the qubits of both masks
+     */
+    class PauliString
+    {
+        uint64_t _x;
+        uint64_t _z;
+        unsigned _phase;
+
+    public:
+        /**
+         * Creates the Pauli string
+         * @param x the X mask
+         * @param z the Z mask
+         * @param phase the power of i
+         */
+        PauliString(const uint64_t x = 0, const uint64_t z = 0, const unsigned phase = 0) : _x(x), _z(z), _phase(phase & 3) {}
+
+        /**
+         * Returns the X mask
+         */
+        const uint64_t x(void) const { return _x; }
+
+        /**
+         * Returns the Z mask
+         */
+        const uint64_t z(void) const { return _z; }
+
+        /**
+         * Returns the power of i
+         */
+        const unsigned phase(void) const { return _phase; }
+
+        /**
+         * Returns the mask of the non identity qubits
+         */
+        const uint64_t support(void) const { return _x | _z; }
+
+        /**
+         * Returns the number of qubits (at least 1)
+         */
+        const size_t numQubits(void) const;
+
+        /**
+         * Returns the product of this string and the right string
+         * @param right the right string
+         */
+        const PauliString operator*(const PauliString &right) const;
+
+        /**
+         * Returns true if the strings commute
+         * @param other the other string
+         */
+        const bool commutes(const PauliString &other) const;
+
+        /**
+         * Returns true if the strings have the same Pauli operator on each qubit of both supports
+         * @param other the other string
+         */
+        const bool qubitWiseCommutes(const PauliString &other) const;
+
+        /**
+         * Returns the dense matrix
+         * @param numQubits the number of qubits
+         */
+        const Matrix matrix(const size_t numQubits) const;
+    };
+
+    /**
+     * Returns the X operator string of qubit
+     * @param qubit the qubit
+     */
+    extern const PauliString pauliX(const size_t qubit);
+
+    /**
+     * Returns the Y operator string of qubit
+     * @param qubit the qubit
+     */
+    extern const PauliString pauliY(const size_t qubit);
+
+    /**
+     * Returns the Z operator string of qubit
+     * @param qubit the qubit
+     */
+    extern const PauliString pauliZ(const size_t qubit);
+
+    /**
+     * The linear combination of hermitian Pauli strings (phase folded in the coefficients)
+     * sorted by masks with distinct strings
+     */
+    class PauliSum
+    {
+        std::vector<std::pair<std::complex<double>, PauliString>> _terms;
+
+        PauliSum &simplify(void);
+
+    public:
+        /**
+         * Creates the sum of a single string
+         * @param string the string
+         * @param coefficient the coefficient
+         */
+        PauliSum(const PauliString &string, const std::complex<double> &coefficient = 1);
+
+        /**
+         * Creates the sum of terms
+         * @param terms the coefficient and string of each term
+         */
+        PauliSum(const std::vector<std::pair<std::complex<double>, PauliString>> &terms);
+
+        /**
+         * Returns the terms
+         */
+        const std::vector<std::pair<std::complex<double>, PauliString>> &terms(void) const { return _terms; }
+
+        /**
+         * Returns the number of qubits (at least 1)
+         */
+        const size_t numQubits(void) const;
+
+        const PauliSum operator+(const PauliSum &right) const;
+
+        const PauliSum operator-(const PauliSum &right) const;
+
+        const PauliSum operator-(void) const;
+
+        const PauliSum operator*(const PauliSum &right) const;
+
+        const PauliSum operator*(const std::complex<double> &right) const;
+
+        /**
+         * Returns the groups of qubit wise commuting terms (term indices)
+         */
+        const std::vector<std::vector<size_t>> groups(void) const;
+
+        /**
+         * Returns the expectation value on the dense state vector.
+         * Each group of qubit wise commuting terms is rotated to the computational basis
+         * and evaluated in one pass over the probabilities by parity of the term supports
+         * @param cells the state vector cells (2^n)
+         */
+        const std::complex<double> expectation(const vu::ComplexVect &cells) const;
+
+        /**
+         * Returns the expectation value on the state
+         * (grouped dense evaluation when the non zero amplitudes fill the state vector,
+         * term by term on the non zero amplitudes otherwise)
+         * @param state the state
+         */
+        const std::complex<double> expectation(const State &state) const;
+
+        /**
+         * Returns the sum applied to the dense state vector by a parallel gather of the terms for each amplitude
+         * (the strings with X or Y out of the register map to zero)
+         * @param cells the state vector cells (2^n)
+         * @param numThreads the number of threads (0 for hardware concurrency)
+         */
+        const vu::ComplexVect apply(const vu::ComplexVect &cells, const size_t numThreads = 0) const;
+
+        /**
+         * Returns the dense matrix
+         */
+        const Matrix matrix(void) const;
+    };
+}
+
+extern std::ostream &operator<<(std::ostream &stream, const mx::PauliSum &sum);
+extern const std::string to_string(const mx::PauliSum &sum);
+
+#endif
@@ -4,6 +4,7 @@
 #include <string>
 #include <map>
 #include <functional>
+#include <random>
 
 #include "values.h"
 #include "processContext.h"
@@ -12,14 +13,39 @@ namespace qc
 {
     typedef std::function<const Value *(const SourceContext &, const ListValue &)> FunctionMapper;
 
+    /**
+     * The mapper of the functions drawing from the random generator of the processor
+     */
+    typedef std::function<const Value *(const SourceContext &, const ListValue &, std::mt19937_64 &)> RandomFunctionMapper;
+
     class FunctionDef
     {
         std::string _id;
         int _numArgs;
         const FunctionMapper _mapper;
+        const RandomFunctionMapper _randomMapper;
+        bool _variadic;
 
     public:
-        FunctionDef(const std::string &id, const int numArgs, const FunctionMapper mapper) : _id(id), _numArgs(numArgs), _mapper(mapper) {}
+        /**
+         * Creates the function definition
+         * @param id the function identifier
+         * @param numArgs the number of arguments (the minimum number if variadic)
+         * @param mapper the function mapper
+         * @param variadic true if the function accepts more arguments
+         */
+        FunctionDef(const std::string &id, const int numArgs, const FunctionMapper mapper, const bool variadic = false)
+            : _id(id), _numArgs(numArgs), _mapper(mapper), _variadic(variadic) {}
+
+        /**
+         * Creates the definition of the function drawing from the random generator of the processor
+         * @param id the function identifier
+         * @param numArgs the number of arguments (the minimum number if variadic)
+         * @param randomMapper the function mapper
+         * @param variadic true if the function accepts more arguments
+         */
+        FunctionDef(const std::string &id, const int numArgs, const RandomFunctionMapper randomMapper, const bool variadic = false)
+            : _id(id), _numArgs(numArgs), _randomMapper(randomMapper), _variadic(variadic) {}
 
         const std::string &id(void) const
         {
@@ -31,13 +57,24 @@ namespace qc
         }
 
         const FunctionMapper &mapper(void) const { return _mapper; }
+
+        const RandomFunctionMapper &randomMapper(void) const { return _randomMapper; }
+
+        const bool variadic(void) const { return _variadic; }
     };
 
     class Processor : public ProcessContext
     {
         std::map<std::string, const Value *> _variables;
+        std::mt19937_64 _random;
 
     public:
+        /**
+         * Creates the processor
+         * @param seed the seed of the random generator of the measures and of the sampling seeds
+         */
+        Processor(const uint64_t seed = 1234) : _random(seed) {}
+
         ~Processor();
         
         const std::map<std::string, const Value *> &variables(void) { return _variables; }
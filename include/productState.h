@@ -0,0 +1,84 @@
+#ifndef _productState_h_
+#define _productState_h_
+
+#include <complex>
+#include <vector>
+#include <cstdint>
+
+#include "matrix.h"
+#include "circuit.h"
+#include "state.h"
+
+namespace mx
+{
+    /**
+     * The state stored as the tensor product of independent sub register clusters.
+     * The qubits out of any cluster are |0>. A gate updates only the clusters of its qubits,
+     * merged by Kronecker product when the gate spans many clusters
+     */
+    class ProductState : public State
+    {
+        struct Cluster
+        {
+            indices_t qubits;
+            vu::ComplexVect cells;
+        };
+
+        size_t _numQubits;
+        std::vector<Cluster> _clusters;
+
+        ProductState(const size_t numQubits, const std::vector<Cluster> &clusters) : _numQubits(numQubits), _clusters(clusters) {}
+
+        const size_t merge(const indices_t &qubits);
+        const std::vector<std::pair<uint64_t, std::complex<double>>> productAmplitudes(void) const;
+
+    public:
+        /**
+         * Creates the state from a dense ket split in the factorizable qubits
+         * @param ket the ket
+         */
+        ProductState(const Matrix &ket);
+
+        /**
+         * Returns the number of clusters
+         */
+        const size_t numClusters(void) const { return _clusters.size(); }
+
+        /**
+         * Returns the number of qubits of the largest cluster
+         */
+        const size_t maxClusterQubits(void) const;
+
+        /**
+         * Returns the state of this (high qubits) and the right state (low qubits)
+         * @param right the right state
+         */
+        const ProductState cross(const ProductState &right) const;
+
+        /**
+         * Applies the gate
+         * @param gate the gate
+         */
+        ProductState &apply(const Gate &gate);
+
+        /**
+         * Applies the circuit
+         * @param circuit the circuit
+         */
+        ProductState &apply(const Circuit &circuit);
+
+        virtual const size_t numQubits(void) const override { return _numQubits; }
+
+        virtual const std::complex<double> at(const uint64_t index) const override;
+
+        virtual const std::vector<std::pair<uint64_t, std::complex<double>>> amplitudes(void) const override;
+
+        virtual void forEach(const std::function<void(const uint64_t, const std::complex<double> &)> &f) const override;
+
+        virtual const StatePtr transform(const Circuit &circuit) const override;
+
+        virtual const StatePtr project(const size_t qubit, const int outcome, const double probability) const override;
+    };
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef _reversible_h_
+#define _reversible_h_
+
+#include <complex>
+#include <vector>
+
+#include "matrix.h"
+
+namespace mx
+{
+    /**
+     * The elementary reversible operation on the basis state index:
+     * toggles the flips bits if all the controls bits are set
+     */
+    struct ReversibleOp
+    {
+        uint64_t controls;
+        uint64_t flips;
+    };
+
+    /**
+     * Returns the basis state index mapped by the reversible network
+     * @param index the basis state index
+     * @param ops the operations in application order
+     */
+    inline const uint64_t applyReversible(uint64_t index, const std::vector<ReversibleOp> &ops)
+    {
+        for (const ReversibleOp &op : ops)
+        {
+            // Branchless toggle: the mask is all ones only if the controls are set
+            index ^= op.flips & (0 - (uint64_t)((index & op.controls) == op.controls));
+        }
+        return index;
+    }
+
+    /**
+     * Applies in place the reversible network to dense state vector
+     * |x> -> |f(x)> by a single parallel gather of the amplitudes at f^-1(x)
+     * @param cells the state vector cells
+     * @param size the number of cells (power of 2, at least 2^n)
+     * @param ops the operations in application order on the register bits
+     * @param numThreads the number of threads (0 for hardware concurrency)
+     */
+    extern void reversible(std::complex<double> *cells, const size_t size, const std::vector<ReversibleOp> &ops, const size_t numThreads = 0);
+
+    /**
+     * Returns the dense permutation matrix of reversible network
+     * @param numQubits the number of qubits
+     * @param ops the operations in application order
+     */
+    extern const Matrix reversibleMatrix(const size_t numQubits, const std::vector<ReversibleOp> &ops);
+}
+
+#endif
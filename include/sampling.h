@@ -0,0 +1,113 @@
+#ifndef _sampling_h_
+#define _sampling_h_
+
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include "state.h"
+
+namespace mx
+{
+    /**
+     * The Walker alias table drawing the outcomes of a discrete distribution in constant time
+     */
+    class AliasTable
+    {
+        std::vector<double> _thresholds;
+        std::vector<size_t> _aliases;
+
+    public:
+        /**
+         * Creates the table (Vose's method)
+         * @param weights the non negative weights of outcomes
+         */
+        AliasTable(const std::vector<double> &weights);
+
+        /**
+         * Returns the number of outcomes
+         */
+        const size_t size(void) const { return _thresholds.size(); }
+
+        /**
+         * Returns a random outcome
+         * @param random the random generator
+         */
+        const size_t sample(std::mt19937_64 &random) const;
+    };
+
+    /**
+     * The measurement shot sampler of a state in the computational basis.
+     * The alias table of the probabilities is built once and the shots are drawn in parallel
+     * by blocks, each with its own deterministic random stream
+     */
+    class Sampler
+    {
+        std::vector<uint64_t> _states;
+        AliasTable _table;
+
+        Sampler(const std::vector<std::pair<uint64_t, std::complex<double>>> &amplitudes, const size_t numThreads);
+
+    public:
+        /**
+         * Creates the sampler
+         * @param state the state
+         * @param numThreads the number of threads (0 for hardware concurrency)
+         */
+        Sampler(const State &state, const size_t numThreads = 0);
+
+        /**
+         * Creates the sampler of the dense state vector, the outcomes are the cell indices
+         * @param cells the state vector cells
+         * @param numThreads the number of threads (0 for hardware concurrency)
+         */
+        Sampler(const vu::ComplexVect &cells, const size_t numThreads = 0);
+
+        /**
+         * Returns the counts of the measured basis states sorted by basis state
+         * @param shots the number of shots
+         * @param seed the random seed
+         * @param numThreads the number of threads (0 for hardware concurrency)
+         */
+        const std::vector<std::pair<uint64_t, size_t>> sample(const size_t shots, const uint64_t seed = 1234, const size_t numThreads = 0) const;
+    };
+
+    /**
+     * Measures the qubit of the dense state vector collapsing it in place and returns the outcome.
+     * The amplitudes incompatible with the outcome are zeroed and the others rescaled in the same pass
+     * @param cells the state vector cells
+     * @param qubit the qubit
+     * @param random the random generator
+     */
+    extern const int collapse(vu::ComplexVect &cells, const size_t qubit, std::mt19937_64 &random);
+
+    /**
+     * Returns the outcome of the qubit measure and the collapsed state.
+     * The outcome probabilities are summed in one unsorted visit and the state is projected by its backend
+     * @param state the state
+     * @param qubit the qubit
+     * @param random the random generator
+     */
+    extern const std::pair<int, StatePtr> measure(const State &state, const size_t qubit, std::mt19937_64 &random);
+
+    /**
+     * Returns the k most probable basis states with amplitudes sorted by decreasing probability
+     * (ties by increasing basis state).
+     * The amplitudes are visited once in storage order keeping a bounded heap
+     * @param state the state
+     * @param k the number of basis states
+     */
+    extern const std::vector<std::pair<uint64_t, std::complex<double>>> topK(const State &state, const size_t k);
+
+    /**
+     * Returns the k most probable basis states of the dense state vector with amplitudes sorted by
+     * decreasing probability (ties by increasing basis state).
+     * The cells are scanned once by parallel ranges each keeping a bounded heap
+     * @param cells the state vector cells
+     * @param k the number of basis states
+     * @param numThreads the number of threads (0 for hardware concurrency)
+     */
+    extern const std::vector<std::pair<uint64_t, std::complex<double>>> topK(const vu::ComplexVect &cells, const size_t k, const size_t numThreads = 0);
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef _shardedState_h_
+#define _shardedState_h_
+
+#include <complex>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "matrix.h"
+#include "circuit.h"
+#include "state.h"
+#include "transport.h"
+
+namespace mx
+{
+    /**
+     * The state vector split among the workers by the high order qubits (global qubits).
+     * Each worker stores the shard of the amplitudes with the global qubits equal to its rank.
+     * Gates on local qubits run on the shard, gates on global qubits swap the global qubits
+     * with free local qubits by pairwise amplitude exchange, run locally and swap back.
+     * All the workers must perform the same operations in the same order
+     */
+    class ShardedState : public State
+    {
+        std::shared_ptr<Transport> _transport;
+        size_t _numQubits;
+        size_t _numGlobal;
+        vu::ComplexVect _shard;
+
+        struct Entry
+        {
+            uint64_t index;
+            double re;
+            double im;
+        };
+
+        void resize(const size_t numQubits);
+        void swapGlobal(const size_t global, const size_t local);
+        const std::vector<Entry> allToAll(const std::vector<std::vector<Entry>> &entries) const;
+        const std::vector<std::pair<uint64_t, std::complex<double>>> gather(void) const;
+
+    public:
+        /**
+         * Creates the state from a dense ket (the same ket on each worker)
+         * @param transport the transport (number of workers power of 2)
+         * @param ket the ket
+         */
+        ShardedState(const std::shared_ptr<Transport> &transport, const Matrix &ket);
+
+        /**
+         * Returns the number of local qubits
+         */
+        const size_t numLocal(void) const { return _numQubits - _numGlobal; }
+
+        /**
+         * Returns the number of global qubits
+         */
+        const size_t numGlobal(void) const { return _numGlobal; }
+
+        /**
+         * Returns the shard of this worker
+         */
+        const vu::ComplexVect &shard(void) const { return _shard; }
+
+        /**
+         * Applies the gate
+         * @param gate the gate
+         */
+        ShardedState &apply(const Gate &gate);
+
+        /**
+         * Applies the circuit
+         * @param circuit the circuit
+         */
+        ShardedState &apply(const Circuit &circuit);
+
+        virtual const size_t numQubits(void) const override { return _numQubits; }
+
+        /**
+         * Returns the amplitude of a basis state broadcast by the owner worker
+         * @param index the basis state index
+         */
+        virtual const std::complex<double> at(const uint64_t index) const override;
+
+        /**
+         * Returns the non zero amplitudes gathered from all the workers
+         */
+        virtual const std::vector<std::pair<uint64_t, std::complex<double>>> amplitudes(void) const override;
+
+        virtual void forEach(const std::function<void(const uint64_t, const std::complex<double> &)> &f) const override;
+
+        virtual const StatePtr transform(const Circuit &circuit) const override;
+
+        virtual const StatePtr project(const size_t qubit, const int outcome, const double probability) const override;
+    };
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef _sparseState_h_
+#define _sparseState_h_
+
+#include <complex>
+#include <vector>
+#include <cstdint>
+
+#include "matrix.h"
+#include "circuit.h"
+#include "state.h"
+
+namespace mx
+{
+    /**
+     * The state vector storing only the non zero amplitudes in an open addressing hash table
+     */
+    class SparseState : public State
+    {
+        /**
+         * The hash table slot, removed marks the slot of a cancelled amplitude (tombstone)
+         */
+        struct Entry
+        {
+            uint64_t key;
+            std::complex<double> value;
+            bool used;
+            bool removed;
+        };
+
+        size_t _numQubits;
+        size_t _size;
+        size_t _numRemoved;
+        std::vector<Entry> _entries;
+
+        const size_t find(const uint64_t index) const;
+        void rehash(const size_t capacity);
+
+    public:
+        /**
+         * The norm below which the amplitudes are dropped
+         */
+        static constexpr double TOLERANCE = 1e-24;
+
+        /**
+         * Creates the zero state
+         * @param numQubits the number of qubits
+         */
+        SparseState(const size_t numQubits);
+
+        /**
+         * Creates the state from a dense ket
+         * @param ket the ket
+         */
+        SparseState(const Matrix &ket);
+
+        /**
+         * Returns the number of qubits
+         */
+        virtual const size_t numQubits(void) const override { return _numQubits; }
+
+        /**
+         * Returns the number of non zero amplitudes
+         */
+        const size_t size(void) const { return _size; }
+
+        /**
+         * Returns the amplitude of a basis state
+         * @param index the basis state index
+         */
+        virtual const std::complex<double> at(const uint64_t index) const override;
+
+        /**
+         * Adds the amplitude to a basis state
+         * @param index the basis state index
+         * @param value the amplitude
+         */
+        SparseState &add(const uint64_t index, const std::complex<double> &value);
+
+        /**
+         * Applies the gate.
+         * Permutation gates remap the basis states, other gates split the amplitudes
+         * among the basis states of the gate qubits
+         *
+         * @param gate the gate
+         */
+        SparseState &apply(const Gate &gate);
+
+        /**
+         * Applies the circuit
+         * @param circuit the circuit
+         */
+        SparseState &apply(const Circuit &circuit);
+
+        virtual const std::vector<std::pair<uint64_t, std::complex<double>>> amplitudes(void) const override;
+
+        virtual void forEach(const std::function<void(const uint64_t, const std::complex<double> &)> &f) const override;
+
+        virtual const StatePtr transform(const Circuit &circuit) const override;
+
+        virtual const StatePtr project(const size_t qubit, const int outcome, const double probability) const override;
+    };
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef _state_h_
+#define _state_h_
+
+#include <complex>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <ostream>
+#include <functional>
+
+#include "matrix.h"
+#include "circuit.h"
+
+namespace mx
+{
+    class State;
+
+    typedef std::shared_ptr<const State> StatePtr;
+
+    /**
+     * The quantum state stored by a simulation backend
+     */
+    class State
+    {
+    public:
+        virtual ~State() {}
+
+        /**
+         * Returns the number of qubits
+         */
+        virtual const size_t numQubits(void) const = 0;
+
+        /**
+         * Returns the amplitude of a basis state
+         * @param index the basis state index
+         */
+        virtual const std::complex<double> at(const uint64_t index) const = 0;
+
+        /**
+         * Returns the non zero amplitudes sorted by basis state
+         */
+        virtual const std::vector<std::pair<uint64_t, std::complex<double>>> amplitudes(void) const = 0;
+
+        /**
+         * Calls the function on each non zero amplitude in storage order (not sorted)
+         * @param f the function of basis state index and amplitude
+         */
+        virtual void forEach(const std::function<void(const uint64_t, const std::complex<double> &)> &f) const;
+
+        /**
+         * Returns the state resulting by applying the circuit
+         * @param circuit the circuit
+         */
+        virtual const StatePtr transform(const Circuit &circuit) const = 0;
+
+        /**
+         * Returns the state projected on the qubit outcome: the amplitudes of the other outcome are zeroed
+         * and the remaining ones rescaled to unit norm
+         * @param qubit the qubit (< MAX_QUBITS)
+         * @param outcome the outcome (0 or 1)
+         * @param probability the probability of the outcome
+         */
+        virtual const StatePtr project(const size_t qubit, const int outcome, const double probability) const;
+
+        /**
+         * Returns the dense ket
+         */
+        virtual const Matrix ket(void) const;
+    };
+
+    /**
+     * Returns the circuit applying a square matrix to the lowest qubits
+     * @param matrix the matrix (2^k x 2^k)
+     */
+    extern const Circuit matrixCircuit(const Matrix &matrix);
+}
+
+extern std::ostream &operator<<(std::ostream &stream, const mx::State &state);
+extern const std::string to_string(const mx::State &state);
+
+#endif
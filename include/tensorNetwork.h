@@ -0,0 +1,157 @@
+#ifndef _tensorNetwork_h_
+#define _tensorNetwork_h_
+
+#include <complex>
+#include <vector>
+#include <cstdint>
+
+#include "matrix.h"
+#include "circuit.h"
+
+namespace mx
+{
+    /**
+     * The tensor with binary indices.
+     * The index labels are shared by the two tensors connected by the same wire,
+     * the i-th index is the i-th bit of the cell offset
+     */
+    class Tensor
+    {
+        std::vector<uint32_t> _indices;
+        vu::ComplexVect _cells;
+
+    public:
+        /**
+         * Creates the tensor
+         * @param indices the index labels
+         * @param cells the cells (2^rank)
+         */
+        Tensor(const std::vector<uint32_t> &indices, const vu::ComplexVect &cells);
+
+        /**
+         * Returns the index labels
+         */
+        const std::vector<uint32_t> &indices(void) const { return _indices; }
+
+        /**
+         * Returns the cells
+         */
+        const vu::ComplexVect &cells(void) const { return _cells; }
+
+        /**
+         * Returns the number of indices
+         */
+        const size_t rank(void) const { return _indices.size(); }
+
+        /**
+         * Returns the tensor contracting the shared indices.
+         * The tensors are reshaped into matrices and multiplied by the blocked GEMM
+         * @param other the other tensor
+         */
+        const Tensor contract(const Tensor &other) const;
+    };
+
+    /**
+     * The contraction order of a tensor network.
+     * The tensors are numbered by creation, the i-th step creates the tensor (numTensors + i)
+     */
+    class ContractionPath
+    {
+        std::vector<std::pair<size_t, size_t>> _steps;
+        double _flops;
+        double _peakSize;
+
+    public:
+        /**
+         * Creates the path
+         * @param steps the pairs of contracted tensors
+         * @param flops the number of multiply-add operations
+         * @param peakSize the number of cells of the largest tensor
+         */
+        ContractionPath(const std::vector<std::pair<size_t, size_t>> &steps, const double flops, const double peakSize)
+            : _steps(steps), _flops(flops), _peakSize(peakSize) {}
+
+        /**
+         * Returns the pairs of contracted tensors
+         */
+        const std::vector<std::pair<size_t, size_t>> &steps(void) const { return _steps; }
+
+        /**
+         * Returns the number of multiply-add operations
+         */
+        const double flops(void) const { return _flops; }
+
+        /**
+         * Returns the number of cells of the largest tensor
+         */
+        const double peakSize(void) const { return _peakSize; }
+
+        /**
+         * Returns true if the path is cheaper than the other (flops then peak memory)
+         * @param other the other path
+         */
+        const bool operator<(const ContractionPath &other) const
+        {
+            return _flops < other._flops || (_flops == other._flops && _peakSize < other._peakSize);
+        }
+    };
+
+    /**
+     * The network of tensors connected by the shared index labels
+     */
+    class TensorNetwork
+    {
+        std::vector<Tensor> _tensors;
+
+        const ContractionPath search(const double temperature, const uint64_t seed) const;
+
+    public:
+        /**
+         * Creates the network
+         * @param tensors the tensors
+         */
+        TensorNetwork(const std::vector<Tensor> &tensors) : _tensors(tensors) {}
+
+        /**
+         * Returns the network of the amplitude <out| circuit |in>
+         * @param circuit the circuit
+         * @param out the output basis state
+         * @param in the input basis state
+         */
+        static const TensorNetwork amplitude(const Circuit &circuit, const uint64_t out, const uint64_t in);
+
+        /**
+         * Returns the tensors
+         */
+        const std::vector<Tensor> &tensors(void) const { return _tensors; }
+
+        /**
+         * Returns the greedy path contracting the pair with the least growth of size at each step
+         */
+        const ContractionPath greedyPath(void) const;
+
+        /**
+         * Returns the cheapest path among the greedy path and the randomized greedy paths.
+         * The randomized paths choose the pairs with Boltzmann probability of the size growth
+         * @param trials the number of randomized paths
+         * @param seed the random seed
+         */
+        const ContractionPath optimizePath(const size_t trials = 32, const uint64_t seed = 1234) const;
+
+        /**
+         * Returns the scalar value of the network
+         * @param path the contraction path
+         */
+        const std::complex<double> contract(const ContractionPath &path) const;
+    };
+
+    /**
+     * Returns the amplitude <out| circuit |in> by contracting the circuit tensor network
+     * @param circuit the circuit
+     * @param out the output basis state
+     * @param in the input basis state
+     */
+    extern const std::complex<double> tensorAmplitude(const Circuit &circuit, const uint64_t out, const uint64_t in);
+}
+
+#endif
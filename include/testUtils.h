@@ -0,0 +1,43 @@
+#ifndef _testUtils_h_
+#define _testUtils_h_
+
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include "vectutils.h"
+#include "matrix.h"
+
+namespace tu
+{
+    /**
+     * Returns the test state vector of distinct non normalised amplitudes
+     * @param numQubits the number of qubits
+     */
+    inline const vu::ComplexVect testCells(const size_t numQubits)
+    {
+        vu::ComplexVect cells;
+        for (size_t i = 0; i < (1ULL << numQubits); i++)
+        {
+            cells.push_back(std::complex<double>(std::cos(i * 0.7), std::sin(i * 1.3)));
+        }
+        return cells;
+    }
+
+    /**
+     * Expects the matrices equal within tolerance
+     * @param exp the expected matrix
+     * @param act the actual matrix
+     */
+    inline void expectNear(const mx::Matrix &exp, const mx::Matrix &act)
+    {
+        ASSERT_EQ(exp.numRows(), act.numRows());
+        ASSERT_EQ(exp.numCols(), act.numCols());
+        for (size_t i = 0; i < exp.cells().size(); i++)
+        {
+            EXPECT_NEAR(exp.cells()[i].real(), act.cells()[i].real(), 1e-12) << i;
+            EXPECT_NEAR(exp.cells()[i].imag(), act.cells()[i].imag(), 1e-12) << i;
+        }
+    }
+}
+
+#endif
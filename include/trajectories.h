@@ -0,0 +1,94 @@
+#ifndef _trajectories_h_
+#define _trajectories_h_
+
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include "matrix.h"
+#include "circuit.h"
+
+namespace mx
+{
+    /**
+     * The noise channels applied to each gate qubit after each gate
+     */
+    struct NoiseModel
+    {
+        /**
+         * The depolarizing probability
+         */
+        double depolarizing;
+
+        /**
+         * The amplitude damping probability
+         */
+        double damping;
+
+        /**
+         * The dephasing probability
+         */
+        double dephasing;
+    };
+
+    /**
+     * The averaged observables of the trajectories
+     */
+    struct TrajectoryResult
+    {
+        /**
+         * The number of trajectories
+         */
+        size_t numTrajectories;
+
+        /**
+         * The average probability of each qubit in state |1>
+         */
+        std::vector<double> probabilities;
+
+        /**
+         * The standard error of each average probability
+         */
+        std::vector<double> errors;
+    };
+
+    /**
+     * The Monte-Carlo trajectory simulator of noisy circuits.
+     * Each trajectory runs a pure state vector with errors sampled from the noise channels,
+     * the trajectories run in parallel each with its own deterministic random stream
+     */
+    class TrajectorySimulator
+    {
+        Circuit _circuit;
+        uint64_t _in;
+        NoiseModel _noise;
+        size_t _numQubits;
+
+        void applyNoise(vu::ComplexVect &state, const size_t qubit, std::mt19937_64 &random) const;
+        const std::vector<double> trajectory(const uint64_t seed) const;
+
+    public:
+        /**
+         * Creates the simulator
+         * @param circuit the circuit
+         * @param in the input basis state
+         * @param noise the noise model
+         */
+        TrajectorySimulator(const Circuit &circuit, const uint64_t in, const NoiseModel &noise);
+
+        /**
+         * Returns the number of qubits
+         */
+        const size_t numQubits(void) const { return _numQubits; }
+
+        /**
+         * Returns the averaged qubit probabilities of the trajectories
+         * @param numTrajectories the number of trajectories
+         * @param seed the random seed
+         * @param numThreads the number of threads (0 for hardware concurrency)
+         */
+        const TrajectoryResult run(const size_t numTrajectories, const uint64_t seed = 1234, const size_t numThreads = 0) const;
+    };
+}
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef _transport_h_
+#define _transport_h_
+
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace mx
+{
+    /**
+     * The point to point byte transport among the worker processes (ranks)
+     */
+    class Transport
+    {
+    public:
+        virtual ~Transport() {}
+
+        /**
+         * Returns the rank of this worker
+         */
+        virtual const size_t rank(void) const = 0;
+
+        /**
+         * Returns the number of workers
+         */
+        virtual const size_t size(void) const = 0;
+
+        /**
+         * Sends the data to the peer (blocking)
+         * @param peer the peer rank
+         * @param data the data
+         * @param numBytes the number of bytes
+         */
+        virtual void send(const size_t peer, const void *data, const size_t numBytes) = 0;
+
+        /**
+         * Receives the data from the peer (blocking)
+         * @param peer the peer rank
+         * @param data the data buffer
+         * @param numBytes the number of bytes
+         */
+        virtual void recv(const size_t peer, void *data, const size_t numBytes) = 0;
+
+        /**
+         * Exchanges the data with the peer.
+         * The lower rank sends first to avoid the deadlock of the blocking calls
+         * @param peer the peer rank
+         * @param sendData the sent data
+         * @param recvData the received data buffer
+         * @param numBytes the number of bytes
+         */
+        void exchange(const size_t peer, const void *sendData, void *recvData, const size_t numBytes);
+    };
+
+    /**
+     * The transport of the single worker
+     */
+    class LocalTransport : public Transport
+    {
+    public:
+        virtual const size_t rank(void) const override { return 0; }
+
+        virtual const size_t size(void) const override { return 1; }
+
+        virtual void send(const size_t peer, const void *data, const size_t numBytes) override;
+
+        virtual void recv(const size_t peer, void *data, const size_t numBytes) override;
+    };
+
+    /**
+     * The transport over connected stream sockets, one for each peer
+     * (Unix socket pairs for single node workers, TCP connections for multi node workers)
+     */
+    class SocketTransport : public Transport
+    {
+        size_t _rank;
+        std::vector<int> _sockets;
+
+    public:
+        /**
+         * Creates the transport
+         * @param rank the rank of this worker
+         * @param sockets the socket connected to each peer (ignored for this rank)
+         */
+        SocketTransport(const size_t rank, const std::vector<int> &sockets) : _rank(rank), _sockets(sockets) {}
+
+        ~SocketTransport();
+
+        /**
+         * Returns the full mesh of Unix socket pairs, mesh[i][j] is the socket of rank i connected to rank j
+         * @param size the number of workers
+         */
+        static const std::vector<std::vector<int>> mesh(const size_t size);
+
+        /**
+         * Returns the transport of rank connected by TCP to the other ranks.
+         * Each rank listens on port + rank, connects to the lower ranks and accepts the higher ranks
+         * @param rank the rank of this worker
+         * @param hosts the host of each rank
+         * @param port the base port
+         */
+        static const std::shared_ptr<SocketTransport> tcp(const size_t rank, const std::vector<std::string> &hosts, const int port);
+
+        virtual const size_t rank(void) const override { return _rank; }
+
+        virtual const size_t size(void) const override { return _sockets.size(); }
+
+        virtual void send(const size_t peer, const void *data, const size_t numBytes) override;
+
+        virtual void recv(const size_t peer, void *data, const size_t numBytes) override;
+    };
+
+    /**
+     * Returns the transport of the process (local transport if not set)
+     */
+    extern const std::shared_ptr<Transport> &defaultTransport(void);
+
+    /**
+     * Sets the transport of the process
+     * @param transport the transport
+     */
+    extern void setDefaultTransport(const std::shared_ptr<Transport> &transport);
+}
+
+#endif
@@ -8,6 +8,10 @@
 
 #include "sourceContext.h"
 #include "matrix.h"
+#include "circuit.h"
+#include "state.h"
+#include "densityMatrix.h"
+#include "pauli.h"
 
 namespace qc
 {
@@ -16,7 +20,11 @@ namespace qc
         intValueType,
         complexValueType,
         matrixValueType,
-        listValueType
+        listValueType,
+        circuitValueType,
+        stateValueType,
+        densityValueType,
+        pauliValueType
     };
 
     class Value
@@ -92,6 +100,80 @@ namespace qc
         virtual std::ostream &write(std::ostream &stream) const override { return stream << _value; }
     };
 
+    class CircuitValue : public Value
+    {
+        mx::Circuit _value;
+
+    public:
+        CircuitValue(const SourceContext &source, const mx::Circuit &value) : Value(source), _value(value) {}
+
+        virtual const ValueType type(void) const override { return ValueType::circuitValueType; };
+
+        const mx::Circuit &value(void) const { return _value; }
+
+        virtual const Value *clone(void) const override { return new CircuitValue(*this); }
+
+        virtual const Value *source(const SourceContext &source) const override { return new CircuitValue(source, _value); };
+
+        virtual std::ostream &write(std::ostream &stream) const override { return stream << _value; }
+    };
+
+    class StateValue : public Value
+    {
+        mx::StatePtr _value;
+
+    public:
+        StateValue(const SourceContext &source, const mx::StatePtr &value) : Value(source), _value(value) {}
+
+        virtual const ValueType type(void) const override { return ValueType::stateValueType; };
+
+        const mx::State &value(void) const { return *_value; }
+
+        const mx::StatePtr &state(void) const { return _value; }
+
+        virtual const Value *clone(void) const override { return new StateValue(*this); }
+
+        virtual const Value *source(const SourceContext &source) const override { return new StateValue(source, _value); };
+
+        virtual std::ostream &write(std::ostream &stream) const override { return stream << *_value; }
+    };
+
+    class DensityValue : public Value
+    {
+        std::shared_ptr<const mx::DensityMatrix> _value;
+
+    public:
+        DensityValue(const SourceContext &source, const std::shared_ptr<const mx::DensityMatrix> &value) : Value(source), _value(value) {}
+
+        virtual const ValueType type(void) const override { return ValueType::densityValueType; };
+
+        const mx::DensityMatrix &value(void) const { return *_value; }
+
+        virtual const Value *clone(void) const override { return new DensityValue(*this); }
+
+        virtual const Value *source(const SourceContext &source) const override { return new DensityValue(source, _value); };
+
+        virtual std::ostream &write(std::ostream &stream) const override { return stream << _value->matrix(); }
+    };
+
+    class PauliValue : public Value
+    {
+        std::shared_ptr<const mx::PauliSum> _value;
+
+    public:
+        PauliValue(const SourceContext &source, const std::shared_ptr<const mx::PauliSum> &value) : Value(source), _value(value) {}
+
+        virtual const ValueType type(void) const override { return ValueType::pauliValueType; };
+
+        const mx::PauliSum &value(void) const { return *_value; }
+
+        virtual const Value *clone(void) const override { return new PauliValue(*this); }
+
+        virtual const Value *source(const SourceContext &source) const override { return new PauliValue(source, _value); };
+
+        virtual std::ostream &write(std::ostream &stream) const override { return stream << *_value; }
+    };
+
     class ListValue : public Value
     {
         std::vector<const Value *> _values;
@@ -111,6 +193,18 @@ namespace qc
         virtual const Value *source(const SourceContext &source) const override { return new ListValue(source, _values); };
     };
 
+
+    /**
+     * Returns true if the value is convertible to matrix (matrix, circuit, state, density or pauli)
+     * @param value the value
+     */
+    extern const bool isMatrix(const Value &value);
+
+    /**
+     * Returns the dense matrix of a value convertible to matrix
+     * @param value the value
+     */
+    extern const mx::Matrix matrixOf(const Value &value);
 }
 
 extern std::ostream &operator<<(std::ostream &stream, const qc::Value &value);
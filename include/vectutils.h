@@ -3,6 +3,9 @@
 
 #include <vector>
 #include <complex>
+#include <cstdint>
+#include <thread>
+#include <algorithm>
 
 namespace vu
 {
@@ -35,5 +38,96 @@ namespace vu
     extern ComplexVect &partMul(ComplexVect &d, const size_t dOffset, const size_t numRow, const size_t numCols,
                                 const ComplexVect &a, const size_t aOffset, const size_t aStride,
                                 const ComplexVect &b, const size_t bOffset, const size_t bStride);
+
+    /**
+     * Cache blocked matrix multiplication d = a b
+     *
+     * @param d        the destination matrix (numRows x numCols)
+     * @param a        the left source matrix (numRows x numInner)
+     * @param b        the right source matrix (numInner x numCols)
+     * @param numRows  the number of rows
+     * @param numInner the number of columns of left matrix
+     * @param numCols  the number of columns
+     */
+    extern ComplexVect &blockMul(ComplexVect &d, const ComplexVect &a, const ComplexVect &b,
+                                 const size_t numRows, const size_t numInner, const size_t numCols);
+
+    /**
+     * Returns the 2-norm of the vector by compensated summation (parallel blocks for large vectors)
+     *
+     * @param a the vector
+     */
+    extern const double norm2(const ComplexVect &a);
+
+    /**
+     * Returns the inner product conj(a) b by compensated summation (parallel blocks for large vectors)
+     *
+     * @param a the left vector
+     * @param b the right vector
+     */
+    extern const std::complex<double> inner(const ComplexVect &a, const ComplexVect &b);
+
+    /**
+     * Scales in place the vector to unit 2-norm
+     *
+     * @param a the vector
+     */
+    extern ComplexVect &normalise(ComplexVect &a);
+
+    /**
+     * Returns the seed of an independent random stream (splitmix64)
+     *
+     * @param seed  the random seed
+     * @param index the stream index
+     */
+    extern const uint64_t streamSeed(const uint64_t seed, const uint64_t index);
+
+    /**
+     * The minimum amount of work (cells or elementary operations) split among threads
+     */
+    const size_t PARALLEL_SIZE = 1 << 14;
+
+    /**
+     * Returns the number of threads of parallel work
+     * (1 below the parallel size, else the requested threads bounded by the tasks)
+     *
+     * @param numThreads the requested number of threads (0 for hardware concurrency)
+     * @param numTasks   the number of independent tasks
+     * @param work       the amount of work of all the tasks (default for coarse tasks worth a thread each)
+     */
+    inline const size_t threadCount(const size_t numThreads, const size_t numTasks, const size_t work = PARALLEL_SIZE)
+    {
+        if (work < PARALLEL_SIZE)
+        {
+            return 1;
+        }
+        const size_t n = numThreads > 0 ? numThreads : (size_t)std::thread::hardware_concurrency();
+        return std::max((size_t)1, std::min(numTasks, n));
+    }
+
+    /**
+     * Runs the function on contiguous ranges of the tasks, the first range in the calling thread
+     *
+     * @param count      the number of tasks
+     * @param numThreads the number of threads (see threadCount)
+     * @param f          the function of range (from, to)
+     */
+    template <class F>
+    void parallelFor(const size_t count, const size_t numThreads, const F &f)
+    {
+        const size_t n = std::max((size_t)1, std::min(count, numThreads));
+        const size_t range = (count + n - 1) / n;
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < n; t++)
+        {
+            threads.push_back(std::thread([&f, t, range, count]()
+                                          { f(std::min(count, t * range), std::min(count, (t + 1) * range)); }));
+        }
+        f(0, std::min(count, range));
+        for (std::thread &t : threads)
+        {
+            t.join();
+        }
+    }
 }
 #endif
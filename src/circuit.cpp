@@ -0,0 +1,1028 @@
+#include <sstream>
+#include <algorithm>
+#include <bit>
+#include <numbers>
+
+#include "circuit.h"
+#include "fourier.h"
+#include "oracle.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+/**
+ * The maximum number of qubits of circuit printed as dense matrix
+ */
+static const size_t MAX_PRINT_QUBITS = 8;
+
+/**
+ * The maximum number of qubits of gate expanded to dense base matrix
+ */
+static const size_t MAX_EXPAND_QUBITS = 10;
+
+Gate::Gate(const string &name, const GateKernel kernel, const indices_t &bits)
+    : _name(name), _base(0, 0, {}), _bits(bits), _kernel(kernel)
+{
+    validateQubits();
+}
+
+Gate::Gate(const string &name, const indices_t &bits, const vector<uint64_t> &marked)
+    : _name(name), _base(0, 0, {}), _bits(bits), _kernel(GateKernel::oracle), _marked(marked)
+{
+    validateQubits();
+    sort(_marked.begin(), _marked.end());
+    _marked.erase(unique(_marked.begin(), _marked.end()), _marked.end());
+    const uint64_t n = 1ULL << bits.size();
+    if (!_marked.empty() && _marked.back() >= n)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected marked state < " << n << ", got (" << _marked.back() << ")")
+                .str());
+    }
+}
+
+Gate::Gate(const string &name, const indices_t &bits, const vector<ReversibleOp> &network)
+    : _name(name), _base(0, 0, {}), _bits(bits), _kernel(GateKernel::reversible), _network(network)
+{
+    validateQubits();
+    const uint64_t mask = bits.size() < 64 ? (1ULL << bits.size()) - 1 : ~0ULL;
+    for (const ReversibleOp &op : network)
+    {
+        if (((op.controls | op.flips) & ~mask) != 0)
+        {
+            throw invalid_argument(
+                (ostringstream() << "Expected operations on " << bits.size() << " qubits, got (" << op.controls << ", " << op.flips << ")")
+                    .str());
+        }
+    }
+}
+
+Gate::Gate(const string &name, const indices_t &bits, const shared_ptr<const Circuit> &circuit, const uint64_t exponent)
+    : _name(name), _base(0, 0, {}), _bits(bits), _kernel(GateKernel::power), _circuit(circuit), _exponent(exponent)
+{
+    validateQubits();
+    if (circuit->numQubits() > bits.size())
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected circuit of at most " << bits.size() << " qubits, got (" << circuit->numQubits() << ")")
+                .str());
+    }
+}
+
+Gate::Gate(const string &name, const Matrix &base, const indices_t &bits, const indices_t &controls)
+    : _name(name), _base(base), _bits(bits), _controls(controls), _kernel(GateKernel::matrix)
+{
+    validateQubits();
+    const size_t n = 1ULL << bits.size();
+    if (base.numRows() != n || base.numCols() != n)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected " << n << "x" << n << " gate matrix, got ("
+                             << base.numRows() << "x" << base.numCols() << ")")
+                .str());
+    }
+}
+
+void Gate::validateQubits(void) const
+{
+    const indices_t all = qubits();
+    validateBitMap(all);
+    for (const size_t bit : all)
+    {
+        if (bit >= MAX_QUBITS)
+        {
+            throw invalid_argument(
+                (ostringstream() << "Qubit index out of range 0..." << MAX_QUBITS - 1 << ", got (" << bit << ")")
+                    .str());
+        }
+    }
+}
+
+const indices_t Gate::qubits(void) const
+{
+    indices_t result = _bits;
+    result.insert(result.end(), _controls.begin(), _controls.end());
+    return result;
+}
+
+const size_t Gate::numQubits(void) const
+{
+    size_t n = 0;
+    for (const size_t bit : qubits())
+    {
+        n = max(n, bit + 1);
+    }
+    return n;
+}
+
+const Gate Gate::expand(void) const
+{
+    if (isDense())
+    {
+        return *this;
+    }
+    const size_t k = _bits.size() + _controls.size();
+    if (k > MAX_EXPAND_QUBITS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Gate too large for expansion: " << k << " qubits")
+                .str());
+    }
+    const Matrix base = _kernel == GateKernel::matrix    ? _base
+                        : _kernel == GateKernel::hadamard ? hadamardMatrix(_bits.size())
+                        : _kernel == GateKernel::oracle   ? oracleMatrix(_bits.size(), _marked)
+                        : _kernel == GateKernel::reversible ? reversibleMatrix(_bits.size(), _network)
+                        : _kernel == GateKernel::power      ? _circuit->matrix().power(_exponent)
+                                                          : fourierMatrix(_bits.size(), _kernel == GateKernel::inverseFourier);
+    if (_controls.empty())
+    {
+        return Gate(_name, base, _bits);
+    }
+    // Identity but the last block (all the controls set)
+    const size_t n = 1ULL << k;
+    const size_t m = base.numRows();
+    const size_t offset = n - m;
+    ComplexVect cells(n * n, 0);
+    for (size_t i = 0; i < offset; i++)
+    {
+        cells[Matrix::indexOf(n, i, i)] = 1;
+    }
+    for (size_t i = 0; i < m; i++)
+    {
+        for (size_t j = 0; j < m; j++)
+        {
+            cells[Matrix::indexOf(n, offset + i, offset + j)] = base.cells()[Matrix::indexOf(m, i, j)];
+        }
+    }
+    return Gate(_name, Matrix(n, n, cells), qubits());
+}
+
+const vector<Gate> Gate::decomposed(void) const
+{
+    if (_kernel != GateKernel::hadamard && _kernel != GateKernel::fourier && _kernel != GateKernel::inverseFourier)
+    {
+        return {*this};
+    }
+    const size_t n = _bits.size();
+    vector<Gate> gates;
+    if (_kernel == GateKernel::hadamard)
+    {
+        for (const size_t bit : _bits)
+        {
+            gates.push_back(hGate(bit));
+        }
+    }
+    else
+    {
+        // From the most significant qubit with the phases controlled by the lower ones, then the bit reversal
+        for (size_t j = n; j-- > 0;)
+        {
+            gates.push_back(hGate(_bits[j]));
+            for (size_t k = j; k-- > 0;)
+            {
+                gates.push_back(controlledGate(phaseGate(_bits[j], numbers::pi / (double)(1ULL << (j - k))).base(), {_bits[k]}, {_bits[j]}));
+            }
+        }
+        for (size_t i = 0; i < n / 2; i++)
+        {
+            gates.push_back(swapGate(_bits[i], _bits[n - 1 - i]));
+        }
+        if (_kernel == GateKernel::inverseFourier)
+        {
+            reverse(gates.begin(), gates.end());
+            for (Gate &gate : gates)
+            {
+                gate = gate.dagger();
+            }
+        }
+    }
+    if (_controls.empty())
+    {
+        return gates;
+    }
+    vector<Gate> result;
+    for (const Gate &gate : gates)
+    {
+        indices_t controls = gate.controls();
+        controls.insert(controls.end(), _controls.begin(), _controls.end());
+        result.push_back(controlledGate(gate.base(), controls, gate.bits()));
+    }
+    return result;
+}
+
+const Matrix Gate::matrix(void) const
+{
+    const Gate gate = expand();
+    return createGate(gate._base, gate._bits);
+}
+
+ComplexVect &Gate::apply(ComplexVect &cells) const
+{
+    apply(cells.data(), cells.size());
+    return cells;
+}
+
+void Gate::apply(complex<double> *cells, const size_t size) const
+{
+    const size_t n = numQubits();
+    if (size < (1ULL << n))
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected state of at least " << n << " qubits, got " << size << " cells")
+                .str());
+    }
+    if (_kernel == GateKernel::reversible)
+    {
+        reversible(cells, size, reversibleOps(*this));
+        return;
+    }
+    if (_kernel == GateKernel::power && _controls.empty())
+    {
+        // Repeats the circuit unless the dense power by squaring is cheaper on the register
+        const size_t q = _bits.size();
+        const uint64_t m = 1ULL << q;
+        const double repeatCost = (double)_exponent * _circuit->gates().size() * size;
+        const double denseCost = 2.0 * bit_width(_exponent) * m * m * m + (double)size * m;
+        if (q > MAX_EXPAND_QUBITS || repeatCost <= denseCost)
+        {
+            const vector<Gate> gates = Circuit(repeated()).fused().gates();
+            for (uint64_t i = 0; i < _exponent; i++)
+            {
+                for (const Gate &gate : gates)
+                {
+                    gate.apply(cells, size);
+                }
+            }
+        }
+        else
+        {
+            expand().apply(cells, size);
+        }
+        return;
+    }
+    if (_kernel == GateKernel::oracle)
+    {
+        // The controls extend the register with the marked values having all the controls set
+        const uint64_t controlMask = ((1ULL << _controls.size()) - 1) << _bits.size();
+        vector<uint64_t> marked = _marked;
+        for (uint64_t &x : marked)
+        {
+            x |= controlMask;
+        }
+        phaseOracle(cells, size, qubits(), marked);
+        return;
+    }
+    if (_kernel != GateKernel::matrix)
+    {
+        if (!_controls.empty())
+        {
+            expand().apply(cells, size);
+            return;
+        }
+        if (_kernel == GateKernel::hadamard)
+        {
+            hadamard(cells, size, _bits);
+        }
+        else
+        {
+            fourier(cells, size, _bits, _kernel == GateKernel::inverseFourier);
+        }
+        return;
+    }
+    if (_bits.size() == 1 && _controls.empty())
+    {
+        applySingle(cells, size);
+        return;
+    }
+    const size_t k = _bits.size();
+    const size_t m = 1ULL << k;
+    uint64_t controlMask = 0;
+    for (const size_t bit : _controls)
+    {
+        controlMask |= 1ULL << bit;
+    }
+    indices_t fixed = qubits();
+    sort(fixed.begin(), fixed.end());
+    // Offsets of gate basis states
+    vector<uint64_t> offsets(m, 0);
+    for (size_t i = 0; i < m; i++)
+    {
+        for (size_t j = 0; j < k; j++)
+        {
+            if ((i >> j) & 1)
+            {
+                offsets[i] |= 1ULL << _bits[j];
+            }
+        }
+    }
+    const ComplexVect &base = _base.cells();
+    ComplexVect in(m);
+    // Enumerates only the basis states with the gate qubits cleared and the control qubits set
+    const uint64_t count = size >> fixed.size();
+    for (uint64_t free = 0; free < count; free++)
+    {
+        uint64_t rest = free;
+        for (const size_t bit : fixed)
+        {
+            rest = ((rest >> bit) << (bit + 1)) | (rest & ((1ULL << bit) - 1));
+        }
+        rest |= controlMask;
+        for (size_t i = 0; i < m; i++)
+        {
+            in[i] = cells[rest | offsets[i]];
+        }
+        for (size_t i = 0; i < m; i++)
+        {
+            complex<double> value = 0;
+            for (size_t j = 0; j < m; j++)
+            {
+                value += base[i * m + j] * in[j];
+            }
+            cells[rest | offsets[i]] = value;
+        }
+    }
+}
+
+void Gate::applySingle(complex<double> *cells, const size_t size) const
+{
+    const uint64_t stride = 1ULL << _bits[0];
+    const complex<double> b00 = _base.cells()[0];
+    const complex<double> b01 = _base.cells()[1];
+    const complex<double> b10 = _base.cells()[2];
+    const complex<double> b11 = _base.cells()[3];
+    if (isDiagonal())
+    {
+        // Diagonal gate: phase multiplies without reading the partner amplitudes
+        const bool scale0 = b00 != 1.0;
+        const bool scale1 = b11 != 1.0;
+        for (uint64_t base = 0; base < size; base += 2 * stride)
+        {
+            for (uint64_t i = base; i < base + stride; i++)
+            {
+                if (scale0)
+                {
+                    cells[i] *= b00;
+                }
+                if (scale1)
+                {
+                    cells[i + stride] *= b11;
+                }
+            }
+        }
+        return;
+    }
+    for (uint64_t base = 0; base < size; base += 2 * stride)
+    {
+        for (uint64_t i = base; i < base + stride; i++)
+        {
+            const complex<double> a0 = cells[i];
+            const complex<double> a1 = cells[i + stride];
+            cells[i] = b00 * a0 + b01 * a1;
+            cells[i + stride] = b10 * a0 + b11 * a1;
+        }
+    }
+}
+
+const bool Gate::isDiagonal(void) const
+{
+    if (_kernel != GateKernel::matrix)
+    {
+        return _kernel == GateKernel::oracle;
+    }
+    const size_t n = _base.numRows();
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            if (i != j && _base.cells()[Matrix::indexOf(n, i, j)] != 0.0)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+const bool Gate::isPermutation(void) const
+{
+    if (_kernel != GateKernel::matrix)
+    {
+        return _kernel == GateKernel::reversible;
+    }
+    const size_t n = _base.numRows();
+    for (size_t j = 0; j < n; j++)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            if (norm(_base.cells()[Matrix::indexOf(n, i, j)]) != 0)
+            {
+                count++;
+            }
+        }
+        if (count != 1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the inverse kernel of the transform kernels
+ * @param kernel the kernel
+ */
+static const GateKernel inverseKernel(const GateKernel kernel)
+{
+    return kernel == GateKernel::fourier          ? GateKernel::inverseFourier
+           : kernel == GateKernel::inverseFourier ? GateKernel::fourier
+                                                  : kernel;
+}
+
+const Gate Gate::dagger(void) const
+{
+    if (_kernel != GateKernel::matrix)
+    {
+        Gate result = *this;
+        result._name = _name + "^";
+        result._kernel = inverseKernel(_kernel);
+        // The operations are involutions
+        reverse(result._network.begin(), result._network.end());
+        if (_circuit)
+        {
+            result._circuit = make_shared<const Circuit>(_circuit->dagger());
+        }
+        return result;
+    }
+    return Gate(_name + "^", _base.dagger(), _bits, _controls);
+}
+
+const Gate Gate::conj(void) const
+{
+    if (_kernel != GateKernel::matrix)
+    {
+        // The transform matrices are symmetric, the oracle and reversible matrices are real
+        Gate result = *this;
+        result._kernel = inverseKernel(_kernel);
+        if (_circuit)
+        {
+            vector<Gate> gates;
+            for (const Gate &gate : _circuit->gates())
+            {
+                gates.push_back(gate.conj());
+            }
+            result._circuit = make_shared<const Circuit>(gates);
+        }
+        return result;
+    }
+    return Gate(_name, _base.conj(), _bits, _controls);
+}
+
+const vector<Gate> Gate::repeated(void) const
+{
+    if (!_circuit)
+    {
+        return {*this};
+    }
+    auto global = [this](const indices_t &qubits)
+    {
+        indices_t result;
+        for (const size_t bit : qubits)
+        {
+            result.push_back(_bits[bit]);
+        }
+        return result;
+    };
+    vector<Gate> result;
+    for (const Gate &gate : _circuit->gates())
+    {
+        result.push_back(gate.remap(global(gate.bits()), global(gate.controls())));
+    }
+    return result;
+}
+
+const Gate Gate::remap(const indices_t &bits, const indices_t &controls) const
+{
+    if (bits.size() != _bits.size())
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected " << _bits.size() << " gate qubits, got " << bits.size())
+                .str());
+    }
+    Gate result = *this;
+    result._bits = bits;
+    result._controls = controls;
+    result.validateQubits();
+    return result;
+}
+
+Circuit::Circuit(const vector<Gate> &gates) : _gates(gates)
+{
+    if (gates.empty())
+    {
+        throw invalid_argument("Expected at least a gate");
+    }
+}
+
+const size_t Circuit::numQubits(void) const
+{
+    size_t n = 0;
+    for (const Gate &gate : _gates)
+    {
+        n = max(n, gate.numQubits());
+    }
+    return n;
+}
+
+const Circuit Circuit::operator*(const Circuit &right) const
+{
+    vector<Gate> gates = right._gates;
+    gates.insert(gates.end(), _gates.begin(), _gates.end());
+    return Circuit(gates);
+}
+
+const Circuit Circuit::dagger(void) const
+{
+    vector<Gate> gates;
+    for (auto it = _gates.rbegin(); it != _gates.rend(); ++it)
+    {
+        gates.push_back(it->dagger());
+    }
+    return Circuit(gates);
+}
+
+/**
+ * Returns true if the gate is a Walsh-Hadamard transform or H gate without controls
+ * @param gate the gate
+ */
+static const bool isHadamard(const Gate &gate)
+{
+    return gate.kernel() == GateKernel::hadamard
+               ? gate.controls().empty()
+               : gate.isDense() && gate.bits().size() == 1 && gate.base().cells() == H_GATE.cells();
+}
+
+const Circuit Circuit::fused(void) const
+{
+    vector<Gate> gates;
+    size_t i = 0;
+    while (i < _gates.size())
+    {
+        size_t j = i + 1;
+        if (isHadamard(_gates[i]))
+        {
+            // H twice on the same qubit closes the layer
+            indices_t layer = _gates[i].bits();
+            while (j < _gates.size() && isHadamard(_gates[j]) &&
+                   none_of(_gates[j].bits().begin(), _gates[j].bits().end(), [&layer](const size_t bit)
+                           { return find(layer.begin(), layer.end(), bit) != layer.end(); }))
+            {
+                layer.insert(layer.end(), _gates[j].bits().begin(), _gates[j].bits().end());
+                j++;
+            }
+            gates.push_back(j - i > 1 ? hnGate(layer) : _gates[i]);
+        }
+        else if (!reversibleOps(_gates[i]).empty())
+        {
+            while (j < _gates.size() && !reversibleOps(_gates[j]).empty())
+            {
+                j++;
+            }
+            gates.push_back(j - i > 1 ? reversibleGate(vector<Gate>(_gates.begin() + i, _gates.begin() + j)) : _gates[i]);
+        }
+        else
+        {
+            gates.push_back(_gates[i]);
+        }
+        i = j;
+    }
+    return Circuit(gates);
+}
+
+vu::ComplexVect &Circuit::apply(ComplexVect &cells, const size_t numCols) const
+{
+    if (numCols == 0 || cells.size() % numCols != 0)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected block of " << numCols << " columns, got " << cells.size() << " cells")
+                .str());
+    }
+    const Circuit circuit = fused();
+    if (numCols == 1)
+    {
+        for (const Gate &gate : circuit.gates())
+        {
+            gate.apply(cells);
+        }
+        return cells;
+    }
+    // Pads the columns to a power of 2 so the column index is the least significant qubits
+    const size_t numRows = cells.size() / numCols;
+    const size_t b = numBitsByState(numCols - 1);
+    const size_t width = 1ULL << b;
+    ComplexVect block(numRows * width, 0);
+    for (size_t i = 0; i < numRows; i++)
+    {
+        copy(cells.begin() + i * numCols, cells.begin() + (i + 1) * numCols, block.begin() + i * width);
+    }
+    auto shift = [b](const indices_t &bits)
+    {
+        indices_t result;
+        for (const size_t bit : bits)
+        {
+            result.push_back(bit + b);
+        }
+        return result;
+    };
+    for (const Gate &gate : circuit.gates())
+    {
+        gate.remap(shift(gate.bits()), shift(gate.controls())).apply(block);
+    }
+    for (size_t i = 0; i < numRows; i++)
+    {
+        copy(block.begin() + i * width, block.begin() + i * width + numCols, cells.begin() + i * numCols);
+    }
+    return cells;
+}
+
+const Matrix Circuit::matrix(void) const
+{
+    if (numQubits() > MAX_DENSE_QUBITS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Circuit too large for dense matrix: " << numQubits() << " qubits")
+                .str());
+    }
+    if (_gates.size() == 1)
+    {
+        return _gates[0].matrix();
+    }
+    // Expands once the powers otherwise recomputed by each column
+    vector<Gate> gates;
+    for (const Gate &gate : _gates)
+    {
+        gates.push_back(gate.kernel() == GateKernel::power && gate.qubits().size() <= MAX_EXPAND_QUBITS
+                            ? gate.expand()
+                            : gate);
+    }
+    // Column j is the circuit applied to the basis state |j> (column major buffer)
+    const size_t m = 1ULL << numQubits();
+    ComplexVect columns(m * m, 0);
+    parallelFor(m, threadCount(0, m, m * m), [&gates, &columns, m](const size_t from, const size_t to)
+                {
+        for (size_t j = from; j < to; j++)
+        {
+            complex<double> *column = columns.data() + j * m;
+            column[j] = 1;
+            for (const Gate &gate : gates)
+            {
+                gate.apply(column, m);
+            }
+        } });
+    ComplexVect cells(m * m);
+    for (size_t i = 0; i < m; i++)
+    {
+        for (size_t j = 0; j < m; j++)
+        {
+            // Adding zero clears the negative zeros of the sign flips
+            const complex<double> &cell = columns[j * m + i];
+            cells[Matrix::indexOf(m, i, j)] = complex<double>(cell.real() + 0.0, cell.imag() + 0.0);
+        }
+    }
+    return Matrix(m, m, cells);
+}
+
+static const string gateName(const string &id, const indices_t &bits)
+{
+    ostringstream stream;
+    stream << id << "(";
+    bool first = true;
+    for (const size_t bit : bits)
+    {
+        if (!first)
+        {
+            stream << ",";
+        }
+        first = false;
+        stream << bit;
+    }
+    return stream.str() + ")";
+}
+
+const Gate mx::xGate(const size_t qubit)
+{
+    return Gate(gateName("X", {qubit}), X_GATE, {qubit});
+}
+
+const Gate mx::yGate(const size_t qubit)
+{
+    return Gate(gateName("Y", {qubit}), Y_GATE, {qubit});
+}
+
+const Gate mx::zGate(const size_t qubit)
+{
+    return Gate(gateName("Z", {qubit}), Z_GATE, {qubit});
+}
+
+const Gate mx::hGate(const size_t qubit)
+{
+    return Gate(gateName("H", {qubit}), H_GATE, {qubit});
+}
+
+const Gate mx::sGate(const size_t qubit)
+{
+    return Gate(gateName("S", {qubit}), S_GATE, {qubit});
+}
+
+const Gate mx::tGate(const size_t qubit)
+{
+    return Gate(gateName("T", {qubit}), T_GATE, {qubit});
+}
+
+const Gate mx::swapGate(const size_t qubit0, const size_t qubit1)
+{
+    return Gate(gateName("SWAP", {qubit0, qubit1}), SWAP_GATE, {qubit0, qubit1});
+}
+
+const Gate mx::cnotGate(const size_t data, const size_t control)
+{
+    return Gate(gateName("CNOT", {data, control}), CNOT_GATE, {data, control});
+}
+
+const Gate mx::ccnotGate(const size_t data, const size_t control0, const size_t control1)
+{
+    return Gate(gateName("CCNOT", {data, control0, control1}), CCNOT_GATE, {data, control0, control1});
+}
+
+const Gate mx::controlledGate(const Matrix &base, const indices_t &controls, const indices_t &targets)
+{
+    ostringstream stream;
+    stream << "C" << controls.size() << "U(";
+    bool first = true;
+    for (const size_t bit : targets)
+    {
+        stream << (first ? "" : ",") << bit;
+        first = false;
+    }
+    stream << ";";
+    first = true;
+    for (const size_t bit : controls)
+    {
+        stream << (first ? "" : ",") << bit;
+        first = false;
+    }
+    return Gate(stream.str() + ")", base, targets, controls);
+}
+
+const Gate mx::qftGate(const indices_t &qubits, const bool inverse)
+{
+    if (qubits.empty())
+    {
+        throw invalid_argument("Expected at least a qubit");
+    }
+    return Gate(gateName(inverse ? "IQFT" : "QFT", qubits), inverse ? GateKernel::inverseFourier : GateKernel::fourier, qubits);
+}
+
+const Gate mx::hnGate(const indices_t &qubits)
+{
+    if (qubits.empty())
+    {
+        throw invalid_argument("Expected at least a qubit");
+    }
+    return Gate(gateName("HN", qubits), GateKernel::hadamard, qubits);
+}
+
+/**
+ * Returns the register mask of the gate qubits mask
+ * @param mask the gate qubits mask
+ * @param bits the register qubit of each gate qubit
+ */
+static const uint64_t registerMask(const uint64_t mask, const indices_t &bits)
+{
+    uint64_t result = 0;
+    for (size_t i = 0; i < bits.size(); i++)
+    {
+        if ((mask >> i) & 1)
+        {
+            result |= 1ULL << bits[i];
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the gate qubits mask of the register mask
+ * @param mask the register mask
+ * @param bits the register qubit of each gate qubit
+ */
+static const uint64_t gateMask(const uint64_t mask, const indices_t &bits)
+{
+    uint64_t result = 0;
+    for (size_t i = 0; i < bits.size(); i++)
+    {
+        if ((mask >> bits[i]) & 1)
+        {
+            result |= 1ULL << i;
+        }
+    }
+    return result;
+}
+
+const vector<ReversibleOp> mx::reversibleOps(const Gate &gate)
+{
+    const indices_t &bits = gate.bits();
+    const uint64_t controls = registerMask((1ULL << gate.controls().size()) - 1, gate.controls());
+    if (gate.kernel() == GateKernel::reversible)
+    {
+        vector<ReversibleOp> ops;
+        for (const ReversibleOp &op : gate.network())
+        {
+            ops.push_back(ReversibleOp{registerMask(op.controls, bits) | controls, registerMask(op.flips, bits)});
+        }
+        return ops;
+    }
+    if (gate.kernel() != GateKernel::matrix)
+    {
+        return {};
+    }
+    const ComplexVect &cells = gate.base().cells();
+    if (cells == X_GATE.cells())
+    {
+        return {ReversibleOp{controls, 1ULL << bits[0]}};
+    }
+    if (cells == CNOT_GATE.cells())
+    {
+        return {ReversibleOp{controls | (1ULL << bits[1]), 1ULL << bits[0]}};
+    }
+    if (cells == CCNOT_GATE.cells())
+    {
+        return {ReversibleOp{controls | (1ULL << bits[1]) | (1ULL << bits[2]), 1ULL << bits[0]}};
+    }
+    if (cells == SWAP_GATE.cells())
+    {
+        // Three alternate CNOT
+        const uint64_t a = 1ULL << bits[0];
+        const uint64_t b = 1ULL << bits[1];
+        return {ReversibleOp{controls | a, b}, ReversibleOp{controls | b, a}, ReversibleOp{controls | a, b}};
+    }
+    return {};
+}
+
+const Gate mx::reversibleGate(const vector<Gate> &gates)
+{
+    vector<ReversibleOp> ops;
+    uint64_t all = 0;
+    for (const Gate &gate : gates)
+    {
+        const vector<ReversibleOp> gateOps = reversibleOps(gate);
+        if (gateOps.empty())
+        {
+            throw invalid_argument(
+                (ostringstream() << "Expected reversible gate, got (" << gate.name() << ")")
+                    .str());
+        }
+        for (const ReversibleOp &op : gateOps)
+        {
+            all |= op.controls | op.flips;
+        }
+        ops.insert(ops.end(), gateOps.begin(), gateOps.end());
+    }
+    if (ops.empty())
+    {
+        throw invalid_argument("Expected at least a gate");
+    }
+    indices_t bits;
+    for (size_t bit = 0; bit < MAX_QUBITS; bit++)
+    {
+        if ((all >> bit) & 1)
+        {
+            bits.push_back(bit);
+        }
+    }
+    vector<ReversibleOp> network;
+    for (const ReversibleOp &op : ops)
+    {
+        network.push_back(ReversibleOp{gateMask(op.controls, bits), gateMask(op.flips, bits)});
+    }
+    return Gate(gateName("REV", bits), bits, network);
+}
+
+const Gate mx::oracleGate(const indices_t &qubits, const vector<uint64_t> &marked)
+{
+    if (qubits.empty())
+    {
+        throw invalid_argument("Expected at least a qubit");
+    }
+    return Gate(gateName("ORACLE", qubits), qubits, marked);
+}
+
+const Gate mx::powerGate(const Circuit &circuit, const uint64_t exponent)
+{
+    // Collects the circuit qubits and remaps the gates on them (0...k-1)
+    indices_t bits;
+    for (const Gate &gate : circuit.gates())
+    {
+        for (const size_t bit : gate.qubits())
+        {
+            bits.push_back(bit);
+        }
+    }
+    sort(bits.begin(), bits.end());
+    bits.erase(unique(bits.begin(), bits.end()), bits.end());
+    auto local = [&bits](const indices_t &qubits)
+    {
+        indices_t result;
+        for (const size_t bit : qubits)
+        {
+            result.push_back(lower_bound(bits.begin(), bits.end(), bit) - bits.begin());
+        }
+        return result;
+    };
+    vector<Gate> gates;
+    for (const Gate &gate : circuit.gates())
+    {
+        gates.push_back(gate.remap(local(gate.bits()), local(gate.controls())));
+    }
+    return Gate(gateName("POW", bits) + "^" + std::to_string(exponent), bits, make_shared<const Circuit>(gates), exponent);
+}
+
+/**
+ * Returns the name of rotation gate
+ * @param id the gate identifier
+ * @param qubit the qubit
+ * @param angles the angles
+ */
+static const string rotationName(const string &id, const size_t qubit, const vector<double> &angles)
+{
+    ostringstream stream;
+    stream << id << "(" << qubit;
+    for (const double angle : angles)
+    {
+        stream << "," << angle;
+    }
+    return stream.str() + ")";
+}
+
+const Gate mx::rxGate(const size_t qubit, const double theta)
+{
+    const double c = cos(theta / 2);
+    const double s = sin(theta / 2);
+    return Gate(rotationName("RX", qubit, {theta}),
+                Matrix(2, 2, {c, complex<double>(0, -s), complex<double>(0, -s), c}),
+                {qubit});
+}
+
+const Gate mx::ryGate(const size_t qubit, const double theta)
+{
+    const double c = cos(theta / 2);
+    const double s = sin(theta / 2);
+    return Gate(rotationName("RY", qubit, {theta}), Matrix(2, 2, {c, -s, s, c}), {qubit});
+}
+
+const Gate mx::rzGate(const size_t qubit, const double theta)
+{
+    return Gate(rotationName("RZ", qubit, {theta}),
+                Matrix(2, 2, {polar(1.0, -theta / 2), 0, 0, polar(1.0, theta / 2)}),
+                {qubit});
+}
+
+const Gate mx::phaseGate(const size_t qubit, const double lambda)
+{
+    return Gate(rotationName("PHASE", qubit, {lambda}), Matrix(2, 2, {1, 0, 0, polar(1.0, lambda)}), {qubit});
+}
+
+const Gate mx::u3Gate(const size_t qubit, const double theta, const double phi, const double lambda)
+{
+    const double c = cos(theta / 2);
+    const double s = sin(theta / 2);
+    return Gate(rotationName("U3", qubit, {theta, phi, lambda}),
+                Matrix(2, 2, {c, -polar(s, lambda), polar(s, phi), polar(c, phi + lambda)}),
+                {qubit});
+}
+
+ostream &operator<<(ostream &stream, const Circuit &circuit)
+{
+    if (circuit.numQubits() <= MAX_PRINT_QUBITS)
+    {
+        return stream << circuit.matrix();
+    }
+    // Prints the product chain of gates
+    const vector<Gate> &gates = circuit.gates();
+    for (auto it = gates.rbegin(); it != gates.rend(); ++it)
+    {
+        if (it != gates.rbegin())
+        {
+            stream << " * ";
+        }
+        stream << it->name();
+    }
+    return stream;
+}
+
+const string to_string(const Circuit &circuit)
+{
+    stringstream stream;
+    stream << circuit;
+    return stream.str();
+}
@@ -191,13 +191,13 @@ Compiler *Compiler::createQu(Tokenizer &tokenizer)
         const FunctionDef &def = QU_PROCESSOR_FUNCTIONS.at(func->id());
         const int requiredArgs = def.numArgs();
 
-        if (actualArgs != requiredArgs)
+        if (def.variadic() ? actualArgs < requiredArgs : actualArgs != requiredArgs)
         {
             const string id = func->id();
             delete func;
             throw token.context().parseException(
-                id + " requires " + std::to_string(requiredArgs) + " arguments: actual (" + std::to_string(actualArgs) +
-                ")");
+                id + " requires " + (def.variadic() ? "at least " : "") + std::to_string(requiredArgs) +
+                " arguments: actual (" + std::to_string(actualArgs) + ")");
         }
         context.pushCommand(func);
     };
@@ -0,0 +1,495 @@
+#include <sstream>
+#include <cmath>
+#include <unordered_set>
+#include <algorithm>
+
+#include "decisionDiagram.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+/**
+ * Returns the mixed hash value
+ * @param seed the current hash value
+ * @param value the value to mix
+ */
+static inline const size_t mix(const size_t seed, const uint64_t value)
+{
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+/**
+ * Returns the edge packed in an integer
+ * @param edge the edge
+ */
+static inline const uint64_t pack(const DDEdge &edge)
+{
+    return ((uint64_t)edge.node << 32) | edge.weight;
+}
+
+ComplexTable::ComplexTable(const double tolerance) : _tolerance(tolerance)
+{
+    _values.push_back(0);
+    _values.push_back(1);
+    _cells[cellKey(0, 0)].push_back(ZERO);
+    _cells[cellKey(llround(1 / tolerance), 0)].push_back(ONE);
+}
+
+const uint64_t ComplexTable::cellKey(const int64_t re, const int64_t im) const
+{
+    return mix(mix(0, re), im);
+}
+
+const uint32_t ComplexTable::lookup(const complex<double> &value)
+{
+    if (abs(value) <= _tolerance)
+    {
+        return ZERO;
+    }
+    const int64_t re = llround(value.real() / _tolerance);
+    const int64_t im = llround(value.imag() / _tolerance);
+    for (int64_t i = -1; i <= 1; i++)
+    {
+        for (int64_t j = -1; j <= 1; j++)
+        {
+            const auto it = _cells.find(cellKey(re + i, im + j));
+            if (it != _cells.end())
+            {
+                for (const uint32_t id : it->second)
+                {
+                    if (abs(_values[id] - value) <= _tolerance)
+                    {
+                        return id;
+                    }
+                }
+            }
+        }
+    }
+    const uint32_t id = _values.size();
+    _values.push_back(value);
+    _cells[cellKey(re, im)].push_back(id);
+    return id;
+}
+
+const size_t DDPackage::NodeHash::operator()(const DDNode &node) const
+{
+    size_t h = mix(node.level, node.numEdges);
+    for (uint32_t i = 0; i < node.numEdges; i++)
+    {
+        h = mix(h, pack(node.edges[i]));
+    }
+    return h;
+}
+
+const bool DDPackage::NodeEqual::operator()(const DDNode &a, const DDNode &b) const
+{
+    if (a.level != b.level || a.numEdges != b.numEdges)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < a.numEdges; i++)
+    {
+        if (!(a.edges[i] == b.edges[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const size_t DDPackage::PairHash::operator()(const pair<uint64_t, uint64_t> &key) const
+{
+    return mix(mix(0, key.first), key.second);
+}
+
+DDPackage::DDPackage(const double tolerance) : _complex(tolerance)
+{
+    _nodes.push_back(DDNode{-1, 0, {}});
+}
+
+const DDEdge DDPackage::makeNode(const int level, const vector<DDEdge> &edges)
+{
+    // Normalizes by the weight with the greatest magnitude
+    const size_t n = edges.size();
+    size_t pivot = n;
+    double maxMagnitude = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (edges[i].weight != ComplexTable::ZERO)
+        {
+            const double magnitude = abs(_complex.value(edges[i].weight));
+            if (pivot == n || magnitude > maxMagnitude * (1 + 1e-9))
+            {
+                pivot = i;
+                maxMagnitude = magnitude;
+            }
+        }
+    }
+    if (pivot == n)
+    {
+        return ZERO_EDGE;
+    }
+    const complex<double> divisor = _complex.value(edges[pivot].weight);
+    DDNode node{level, (uint32_t)n, {}};
+    for (size_t i = 0; i < n; i++)
+    {
+        node.edges[i] = edges[i].weight == ComplexTable::ZERO
+                            ? ZERO_EDGE
+                        : i == pivot
+                            ? DDEdge{edges[i].node, ComplexTable::ONE}
+                            : DDEdge{edges[i].node, _complex.lookup(_complex.value(edges[i].weight) / divisor)};
+    }
+    const auto it = _unique.find(node);
+    if (it != _unique.end())
+    {
+        return DDEdge{it->second, edges[pivot].weight};
+    }
+    const uint32_t id = _nodes.size();
+    _nodes.push_back(node);
+    _unique[node] = id;
+    return DDEdge{id, edges[pivot].weight};
+}
+
+const DDEdge DDPackage::scale(const DDEdge &edge, const uint32_t weight)
+{
+    if (edge.weight == ComplexTable::ZERO || weight == ComplexTable::ZERO)
+    {
+        return ZERO_EDGE;
+    }
+    if (weight == ComplexTable::ONE)
+    {
+        return edge;
+    }
+    const uint32_t w = _complex.lookup(_complex.value(edge.weight) * _complex.value(weight));
+    return w == ComplexTable::ZERO ? ZERO_EDGE : DDEdge{edge.node, w};
+}
+
+const DDEdge DDPackage::add(const DDEdge &left, const DDEdge &right)
+{
+    if (left.weight == ComplexTable::ZERO)
+    {
+        return right;
+    }
+    if (right.weight == ComplexTable::ZERO)
+    {
+        return left;
+    }
+    if (left.node == right.node)
+    {
+        const uint32_t w = _complex.lookup(_complex.value(left.weight) + _complex.value(right.weight));
+        return w == ComplexTable::ZERO ? ZERO_EDGE : DDEdge{left.node, w};
+    }
+    const pair<uint64_t, uint64_t> key = pack(left) < pack(right)
+                                             ? make_pair(pack(left), pack(right))
+                                             : make_pair(pack(right), pack(left));
+    const auto it = _addTable.find(key);
+    if (it != _addTable.end())
+    {
+        return it->second;
+    }
+    // Copies the nodes because the recursion may grow the node table
+    const DDNode a = _nodes[left.node];
+    const DDNode b = _nodes[right.node];
+    if (a.level != b.level || a.numEdges != b.numEdges)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected same diagram levels, got (" << a.level << ", " << b.level << ")")
+                .str());
+    }
+    vector<DDEdge> edges;
+    for (uint32_t i = 0; i < a.numEdges; i++)
+    {
+        edges.push_back(add(scale(a.edges[i], left.weight), scale(b.edges[i], right.weight)));
+    }
+    const DDEdge result = makeNode(a.level, edges);
+    _addTable[key] = result;
+    return result;
+}
+
+const DDEdge DDPackage::multiply(const DDEdge &left, const DDEdge &right)
+{
+    if (left.weight == ComplexTable::ZERO || right.weight == ComplexTable::ZERO)
+    {
+        return ZERO_EDGE;
+    }
+    const DDEdge result = multiplyNodes(left.node, right.node);
+    return scale(result, _complex.lookup(_complex.value(left.weight) * _complex.value(right.weight)));
+}
+
+const DDEdge DDPackage::multiplyNodes(const uint32_t left, const uint32_t right)
+{
+    if (left == TERMINAL && right == TERMINAL)
+    {
+        return DDEdge{TERMINAL, ComplexTable::ONE};
+    }
+    const uint64_t key = ((uint64_t)left << 32) | right;
+    const auto it = _mulTable.find(key);
+    if (it != _mulTable.end())
+    {
+        return it->second;
+    }
+    const DDNode a = _nodes[left];
+    const DDNode b = _nodes[right];
+    if (a.level != b.level || a.numEdges != 4)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected matrix diagram with same levels, got (" << a.level << ", " << b.level << ")")
+                .str());
+    }
+    vector<DDEdge> edges;
+    if (b.numEdges == 2)
+    {
+        for (size_t i = 0; i < 2; i++)
+        {
+            edges.push_back(add(multiply(a.edges[2 * i], b.edges[0]),
+                                multiply(a.edges[2 * i + 1], b.edges[1])));
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < 2; i++)
+        {
+            for (size_t j = 0; j < 2; j++)
+            {
+                edges.push_back(add(multiply(a.edges[2 * i], b.edges[j]),
+                                    multiply(a.edges[2 * i + 1], b.edges[2 + j])));
+            }
+        }
+    }
+    const DDEdge result = makeNode(a.level, edges);
+    _mulTable[key] = result;
+    return result;
+}
+
+const DDEdge DDPackage::buildKet(const ComplexVect &cells, const int level, const size_t offset)
+{
+    if (level < 0)
+    {
+        return offset < cells.size()
+                   ? DDEdge{TERMINAL, _complex.lookup(cells[offset])}
+                   : ZERO_EDGE;
+    }
+    return makeNode(level, {buildKet(cells, level - 1, offset),
+                            buildKet(cells, level - 1, offset + (1ULL << level))});
+}
+
+const DDEdge DDPackage::ket(const Matrix &ket, const size_t numQubits)
+{
+    if (ket.numCols() != 1)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected ket, got (" << ket.numRows() << "x" << ket.numCols() << ")")
+                .str());
+    }
+    return buildKet(ket.cells(), numQubits - 1, 0);
+}
+
+const DDEdge DDPackage::identity(const int level)
+{
+    if (level < 0)
+    {
+        return DDEdge{TERMINAL, ComplexTable::ONE};
+    }
+    const DDEdge sub = identity(level - 1);
+    return makeNode(level, {sub, ZERO_EDGE, ZERO_EDGE, sub});
+}
+
+const DDEdge DDPackage::buildGate(const Gate &gate, const int level, const size_t row, const size_t col)
+{
+    if (level < 0)
+    {
+        const size_t n = gate.base().numRows();
+        return DDEdge{TERMINAL, _complex.lookup(gate.base().cells()[Matrix::indexOf(n, row, col)])};
+    }
+    const indices_t &controls = gate.controls();
+    if (find(controls.begin(), controls.end(), (size_t)level) != controls.end())
+    {
+        // Identity on the gate qubits below a control not set
+        const DDEdge off = row == col ? identity(level - 1) : ZERO_EDGE;
+        return makeNode(level, {off, ZERO_EDGE, ZERO_EDGE, buildGate(gate, level - 1, row, col)});
+    }
+    const indices_t &bits = gate.bits();
+    const auto it = find(bits.begin(), bits.end(), (size_t)level);
+    if (it == bits.end())
+    {
+        // Identity on not gate qubit
+        const DDEdge sub = buildGate(gate, level - 1, row, col);
+        return makeNode(level, {sub, ZERO_EDGE, ZERO_EDGE, sub});
+    }
+    const size_t pos = it - bits.begin();
+    vector<DDEdge> edges;
+    for (size_t i = 0; i < 2; i++)
+    {
+        for (size_t j = 0; j < 2; j++)
+        {
+            edges.push_back(buildGate(gate, level - 1, row | (i << pos), col | (j << pos)));
+        }
+    }
+    return makeNode(level, edges);
+}
+
+const DDEdge DDPackage::buildOracle(const Gate &gate, const int level, const vector<uint64_t> &marked)
+{
+    // Diagonal splitting the marked values compatible with the qubits above
+    if (marked.empty())
+    {
+        return identity(level);
+    }
+    if (level < 0)
+    {
+        return DDEdge{TERMINAL, _complex.lookup(-1)};
+    }
+    const indices_t &controls = gate.controls();
+    if (find(controls.begin(), controls.end(), (size_t)level) != controls.end())
+    {
+        return makeNode(level, {identity(level - 1), ZERO_EDGE, ZERO_EDGE, buildOracle(gate, level - 1, marked)});
+    }
+    const indices_t &bits = gate.bits();
+    const auto it = find(bits.begin(), bits.end(), (size_t)level);
+    if (it == bits.end())
+    {
+        const DDEdge sub = buildOracle(gate, level - 1, marked);
+        return makeNode(level, {sub, ZERO_EDGE, ZERO_EDGE, sub});
+    }
+    const size_t pos = it - bits.begin();
+    vector<uint64_t> marked0, marked1;
+    for (const uint64_t value : marked)
+    {
+        (((value >> pos) & 1) != 0 ? marked1 : marked0).push_back(value);
+    }
+    return makeNode(level, {buildOracle(gate, level - 1, marked0), ZERO_EDGE, ZERO_EDGE, buildOracle(gate, level - 1, marked1)});
+}
+
+const DDEdge DDPackage::gate(const Gate &gate, const size_t numQubits)
+{
+    if (gate.kernel() == GateKernel::oracle)
+    {
+        return buildOracle(gate, numQubits - 1, gate.marked());
+    }
+    if (gate.kernel() == GateKernel::hadamard || gate.kernel() == GateKernel::fourier || gate.kernel() == GateKernel::inverseFourier)
+    {
+        const vector<Gate> gates = gate.decomposed();
+        DDEdge result = this->gate(gates.front(), numQubits);
+        for (size_t i = 1; i < gates.size(); i++)
+        {
+            result = multiply(this->gate(gates[i], numQubits), result);
+        }
+        return result;
+    }
+    return buildGate(gate.kernel() == GateKernel::matrix ? gate : gate.expand(), numQubits - 1, 0, 0);
+}
+
+const DDEdge DDPackage::extend(const DDEdge &root, const size_t numQubits, const size_t newQubits)
+{
+    DDEdge result = root;
+    for (size_t level = numQubits; level < newQubits; level++)
+    {
+        result = makeNode(level, {result, ZERO_EDGE});
+    }
+    return result;
+}
+
+const complex<double> DDPackage::amplitude(const DDEdge &root, const size_t numQubits, const uint64_t index) const
+{
+    complex<double> result = weight(root);
+    uint32_t node = root.node;
+    for (int level = numQubits - 1; level >= 0 && result != 0.0; level--)
+    {
+        const DDEdge &edge = _nodes[node].edges[(index >> level) & 1];
+        result *= weight(edge);
+        node = edge.node;
+    }
+    return result;
+}
+
+const size_t DDPackage::size(const DDEdge &root) const
+{
+    unordered_set<uint32_t> visited;
+    vector<uint32_t> stack{root.node};
+    while (!stack.empty())
+    {
+        const uint32_t id = stack.back();
+        stack.pop_back();
+        if (id == TERMINAL || !visited.insert(id).second)
+        {
+            continue;
+        }
+        const DDNode &node = _nodes[id];
+        for (uint32_t i = 0; i < node.numEdges; i++)
+        {
+            if (node.edges[i].weight != ComplexTable::ZERO)
+            {
+                stack.push_back(node.edges[i].node);
+            }
+        }
+    }
+    return visited.size();
+}
+
+DDState::DDState(const Matrix &ket)
+    : _package(make_shared<DDPackage>()), _numQubits(numBitsByState(ket.numRows() - 1))
+{
+    _root = _package->ket(ket, _numQubits);
+}
+
+const complex<double> DDState::at(const uint64_t index) const
+{
+    return _package->amplitude(_root, _numQubits, index);
+}
+
+/**
+ * Collects the non zero amplitudes of vector diagram in basis state order
+ */
+static void collect(const DDPackage &package, const DDEdge &edge, const int level, const uint64_t index,
+                    const complex<double> &weight, vector<pair<uint64_t, complex<double>>> &result)
+{
+    if (edge.weight == ComplexTable::ZERO)
+    {
+        return;
+    }
+    const complex<double> w = weight * package.weight(edge);
+    if (level < 0)
+    {
+        result.push_back({index, w});
+        return;
+    }
+    const DDNode &node = package.node(edge.node);
+    collect(package, node.edges[0], level - 1, index, w, result);
+    collect(package, node.edges[1], level - 1, index | (1ULL << level), w, result);
+}
+
+const vector<pair<uint64_t, complex<double>>> DDState::amplitudes(void) const
+{
+    vector<pair<uint64_t, complex<double>>> result;
+    collect(*_package, _root, _numQubits - 1, 0, 1, result);
+    return result;
+}
+
+const StatePtr DDState::transform(const Circuit &circuit) const
+{
+    const size_t n = max(_numQubits, circuit.numQubits());
+    DDEdge root = _package->extend(_root, _numQubits, n);
+    for (const Gate &gate : circuit.gates())
+    {
+        // The transforms apply gate by gate without the diagram of the whole transform
+        for (const Gate &g : gate.decomposed())
+        {
+            root = _package->multiply(_package->gate(g, n), root);
+        }
+    }
+    return make_shared<DDState>(_package, root, n);
+}
+
+const StatePtr DDState::project(const size_t qubit, const int outcome, const double probability) const
+{
+    if (qubit >= _numQubits)
+    {
+        // The missing qubits are |0>
+        return make_shared<DDState>(_package, _root, _numQubits);
+    }
+    // Multiplies by the scaled projector sharing the unchanged sub diagrams
+    const double scale = 1 / sqrt(probability);
+    const Gate projector("P", Matrix(2, 2, {outcome == 0 ? scale : 0, 0, 0, outcome == 1 ? scale : 0}), {qubit});
+    return make_shared<DDState>(_package, _package->multiply(_package->gate(projector, _numQubits), _root), _numQubits);
+}
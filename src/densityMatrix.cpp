@@ -0,0 +1,315 @@
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+
+#include "densityMatrix.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+static const Matrix I_BASE(2, 2, {1, 0, 0, 1});
+
+/**
+ * Throws exception if the probability is out of range 0...1
+ * @param p the probability
+ */
+static void validateProbability(const double p)
+{
+    if (!(p >= 0 && p <= 1))
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected probability in range 0...1, got (" << p << ")")
+                .str());
+    }
+}
+
+DensityMatrix::DensityMatrix(const Matrix &ket) : _numQubits(numBitsByState(ket.numRows() - 1))
+{
+    if (ket.numCols() != 1)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected ket, got (" << ket.numRows() << "x" << ket.numCols() << ")")
+                .str());
+    }
+    if (_numQubits > MAX_DENSITY_QUBITS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Density matrix too large: " << _numQubits << " qubits")
+                .str());
+    }
+    const size_t n = 1ULL << _numQubits;
+    const ComplexVect &amplitudes = ket.cells();
+    _cells.assign(n * n, 0);
+    for (size_t i = 0; i < amplitudes.size(); i++)
+    {
+        for (size_t j = 0; j < amplitudes.size(); j++)
+        {
+            _cells[i * n + j] = amplitudes[i] * conj(amplitudes[j]);
+        }
+    }
+}
+
+void DensityMatrix::extend(const size_t numQubits)
+{
+    if (numQubits <= _numQubits)
+    {
+        return;
+    }
+    if (numQubits > MAX_DENSITY_QUBITS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Density matrix too large: " << numQubits << " qubits")
+                .str());
+    }
+    // The added qubits are in state |0><0|
+    const size_t n = 1ULL << _numQubits;
+    const size_t m = 1ULL << numQubits;
+    ComplexVect cells(m * m, 0);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            cells[i * m + j] = _cells[i * n + j];
+        }
+    }
+    _cells = cells;
+    _numQubits = numQubits;
+}
+
+const Matrix DensityMatrix::matrix(void) const
+{
+    const size_t n = 1ULL << _numQubits;
+    return Matrix(n, n, _cells);
+}
+
+DensityMatrix &DensityMatrix::apply(const Gate &gate)
+{
+    extend(gate.numQubits());
+    // Column pass U rho on the row qubits
+    indices_t rowBits;
+    for (const size_t bit : gate.bits())
+    {
+        rowBits.push_back(bit + _numQubits);
+    }
+    indices_t rowControls;
+    for (const size_t bit : gate.controls())
+    {
+        rowControls.push_back(bit + _numQubits);
+    }
+    gate.remap(rowBits, rowControls).apply(_cells);
+    // Row pass (U rho) U^ on the column qubits
+    gate.conj().apply(_cells);
+    return *this;
+}
+
+DensityMatrix &DensityMatrix::apply(const Circuit &circuit)
+{
+    for (const Gate &gate : circuit.gates())
+    {
+        apply(gate);
+    }
+    return *this;
+}
+
+void DensityMatrix::applySuperOperator(const Matrix &superOperator, const size_t qubit)
+{
+    extend(qubit + 1);
+    Gate("N", superOperator, {qubit, qubit + _numQubits}).apply(_cells);
+}
+
+DensityMatrix &DensityMatrix::applyChannel(const vector<Matrix> &kraus, const size_t qubit)
+{
+    // The super operator acts on the cells (rho[r][c]) indexed by c | r << 1
+    ComplexVect cells(16, 0);
+    for (const Matrix &k : kraus)
+    {
+        if (k.numRows() != 2 || k.numCols() != 2)
+        {
+            throw invalid_argument(
+                (ostringstream() << "Expected 2x2 Kraus operator, got (" << k.numRows() << "x" << k.numCols() << ")")
+                    .str());
+        }
+        for (size_t r = 0; r < 2; r++)
+        {
+            for (size_t c = 0; c < 2; c++)
+            {
+                for (size_t a = 0; a < 2; a++)
+                {
+                    for (size_t b = 0; b < 2; b++)
+                    {
+                        cells[(c | (r << 1)) * 4 + (b | (a << 1))] += k.at(r, a) * conj(k.at(c, b));
+                    }
+                }
+            }
+        }
+    }
+    applySuperOperator(Matrix(4, 4, cells), qubit);
+    return *this;
+}
+
+DensityMatrix &DensityMatrix::depolarize(const size_t qubit, const double p)
+{
+    validateProbability(p);
+    const double q = sqrt(p / 3);
+    return applyChannel({I_BASE * sqrt(1 - p), X_GATE * q, Y_GATE * q, Z_GATE * q}, qubit);
+}
+
+DensityMatrix &DensityMatrix::dampAmplitude(const size_t qubit, const double gamma)
+{
+    validateProbability(gamma);
+    return applyChannel({Matrix(2, 2, {1, 0, 0, sqrt(1 - gamma)}),
+                         Matrix(2, 2, {0, sqrt(gamma), 0, 0})},
+                        qubit);
+}
+
+DensityMatrix &DensityMatrix::dephase(const size_t qubit, const double p)
+{
+    validateProbability(p);
+    return applyChannel({I_BASE * sqrt(1 - p), Z_GATE * sqrt(p)}, qubit);
+}
+
+const complex<double> DensityMatrix::trace(void) const
+{
+    const size_t n = 1ULL << _numQubits;
+    complex<double> result = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        result += _cells[i * n + i];
+    }
+    return result;
+}
+
+const complex<double> DensityMatrix::expectation(const Matrix &op) const
+{
+    const size_t n = 1ULL << _numQubits;
+    if (op.numRows() != n || op.numCols() != n)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected " << n << "x" << n << " operator, got (" << op.numRows() << "x" << op.numCols() << ")")
+                .str());
+    }
+    complex<double> result = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            result += op.cells()[i * n + j] * _cells[j * n + i];
+        }
+    }
+    return result;
+}
+
+const double DensityMatrix::probability(const size_t qubit) const
+{
+    const size_t n = 1ULL << _numQubits;
+    double result = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if ((i >> qubit) & 1)
+        {
+            result += _cells[i * n + i].real();
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the reduced density matrix on the kept qubits.
+ * Each output row block is accumulated by a thread over the traced basis states
+ * reading the cells at the strides of the kept qubits
+ * @param cells the ket amplitudes (2^n) or the operator cells (2^n x 2^n row major)
+ * @param numQubits the number of qubits n
+ * @param keep the kept qubits
+ * @param pure true if the cells are the ket amplitudes
+ * @param numThreads the number of threads (0 for hardware concurrency)
+ */
+static const Matrix reduce(const complex<double> *cells, const size_t numQubits, const indices_t &keep, const bool pure, const size_t numThreads)
+{
+    validateBitMap(keep);
+    for (const size_t bit : keep)
+    {
+        if (bit >= numQubits)
+        {
+            throw invalid_argument(
+                (ostringstream() << "Expected qubit < " << numQubits << ", got (" << bit << ")")
+                    .str());
+        }
+    }
+    const size_t k = keep.size();
+    const size_t m = 1ULL << k;
+    const uint64_t dim = 1ULL << numQubits;
+    // Offsets of the kept basis states
+    vector<uint64_t> offsets(m, 0);
+    for (size_t a = 0; a < m; a++)
+    {
+        for (size_t i = 0; i < k; i++)
+        {
+            if ((a >> i) & 1)
+            {
+                offsets[a] |= 1ULL << keep[i];
+            }
+        }
+    }
+    indices_t fixed = keep;
+    sort(fixed.begin(), fixed.end());
+    const uint64_t count = dim >> k;
+    ComplexVect result(m * m, 0);
+    auto task = [cells, pure, dim, m, count, &offsets, &fixed, &result](const size_t from, const size_t to)
+    {
+        for (uint64_t r = 0; r < count; r++)
+        {
+            // Inserts the cleared kept qubits into the traced basis state
+            uint64_t rest = r;
+            for (const size_t bit : fixed)
+            {
+                rest = ((rest >> bit) << (bit + 1)) | (rest & ((1ULL << bit) - 1));
+            }
+            for (size_t a = from; a < to; a++)
+            {
+                complex<double> *row = result.data() + a * m;
+                const uint64_t i = rest | offsets[a];
+                if (pure)
+                {
+                    const complex<double> left = cells[i];
+                    if (left == 0.0)
+                    {
+                        continue;
+                    }
+                    for (size_t b = 0; b < m; b++)
+                    {
+                        row[b] += left * conj(cells[rest | offsets[b]]);
+                    }
+                }
+                else
+                {
+                    const complex<double> *opRow = cells + i * dim;
+                    for (size_t b = 0; b < m; b++)
+                    {
+                        row[b] += opRow[rest | offsets[b]];
+                    }
+                }
+            }
+        }
+    };
+    parallelFor(m, threadCount(numThreads, m, dim * m), task);
+    return Matrix(m, m, result);
+}
+
+const Matrix DensityMatrix::partialTrace(const indices_t &keep, const size_t numThreads) const
+{
+    return reduce(_cells.data(), _numQubits, keep, false, numThreads);
+}
+
+const Matrix mx::partialTrace(const Matrix &state, const indices_t &keep, const size_t numThreads)
+{
+    const size_t n = state.numRows();
+    const bool pure = state.numCols() == 1;
+    if (n < 2 || (n & (n - 1)) != 0 || (!pure && state.numCols() != n))
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected ket or operator of 2^n rows, got (" << n << "x" << state.numCols() << ")")
+                .str());
+    }
+    return reduce(state.cells().data(), numBitsByState(n - 1), keep, pure, numThreads);
+}
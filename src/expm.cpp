@@ -0,0 +1,264 @@
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+
+#include "expm.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+/**
+ * The coefficients of the degree 13 Pade approximant
+ */
+static const double PADE_13[] = {
+    64764752532480000.0, 32382376266240000.0, 7771770303897600.0, 1187353796428800.0,
+    129060195264000.0, 10559470521600.0, 670442572800.0, 33522128640.0,
+    1323241920.0, 40840800.0, 960960.0, 16380.0, 182.0, 1.0};
+
+/**
+ * The maximum 1-norm of the scaled matrix of the degree 13 Pade approximant
+ */
+static const double PADE_13_THETA = 5.371920351148152;
+
+/**
+ * The maximum dimension of Krylov subspace
+ */
+static const size_t KRYLOV_SIZE = 30;
+
+/**
+ * The maximum |t| norm of each Krylov step
+ */
+static const double KRYLOV_STEP_NORM = 4;
+
+/**
+ * The relative tolerance of Krylov subspace breakdown
+ */
+static const double KRYLOV_BREAKDOWN = 1e-13;
+
+/**
+ * Returns the 1-norm (maximum absolute column sum)
+ * @param a the matrix
+ */
+static const double norm1(const Matrix &a)
+{
+    double result = 0;
+    for (size_t j = 0; j < a.numCols(); j++)
+    {
+        double sum = 0;
+        for (size_t i = 0; i < a.numRows(); i++)
+        {
+            sum += abs(a.cells()[Matrix::indexOf(a.numCols(), i, j)]);
+        }
+        result = max(result, sum);
+    }
+    return result;
+}
+
+/**
+ * Returns the solution X of A X = B by LU decomposition with partial pivoting
+ * @param a the square matrix
+ * @param b the right hand side
+ */
+static const Matrix solve(const Matrix &a, const Matrix &b)
+{
+    const size_t n = a.numRows();
+    const size_t m = b.numCols();
+    ComplexVect lu = a.cells();
+    ComplexVect x = b.cells();
+    for (size_t k = 0; k < n; k++)
+    {
+        size_t pivot = k;
+        for (size_t i = k + 1; i < n; i++)
+        {
+            if (abs(lu[i * n + k]) > abs(lu[pivot * n + k]))
+            {
+                pivot = i;
+            }
+        }
+        if (lu[pivot * n + k] == 0.0)
+        {
+            throw invalid_argument("Singular Pade denominator");
+        }
+        if (pivot != k)
+        {
+            swap_ranges(lu.begin() + k * n, lu.begin() + (k + 1) * n, lu.begin() + pivot * n);
+            swap_ranges(x.begin() + k * m, x.begin() + (k + 1) * m, x.begin() + pivot * m);
+        }
+        for (size_t i = k + 1; i < n; i++)
+        {
+            const complex<double> f = lu[i * n + k] / lu[k * n + k];
+            for (size_t j = k; j < n; j++)
+            {
+                lu[i * n + j] -= f * lu[k * n + j];
+            }
+            for (size_t j = 0; j < m; j++)
+            {
+                x[i * m + j] -= f * x[k * m + j];
+            }
+        }
+    }
+    for (size_t k = n; k-- > 0;)
+    {
+        for (size_t j = 0; j < m; j++)
+        {
+            complex<double> sum = x[k * m + j];
+            for (size_t i = k + 1; i < n; i++)
+            {
+                sum -= lu[k * n + i] * x[i * m + j];
+            }
+            x[k * m + j] = sum / lu[k * n + k];
+        }
+    }
+    return Matrix(n, m, x);
+}
+
+const Matrix mx::expm(const Matrix &a)
+{
+    const size_t n = a.numRows();
+    if (a.numCols() != n)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected square matrix, got (" << n << "x" << a.numCols() << ")")
+                .str());
+    }
+    // Scales the matrix into the accuracy range of the approximant
+    const double norm = norm1(a);
+    const int s = norm > PADE_13_THETA ? (int)ceil(log2(norm / PADE_13_THETA)) : 0;
+    const Matrix x = a / ldexp(1.0, s);
+    const Matrix id = identity(n);
+    const Matrix x2 = x * x;
+    const Matrix x4 = x2 * x2;
+    const Matrix x6 = x4 * x2;
+    const double *b = PADE_13;
+    const Matrix u = x * (x6 * (x6 * b[13] + x4 * b[11] + x2 * b[9]) + x6 * b[7] + x4 * b[5] + x2 * b[3] + id * b[1]);
+    const Matrix v = x6 * (x6 * b[12] + x4 * b[10] + x2 * b[8]) + x6 * b[6] + x4 * b[4] + x2 * b[2] + id * b[0];
+    Matrix result = solve(v - u, v + u);
+    for (int i = 0; i < s; i++)
+    {
+        result = result * result;
+    }
+    return result;
+}
+
+const ComplexVect mx::multiply(const Matrix &a, const ComplexVect &v, const size_t numThreads)
+{
+    const size_t n = a.numRows();
+    const size_t m = a.numCols();
+    ComplexVect result(n, 0);
+    auto task = [&a, &v, &result, m](const size_t from, const size_t to)
+    {
+        for (size_t i = from; i < to; i++)
+        {
+            complex<double> sum = 0;
+            const complex<double> *row = a.cells().data() + i * m;
+            for (size_t j = 0; j < m; j++)
+            {
+                sum += row[j] * v[j];
+            }
+            result[i] = sum;
+        }
+    };
+    parallelFor(n, threadCount(numThreads, n, n * m), task);
+    return result;
+}
+
+const ComplexVect mx::expv(const complex<double> &t, const LinearOperator &a, const double norm, const ComplexVect &v)
+{
+    const size_t n = v.size();
+    const size_t m = min(KRYLOV_SIZE, n);
+    const size_t numSteps = max((size_t)1, (size_t)ceil(abs(t) * norm / KRYLOV_STEP_NORM));
+    const complex<double> dt = t / (double)numSteps;
+    ComplexVect w = v;
+    for (size_t step = 0; step < numSteps; step++)
+    {
+        const double beta = norm2(w);
+        if (beta == 0)
+        {
+            return w;
+        }
+        // Arnoldi basis by modified Gram-Schmidt
+        vector<ComplexVect> basis{w / beta};
+        ComplexVect h((m + 1) * m, 0);
+        size_t k = m;
+        for (size_t j = 0; j < m; j++)
+        {
+            ComplexVect p = a(basis[j]);
+            for (size_t i = 0; i <= j; i++)
+            {
+                const complex<double> hij = inner(basis[i], p);
+                h[i * m + j] = hij;
+                for (size_t l = 0; l < n; l++)
+                {
+                    p[l] -= hij * basis[i][l];
+                }
+            }
+            const double hn = norm2(p);
+            if (hn <= KRYLOV_BREAKDOWN * beta)
+            {
+                // The subspace is invariant
+                k = j + 1;
+                break;
+            }
+            h[(j + 1) * m + j] = hn;
+            if (j + 1 < m)
+            {
+                basis.push_back(p / hn);
+            }
+        }
+        // Exponential of the projected operator
+        ComplexVect hk(k * k);
+        for (size_t i = 0; i < k; i++)
+        {
+            for (size_t j = 0; j < k; j++)
+            {
+                hk[i * k + j] = h[i * m + j] * dt;
+            }
+        }
+        const Matrix e = expm(Matrix(k, k, hk));
+        ComplexVect next(n, 0);
+        for (size_t i = 0; i < k; i++)
+        {
+            const complex<double> f = beta * e.at(i, 0);
+            for (size_t l = 0; l < n; l++)
+            {
+                next[l] += f * basis[i][l];
+            }
+        }
+        w = next;
+    }
+    return w;
+}
+
+const ComplexVect mx::expv(const complex<double> &t, const Matrix &a, const ComplexVect &v)
+{
+    if (a.numRows() != v.size() || a.numCols() != v.size())
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected " << v.size() << "x" << v.size() << " matrix, got (" << a.numRows() << "x" << a.numCols() << ")")
+                .str());
+    }
+    return expv(t, [&a](const ComplexVect &x)
+                { return multiply(a, x); },
+                norm1(a), v);
+}
+
+const ComplexVect mx::expv(const complex<double> &t, const PauliSum &h, const ComplexVect &v)
+{
+    const size_t n = v.size();
+    if (n < 2 || (n & (n - 1)) != 0 || n < (1ULL << h.numQubits()))
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected state of at least " << h.numQubits() << " qubits, got " << n << " cells")
+                .str());
+    }
+    // The norm of the sum is bounded by the sum of the coefficients of the unitary strings
+    double norm = 0;
+    for (const auto &[c, string] : h.terms())
+    {
+        norm += abs(c);
+    }
+    return expv(t, [&h](const ComplexVect &x)
+                { return h.apply(x); },
+                norm, v);
+}
@@ -0,0 +1,364 @@
+#include <sstream>
+#include <algorithm>
+#include <numbers>
+#include <bit>
+
+#include "fourier.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+/**
+ * The number of qubits of cache blocked butterfly stages
+ */
+static const size_t FFT_BLOCK_QUBITS = 12;
+
+/**
+ * The number of cells of cache blocked butterfly stages (64KB)
+ */
+static const size_t FFT_BLOCK_SIZE = 1 << FFT_BLOCK_QUBITS;
+
+/**
+ * Returns the index with the reversed order of the low bits
+ * @param index the index
+ * @param numBits the number of bits
+ */
+static inline const uint64_t reverseBits(const uint64_t index, const size_t numBits)
+{
+    uint64_t result = 0;
+    for (size_t i = 0; i < numBits; i++)
+    {
+        result |= ((index >> i) & 1) << (numBits - 1 - i);
+    }
+    return result;
+}
+
+/**
+ * Applies the butterfly stages up to the span of block to the block
+ * @param a the block cells
+ * @param block the number of block cells
+ * @param m the number of transform cells
+ * @param twiddles the twiddle factors of transform
+ */
+static void blockStages(complex<double> *a, const size_t block, const size_t m, const ComplexVect &twiddles)
+{
+    for (size_t len = 2; len <= block; len <<= 1)
+    {
+        const size_t half = len / 2;
+        const size_t step = m / len;
+        for (size_t start = 0; start < block; start += len)
+        {
+            for (size_t j = 0; j < half; j++)
+            {
+                const complex<double> u = a[start + j];
+                const complex<double> v = a[start + j + half] * twiddles[j * step];
+                a[start + j] = u + v;
+                a[start + j + half] = u - v;
+            }
+        }
+    }
+}
+
+/**
+ * Applies the normalized fast Fourier transform to the contiguous cells
+ * @param a the cells
+ * @param k the number of qubits
+ * @param twiddles the twiddle factors of transform
+ * @param numThreads the number of threads
+ */
+static void fft(complex<double> *a, const size_t k, const ComplexVect &twiddles, const size_t numThreads)
+{
+    const size_t m = 1ULL << k;
+    const size_t threads = threadCount(numThreads, m, m);
+    const double scale = 1 / sqrt((double)m);
+    // Bit reversal permutation with normalization (the lower index of each pair owns the pair)
+    parallelFor(m, threads, [a, k, scale](const size_t from, const size_t to)
+                {
+        for (size_t i = from; i < to; i++)
+        {
+            const uint64_t j = reverseBits(i, k);
+            if (i < j)
+            {
+                const complex<double> tmp = a[i];
+                a[i] = a[j] * scale;
+                a[j] = tmp * scale;
+            }
+            else if (i == j)
+            {
+                a[i] *= scale;
+            }
+        } });
+    // Stages with span within the cache blocks
+    const size_t block = min(m, FFT_BLOCK_SIZE);
+    parallelFor(m / block, threads, [a, block, m, &twiddles](const size_t from, const size_t to)
+                {
+        for (size_t b = from; b < to; b++)
+        {
+            blockStages(a + b * block, block, m, twiddles);
+        } });
+    // Stages across the blocks
+    for (size_t len = block * 2; len <= m; len <<= 1)
+    {
+        const size_t half = len / 2;
+        const size_t step = m / len;
+        parallelFor(m / 2, threads, [a, len, half, step, &twiddles](const size_t from, const size_t to)
+                    {
+            for (size_t p = from; p < to; p++)
+            {
+                const size_t j = p % half;
+                const size_t i = (p / half) * len + j;
+                const complex<double> u = a[i];
+                const complex<double> v = a[i + half] * twiddles[j * step];
+                a[i] = u + v;
+                a[i + half] = u - v;
+            } });
+    }
+}
+
+/**
+ * Validates the transform qubits
+ * @param size the number of cells
+ * @param qubits the qubits
+ */
+static void validateQubits(const size_t size, const indices_t &qubits)
+{
+    validateBitMap(qubits);
+    for (const size_t bit : qubits)
+    {
+        if (size < (2ULL << bit))
+        {
+            throw invalid_argument(
+                (ostringstream() << "Expected state of at least " << (bit + 1) << " qubits, got " << size << " cells")
+                    .str());
+        }
+    }
+}
+
+void mx::fourier(complex<double> *cells, const size_t size, const indices_t &qubits, const bool inverse, const size_t numThreads)
+{
+    validateQubits(size, qubits);
+    const size_t k = qubits.size();
+    if (k == 0)
+    {
+        return;
+    }
+    const size_t m = 1ULL << k;
+    const double sign = inverse ? -1 : 1;
+    ComplexVect twiddles(m / 2);
+    for (size_t j = 0; j < m / 2; j++)
+    {
+        twiddles[j] = polar(1.0, sign * 2 * numbers::pi * j / m);
+    }
+    // Offsets of transform basis states
+    vector<uint64_t> offsets(m, 0);
+    bool contiguous = true;
+    for (size_t j = 0; j < k; j++)
+    {
+        contiguous = contiguous && qubits[j] == j;
+        for (size_t i = 0; i < m; i++)
+        {
+            if ((i >> j) & 1)
+            {
+                offsets[i] |= 1ULL << qubits[j];
+            }
+        }
+    }
+    indices_t fixed = qubits;
+    sort(fixed.begin(), fixed.end());
+    auto restOf = [&fixed](const uint64_t free)
+    {
+        uint64_t rest = free;
+        for (const size_t bit : fixed)
+        {
+            rest = ((rest >> bit) << (bit + 1)) | (rest & ((1ULL << bit) - 1));
+        }
+        return rest;
+    };
+    // Transforms the group of cells sharing the not transform qubits
+    auto transform = [cells, k, m, contiguous, &offsets, &twiddles](const uint64_t rest, ComplexVect &buffer, const size_t threads)
+    {
+        if (contiguous)
+        {
+            fft(cells + rest, k, twiddles, threads);
+            return;
+        }
+        for (size_t i = 0; i < m; i++)
+        {
+            buffer[i] = cells[rest | offsets[i]];
+        }
+        fft(buffer.data(), k, twiddles, threads);
+        for (size_t i = 0; i < m; i++)
+        {
+            cells[rest | offsets[i]] = buffer[i];
+        }
+    };
+    const size_t count = size >> k;
+    const size_t threads = threadCount(numThreads, size, size);
+    if (count >= threads)
+    {
+        // Parallel groups with serial transforms
+        parallelFor(count, threads, [&restOf, &transform, contiguous, m](const size_t from, const size_t to)
+                    {
+            ComplexVect buffer(contiguous ? 0 : m);
+            for (size_t free = from; free < to; free++)
+            {
+                transform(restOf(free), buffer, 1);
+            } });
+    }
+    else
+    {
+        // Serial groups with parallel transforms
+        ComplexVect buffer(contiguous ? 0 : m);
+        for (size_t free = 0; free < count; free++)
+        {
+            transform(restOf(free), buffer, threads);
+        }
+    }
+}
+
+const Matrix mx::fourierMatrix(const size_t numQubits, const bool inverse)
+{
+    const size_t m = 1ULL << numQubits;
+    const double sign = inverse ? -1 : 1;
+    const double scale = 1 / sqrt((double)m);
+    ComplexVect cells(m * m);
+    for (size_t y = 0; y < m; y++)
+    {
+        for (size_t x = 0; x < m; x++)
+        {
+            cells[Matrix::indexOf(m, y, x)] = polar(scale, sign * 2 * numbers::pi * ((x * y) % m) / m);
+        }
+    }
+    return Matrix(m, m, cells);
+}
+
+/**
+ * Applies the radix-4 Hadamard butterflies of two qubits to the rows of cells.
+ * Each row is the contiguous run of cells below the lower qubit
+ * @param a the cells
+ * @param q0 the lower qubit
+ * @param q1 the higher qubit
+ * @param from the first row
+ * @param to the row after the last
+ */
+static void radix4(complex<double> *a, const size_t q0, const size_t q1, const size_t from, const size_t to)
+{
+    const size_t s0 = 1ULL << q0;
+    const size_t s1 = 1ULL << q1;
+    for (size_t r = from; r < to; r++)
+    {
+        // Inserts the cleared qubit bits
+        uint64_t base = r << (q0 + 1);
+        base = ((base >> q1) << (q1 + 1)) | (base & (s1 - 1));
+        complex<double> *x0 = a + base;
+        complex<double> *x1 = x0 + s0;
+        complex<double> *x2 = x0 + s1;
+        complex<double> *x3 = x2 + s0;
+        for (size_t j = 0; j < s0; j++)
+        {
+            const complex<double> p = x0[j] + x1[j];
+            const complex<double> m = x0[j] - x1[j];
+            const complex<double> q = x2[j] + x3[j];
+            const complex<double> n = x2[j] - x3[j];
+            x0[j] = (p + q) * 0.5;
+            x1[j] = (m + n) * 0.5;
+            x2[j] = (p - q) * 0.5;
+            x3[j] = (m - n) * 0.5;
+        }
+    }
+}
+
+/**
+ * Applies the radix-2 Hadamard butterflies of a qubit to the rows of cells
+ * @param a the cells
+ * @param q the qubit
+ * @param from the first row
+ * @param to the row after the last
+ */
+static void radix2(complex<double> *a, const size_t q, const size_t from, const size_t to)
+{
+    const size_t s = 1ULL << q;
+    const double scale = 1 / sqrt(2.0);
+    for (size_t r = from; r < to; r++)
+    {
+        complex<double> *x0 = a + (r << (q + 1));
+        complex<double> *x1 = x0 + s;
+        for (size_t j = 0; j < s; j++)
+        {
+            const complex<double> u = x0[j];
+            const complex<double> v = x1[j];
+            x0[j] = (u + v) * scale;
+            x1[j] = (u - v) * scale;
+        }
+    }
+}
+
+/**
+ * Applies the Hadamard butterflies of the sorted qubits by pairs
+ * @param a the cells
+ * @param size the number of cells
+ * @param qubits the sorted qubits
+ * @param numThreads the number of threads
+ */
+static void hadamardPasses(complex<double> *a, const size_t size, const indices_t &qubits, const size_t numThreads)
+{
+    for (size_t i = 0; i < qubits.size(); i += 2)
+    {
+        if (i + 1 < qubits.size())
+        {
+            const size_t q0 = qubits[i];
+            const size_t q1 = qubits[i + 1];
+            parallelFor(size >> (q0 + 2), numThreads, [a, q0, q1](const size_t from, const size_t to)
+                        { radix4(a, q0, q1, from, to); });
+        }
+        else
+        {
+            const size_t q = qubits[i];
+            parallelFor(size >> (q + 1), numThreads, [a, q](const size_t from, const size_t to)
+                        { radix2(a, q, from, to); });
+        }
+    }
+}
+
+void mx::hadamard(complex<double> *cells, const size_t size, const indices_t &qubits, const size_t numThreads)
+{
+    validateQubits(size, qubits);
+    indices_t low;
+    indices_t high;
+    for (const size_t bit : qubits)
+    {
+        (bit < FFT_BLOCK_QUBITS ? low : high).push_back(bit);
+    }
+    sort(low.begin(), low.end());
+    sort(high.begin(), high.end());
+    const size_t threads = threadCount(numThreads, size, size);
+    // Passes of the low qubits within the cache blocks
+    if (!low.empty())
+    {
+        const size_t block = min(size, FFT_BLOCK_SIZE);
+        parallelFor(size / block, threads, [cells, block, &low](const size_t from, const size_t to)
+                    {
+            for (size_t b = from; b < to; b++)
+            {
+                hadamardPasses(cells + b * block, block, low, 1);
+            } });
+    }
+    // Passes of the high qubits across the blocks
+    hadamardPasses(cells, size, high, threads);
+}
+
+const Matrix mx::hadamardMatrix(const size_t numQubits)
+{
+    const size_t m = 1ULL << numQubits;
+    const double scale = 1 / sqrt((double)m);
+    ComplexVect cells(m * m);
+    for (size_t i = 0; i < m; i++)
+    {
+        for (size_t j = 0; j < m; j++)
+        {
+            cells[Matrix::indexOf(m, i, j)] = (popcount(i & j) & 1) != 0 ? -scale : scale;
+        }
+    }
+    return Matrix(m, m, cells);
+}
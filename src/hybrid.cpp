@@ -0,0 +1,287 @@
+#include <sstream>
+#include <atomic>
+
+#include "hybrid.h"
+#include "sparseState.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+/**
+ * The maximum number of paths
+ */
+static const size_t MAX_PATHS = 1ULL << 40;
+
+/**
+ * Returns the gate basis state composed by the low and high gate qubit states
+ * @param low the state of low gate qubits
+ * @param lowPos the gate qubits in the low half
+ * @param high the state of high gate qubits
+ * @param highPos the gate qubits in the high half
+ */
+static const size_t compose(const size_t low, const indices_t &lowPos, const size_t high, const indices_t &highPos)
+{
+    size_t result = 0;
+    for (size_t i = 0; i < lowPos.size(); i++)
+    {
+        result |= ((low >> i) & 1) << lowPos[i];
+    }
+    for (size_t i = 0; i < highPos.size(); i++)
+    {
+        result |= ((high >> i) & 1) << highPos[i];
+    }
+    return result;
+}
+
+/**
+ * Returns the Schmidt terms expanding the gate on the basis operators |r><c| of the first side.
+ * Each term is the pair of the projector on the first side and the gate block on the second side
+ * @param base the gate base matrix
+ * @param firstPos the gate qubits of the first side
+ * @param secondPos the gate qubits of the second side
+ */
+static const vector<pair<Matrix, Matrix>> expand(const Matrix &base, const indices_t &firstPos, const indices_t &secondPos)
+{
+    const size_t m = base.numRows();
+    const size_t m1 = 1ULL << firstPos.size();
+    const size_t m2 = 1ULL << secondPos.size();
+    vector<pair<Matrix, Matrix>> result;
+    for (size_t r1 = 0; r1 < m1; r1++)
+    {
+        for (size_t c1 = 0; c1 < m1; c1++)
+        {
+            ComplexVect block(m2 * m2, 0);
+            bool zero = true;
+            for (size_t r2 = 0; r2 < m2; r2++)
+            {
+                for (size_t c2 = 0; c2 < m2; c2++)
+                {
+                    const complex<double> value = base.cells()[compose(r1, firstPos, r2, secondPos) * m + compose(c1, firstPos, c2, secondPos)];
+                    block[r2 * m2 + c2] = value;
+                    zero = zero && value == 0.0;
+                }
+            }
+            if (!zero)
+            {
+                ComplexVect projector(m1 * m1, 0);
+                projector[r1 * m1 + c1] = 1;
+                result.push_back({Matrix(m1, m1, projector), Matrix(m2, m2, block)});
+            }
+        }
+    }
+    return result;
+}
+
+HybridSimulator::HybridSimulator(const Circuit &circuit, const uint64_t in, const size_t cut, const size_t numThreads)
+    : _numQubits(max(circuit.numQubits(), numBitsByState(in))), _cut(cut), _in(in), _numThreads(numThreads)
+{
+    if (cut < 1 || cut >= _numQubits)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected cut in range 1..." << (_numQubits - 1) << ", got (" << cut << ")")
+                .str());
+    }
+    if (max(cut, _numQubits - cut) > MAX_DENSE_QUBITS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Half register too large: " << max(cut, _numQubits - cut) << " qubits")
+                .str());
+    }
+    for (const Gate &gate : circuit.gates())
+    {
+        addGate(gate);
+    }
+    if (numPaths() > MAX_PATHS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Too many paths crossing the cut: " << numPaths())
+                .str());
+    }
+}
+
+void HybridSimulator::addGate(const Gate &gate)
+{
+    if (!gate.isDense())
+    {
+        addGate(gate.expand());
+        return;
+    }
+    const indices_t &bits = gate.bits();
+    indices_t lowPos;
+    indices_t highPos;
+    indices_t lowBits;
+    indices_t highBits;
+    for (size_t i = 0; i < bits.size(); i++)
+    {
+        if (bits[i] < _cut)
+        {
+            lowPos.push_back(i);
+            lowBits.push_back(bits[i]);
+        }
+        else
+        {
+            highPos.push_back(i);
+            highBits.push_back(bits[i] - _cut);
+        }
+    }
+    vector<Term> terms;
+    if (highPos.empty() || lowPos.empty())
+    {
+        // Local gates are merged into the previous single term operation
+        if (!_operations.empty() && _operations.back().size() == 1)
+        {
+            terms = _operations.back();
+            _operations.pop_back();
+        }
+        else
+        {
+            terms.push_back(Term{});
+        }
+        if (highPos.empty())
+        {
+            terms[0].low.push_back(gate);
+        }
+        else
+        {
+            terms[0].high.push_back(Gate(gate.name(), gate.base(), highBits));
+        }
+    }
+    else
+    {
+        // Expands on the side with less terms
+        const auto byLow = expand(gate.base(), lowPos, highPos);
+        const auto byHigh = expand(gate.base(), highPos, lowPos);
+        if (byLow.size() <= byHigh.size())
+        {
+            for (const auto &[projector, block] : byLow)
+            {
+                terms.push_back(Term{{Gate("P", projector, lowBits)}, {Gate(gate.name(), block, highBits)}});
+            }
+        }
+        else
+        {
+            for (const auto &[projector, block] : byHigh)
+            {
+                terms.push_back(Term{{Gate(gate.name(), block, lowBits)}, {Gate("P", projector, highBits)}});
+            }
+        }
+    }
+    _operations.push_back(terms);
+}
+
+const size_t HybridSimulator::numPaths(void) const
+{
+    size_t result = 1;
+    for (const auto &terms : _operations)
+    {
+        result *= terms.size();
+        if (result > MAX_PATHS)
+        {
+            return result;
+        }
+    }
+    return result;
+}
+
+const size_t HybridSimulator::numWorkers(void) const
+{
+    return threadCount(_numThreads, numPaths());
+}
+
+void HybridSimulator::run(const function<void(const size_t worker, const ComplexVect &low, const ComplexVect &high)> &consumer) const
+{
+    const size_t paths = numPaths();
+    atomic<size_t> next(0);
+    const auto task = [this, paths, &next, &consumer](const size_t worker)
+    {
+        for (size_t path = next++; path < paths; path = next++)
+        {
+            ComplexVect low(1ULL << _cut, 0);
+            ComplexVect high(1ULL << (_numQubits - _cut), 0);
+            low[_in & ((1ULL << _cut) - 1)] = 1;
+            high[_in >> _cut] = 1;
+            // Decodes the term of each operation from the path index
+            size_t rest = path;
+            for (const auto &terms : _operations)
+            {
+                const Term &term = terms[rest % terms.size()];
+                rest /= terms.size();
+                for (const Gate &gate : term.low)
+                {
+                    gate.apply(low);
+                }
+                for (const Gate &gate : term.high)
+                {
+                    gate.apply(high);
+                }
+            }
+            consumer(worker, low, high);
+        }
+    };
+    // One range of a single worker for each thread
+    const size_t workers = numWorkers();
+    parallelFor(workers, workers, [&task](const size_t from, const size_t to)
+                {
+        for (size_t worker = from; worker < to; worker++)
+        {
+            task(worker);
+        } });
+}
+
+const vector<complex<double>> HybridSimulator::amplitudes(const vector<uint64_t> &outs) const
+{
+    const uint64_t lowMask = (1ULL << _cut) - 1;
+    vector<vector<complex<double>>> sums(numWorkers(), vector<complex<double>>(outs.size(), 0));
+    run([this, &outs, &sums, lowMask](const size_t worker, const ComplexVect &low, const ComplexVect &high)
+        {
+            for (size_t i = 0; i < outs.size(); i++)
+            {
+                if ((outs[i] >> _numQubits) == 0)
+                {
+                    sums[worker][i] += low[outs[i] & lowMask] * high[outs[i] >> _cut];
+                }
+            } });
+    vector<complex<double>> result(outs.size(), 0);
+    for (const auto &sum : sums)
+    {
+        for (size_t i = 0; i < result.size(); i++)
+        {
+            result[i] += sum[i];
+        }
+    }
+    return result;
+}
+
+const StatePtr HybridSimulator::state(void) const
+{
+    vector<SparseState> sums(numWorkers(), SparseState(_numQubits));
+    run([this, &sums](const size_t worker, const ComplexVect &low, const ComplexVect &high)
+        {
+            for (uint64_t j = 0; j < high.size(); j++)
+            {
+                if (high[j] != 0.0)
+                {
+                    for (uint64_t i = 0; i < low.size(); i++)
+                    {
+                        if (low[i] != 0.0)
+                        {
+                            sums[worker].add(i | (j << _cut), low[i] * high[j]);
+                        }
+                    }
+                }
+            } });
+    for (size_t i = 1; i < sums.size(); i++)
+    {
+        for (const auto &[index, value] : sums[i].amplitudes())
+        {
+            sums[0].add(index, value);
+        }
+    }
+    shared_ptr<SparseState> result = make_shared<SparseState>(_numQubits);
+    for (const auto &[index, value] : sums[0].amplitudes())
+    {
+        result->add(index, value);
+    }
+    return result;
+}
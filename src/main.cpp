@@ -5,23 +5,49 @@
 #include <regex>
 #include <unistd.h>
 #include <getopt.h>
+#include <sys/wait.h>
 
 #include "version.h"
 #include "tokenizer.h"
 #include "compiler.h"
 #include "qusyntax.h"
 #include "values.h"
+#include "transport.h"
 
 using namespace std;
 using namespace qc;
+using namespace mx;
+
+/**
+ * The default base port of TCP workers
+ */
+static const int DEFAULT_PORT = 5700;
+
+/**
+ * The command arguments
+ */
+struct Arguments
+{
+     bool exit;
+     bool dump;
+     optional<string> file;
+     size_t workers;
+     optional<size_t> rank;
+     vector<string> hosts;
+     int port;
+};
 
 static const struct option options[] = {
     {"dump", no_argument, 0, 'd'},
     {"file", required_argument, 0, 'f'},
     {"version", no_argument, 0, 'v'},
     {"help", no_argument, 0, 'h'},
+    {"workers", required_argument, 0, 'w'},
+    {"rank", required_argument, 0, 'r'},
+    {"hosts", required_argument, 0, 'H'},
+    {"port", required_argument, 0, 'p'},
     {0, 0, 0, 0}};
-static char const *optString = "df:vh";
+static char const *optString = "df:vhw:r:H:p:";
 
 static void usage(const char *prog)
 {
@@ -35,6 +61,10 @@ static void usage(const char *prog)
           << "  -f --file <file>        Specify qu source file" << endl
           << "  -h --help               Print usage" << endl
           << "  -v --version            Print version" << endl
+          << "  -w --workers <n>        Spawn n local workers sharing the sharded states" << endl
+          << "  -r --rank <rank>        Specify the rank of TCP worker" << endl
+          << "  -H --hosts <h0,h1,...>  Specify the hosts of TCP workers" << endl
+          << "  -p --port <port>        Specify the base port of TCP workers (default " << DEFAULT_PORT << ")" << endl
           << endl;
 }
 
@@ -43,15 +73,29 @@ static void printVersion(void)
      cout << VERSION << endl;
 }
 
+/**
+ * Returns the comma separated values
+ * @param text the text
+ */
+static const vector<string> split(const string &text)
+{
+     vector<string> result;
+     stringstream stream(text);
+     string item;
+     while (getline(stream, item, ','))
+     {
+          result.push_back(item);
+     }
+     return result;
+}
+
 /**
  * Parse command arguments
  */
-static const tuple<bool, bool, optional<string>> parseArgs(int argc, char **argv)
+static const Arguments parseArgs(int argc, char **argv)
 {
-     optional<string> file = nullopt;
+     Arguments args{false, false, nullopt, 1, nullopt, {}, DEFAULT_PORT};
      int optIndex = 0;
-     bool exit = false;
-     bool dump = false;
      for (;;)
      {
           int option = getopt_long(argc, argv, optString, options, &optIndex);
@@ -63,52 +107,122 @@ static const tuple<bool, bool, optional<string>> parseArgs(int argc, char **argv
           {
           case '?':
                // Error
-               exit = true;
+               args.exit = true;
                break;
           case 'd':
-               dump = true;
+               args.dump = true;
                break;
           case 'f':
-               file = optional(optarg);
+               args.file = optional(optarg);
                break;
           case 'h':
                usage(argv[0]);
-               exit = true;
+               args.exit = true;
                break;
           case 'v':
                printVersion();
-               exit = true;
+               args.exit = true;
+               break;
+          case 'w':
+               args.workers = max(1, atoi(optarg));
+               if ((args.workers & (args.workers - 1)) != 0)
+               {
+                    // The sharded states split the register by the highest qubits
+                    cerr << "Expected workers power of 2, got (" << optarg << ")" << endl;
+                    args.exit = true;
+               }
+               break;
+          case 'r':
+               args.rank = optional(max(0, atoi(optarg)));
+               break;
+          case 'H':
+               args.hosts = split(optarg);
+               break;
+          case 'p':
+               args.port = atoi(optarg);
                break;
           default:
                cerr << "Unmanaged option " << (char)option << endl;
-               exit = true;
+               args.exit = true;
+               break;
+          }
+     }
+     return args;
+}
+
+/**
+ * Spawns the local workers connected by Unix sockets and returns the rank of the process
+ * (the launcher process is the rank 0)
+ * @param workers the number of workers
+ * @param children the process ids of the spawned workers
+ */
+static const size_t spawnWorkers(const size_t workers, vector<pid_t> &children)
+{
+     const vector<vector<int>> mesh = SocketTransport::mesh(workers);
+     size_t rank = 0;
+     for (size_t i = 1; i < workers; i++)
+     {
+          const pid_t pid = fork();
+          if (pid < 0)
+          {
+               throw runtime_error("Worker spawn failed");
+          }
+          if (pid == 0)
+          {
+               rank = i;
+               children.clear();
                break;
           }
+          children.push_back(pid);
+     }
+     // Keeps only the sockets of this rank
+     for (size_t i = 0; i < workers; i++)
+     {
+          if (i != rank)
+          {
+               for (const int fd : mesh[i])
+               {
+                    if (fd >= 0)
+                    {
+                         close(fd);
+                    }
+               }
+          }
      }
-     return {exit, dump, file};
+     setDefaultTransport(make_shared<SocketTransport>(rank, mesh[rank]));
+     return rank;
 }
 
 int main(int argc, char **argv)
 {
-     bool exit;
-     bool dump;
-     optional<string> file;
-     optional<string> gatesArg;
-     tie(exit, dump, file) = parseArgs(argc, argv);
+     const Arguments args = parseArgs(argc, argv);
 
-     if (exit)
+     if (args.exit)
      {
           return 0;
      }
 
-     if (file)
+     // Joins the workers sharing the sharded states
+     size_t rank = 0;
+     vector<pid_t> children;
+     if (args.rank)
+     {
+          rank = args.rank.value();
+          setDefaultTransport(SocketTransport::tcp(rank, args.hosts, args.port));
+     }
+     else if (args.workers > 1)
      {
-          auto in = ifstream(file.value());
+          rank = spawnWorkers(args.workers, children);
+     }
+     if (rank != 0)
+     {
+          // Only the rank 0 prints the results
+          cout.setstate(ios::failbit);
      }
 
      cout << "Processing ..." << endl;
      cout.flush();
-     ifstream source(file.value_or("qucomp.qu"));
+     ifstream source(args.file.value_or("qucomp.qu"));
 
      Tokenizer tokenizer(source);
      tokenizer.open();
@@ -128,7 +242,7 @@ int main(int argc, char **argv)
                v->source().write(cout, "value: " + to_string(*v));
           }
 
-          if (dump)
+          if (args.dump)
           {
                for (const auto &[id, v] : processor.variables())
                {
@@ -141,7 +255,14 @@ int main(int argc, char **argv)
      }
      catch (QuSourceException ex)
      {
-          cerr << ex << endl;
+          if (rank == 0)
+          {
+               cerr << ex << endl;
+          }
+     }
+     for (const pid_t pid : children)
+     {
+          waitpid(pid, NULL, 0);
      }
      return 0;
 }
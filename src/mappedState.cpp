@@ -0,0 +1,291 @@
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include "mappedState.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+/**
+ * Throws the runtime error with the system error message
+ * @param message the message
+ */
+static void systemError(const string &message)
+{
+    throw runtime_error(message + ": " + strerror(errno));
+}
+
+/**
+ * Returns the number of bytes of the state
+ * @param numQubits the number of qubits
+ */
+static const size_t stateBytes(const size_t numQubits)
+{
+    return (1ULL << numQubits) * sizeof(complex<double>);
+}
+
+MappedState::MappedState(const Matrix &ket, const size_t chunkQubits, const string &directory)
+    : _directory(directory), _chunkQubits(max<size_t>(chunkQubits, 1)), _fd(-1), _cells(NULL)
+{
+    if (ket.numCols() != 1)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected ket, got (" << ket.numRows() << "x" << ket.numCols() << ")")
+                .str());
+    }
+    open();
+    map(max<size_t>(numBitsByState(ket.numRows() - 1), 1));
+    copy(ket.cells().begin(), ket.cells().end(), _cells);
+}
+
+MappedState::MappedState(const MappedState &other)
+    : _directory(other._directory), _chunkQubits(other._chunkQubits), _fd(-1), _cells(NULL)
+{
+    open();
+    map(other._numQubits);
+    const size_t chunk = 1ULL << min(_chunkQubits, _numQubits);
+    for (size_t i = 0; i < (1ULL << _numQubits); i += chunk)
+    {
+        memcpy(_cells + i, other._cells + i, chunk * sizeof(complex<double>));
+    }
+}
+
+MappedState::~MappedState()
+{
+    unmap();
+    if (_fd >= 0)
+    {
+        close(_fd);
+    }
+}
+
+void MappedState::open(void)
+{
+    string directory = _directory;
+    if (directory.empty())
+    {
+        const char *tmp = getenv("TMPDIR");
+        directory = tmp != NULL ? tmp : "/tmp";
+    }
+    string path = directory + "/qucomp-XXXXXX";
+    _fd = mkstemp(path.data());
+    if (_fd < 0)
+    {
+        systemError("Mapped file creation failed");
+    }
+    // The file is removed at close
+    unlink(path.c_str());
+}
+
+void MappedState::map(const size_t numQubits)
+{
+    if (numQubits > MAX_MAPPED_QUBITS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "State too large: " << numQubits << " qubits")
+                .str());
+    }
+    unmap();
+    // The extended file is filled by zeros
+    if (ftruncate(_fd, stateBytes(numQubits)) < 0)
+    {
+        systemError("Mapped file resize failed");
+    }
+    void *cells = mmap(NULL, stateBytes(numQubits), PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (cells == MAP_FAILED)
+    {
+        systemError("Mapped file mapping failed");
+    }
+    madvise(cells, stateBytes(numQubits), MADV_SEQUENTIAL);
+    _cells = (complex<double> *)cells;
+    _numQubits = numQubits;
+}
+
+void MappedState::unmap(void)
+{
+    if (_cells != NULL)
+    {
+        munmap(_cells, stateBytes(_numQubits));
+        _cells = NULL;
+    }
+}
+
+MappedState &MappedState::apply(const Gate &gate)
+{
+    if (gate.numQubits() > _numQubits)
+    {
+        map(gate.numQubits());
+    }
+    const size_t c = min(_chunkQubits, _numQubits);
+    const size_t chunkSize = 1ULL << c;
+    const size_t numChunks = 1ULL << (_numQubits - c);
+    // Maps the gate qubits higher than the chunk qubits to the chunk group qubits,
+    // the high controls select the chunks without buffering
+    indices_t bits = gate.bits();
+    indices_t controls;
+    indices_t high;
+    uint64_t controlMask = 0;
+    for (const size_t bit : gate.controls())
+    {
+        if (bit >= c)
+        {
+            controlMask |= 1ULL << (bit - c);
+        }
+        else
+        {
+            controls.push_back(bit);
+        }
+    }
+    for (size_t &bit : bits)
+    {
+        if (bit >= c)
+        {
+            high.push_back(bit - c);
+            bit = c + high.size() - 1;
+        }
+    }
+    if (high.empty())
+    {
+        const Gate local = gate.remap(bits, controls);
+        for (size_t chunk = 0; chunk < numChunks; chunk++)
+        {
+            if ((chunk & controlMask) == controlMask)
+            {
+                local.apply(_cells + chunk * chunkSize, chunkSize);
+            }
+        }
+        return *this;
+    }
+    if (gate.kernel() == GateKernel::hadamard || gate.kernel() == GateKernel::fourier || gate.kernel() == GateKernel::inverseFourier)
+    {
+        // The transforms stream at most 4 chunks at a time by their decomposed gates
+        for (const Gate &g : gate.decomposed())
+        {
+            apply(g);
+        }
+        return *this;
+    }
+    if (gate.kernel() == GateKernel::oracle)
+    {
+        // Negates the marked cells sweeping the chunks in place
+        const indices_t qubits = gate.qubits();
+        const size_t k = gate.bits().size();
+        const uint64_t oracleControls = ((1ULL << gate.controls().size()) - 1) << k;
+        for (uint64_t index = 0; index < (1ULL << _numQubits); index++)
+        {
+            uint64_t x = 0;
+            for (size_t i = 0; i < qubits.size(); i++)
+            {
+                x |= ((index >> qubits[i]) & 1) << i;
+            }
+            if ((x & oracleControls) == oracleControls && binary_search(gate.marked().begin(), gate.marked().end(), x & ~oracleControls))
+            {
+                _cells[index] = -_cells[index];
+            }
+        }
+        return *this;
+    }
+    // Streams the groups of chunks through the buffer
+    const size_t m = 1ULL << high.size();
+    uint64_t mask = 0;
+    vector<uint64_t> offsets(m, 0);
+    for (size_t j = 0; j < high.size(); j++)
+    {
+        mask |= 1ULL << high[j];
+    }
+    for (size_t i = 0; i < m; i++)
+    {
+        for (size_t j = 0; j < high.size(); j++)
+        {
+            if ((i >> j) & 1)
+            {
+                offsets[i] |= 1ULL << high[j];
+            }
+        }
+    }
+    const Gate local = gate.remap(bits, controls);
+    ComplexVect buffer(m * chunkSize);
+    for (size_t chunk = 0; chunk < numChunks; chunk++)
+    {
+        if ((chunk & mask) != 0 || (chunk & controlMask) != controlMask)
+        {
+            continue;
+        }
+        for (size_t i = 0; i < m; i++)
+        {
+            memcpy(buffer.data() + i * chunkSize, _cells + (chunk | offsets[i]) * chunkSize, chunkSize * sizeof(complex<double>));
+        }
+        local.apply(buffer);
+        for (size_t i = 0; i < m; i++)
+        {
+            memcpy(_cells + (chunk | offsets[i]) * chunkSize, buffer.data() + i * chunkSize, chunkSize * sizeof(complex<double>));
+        }
+    }
+    return *this;
+}
+
+MappedState &MappedState::apply(const Circuit &circuit)
+{
+    for (const Gate &gate : circuit.gates())
+    {
+        apply(gate);
+    }
+    return *this;
+}
+
+const complex<double> MappedState::at(const uint64_t index) const
+{
+    return (index >> _numQubits) == 0 ? _cells[index] : 0;
+}
+
+const StatePtr MappedState::project(const size_t qubit, const int outcome, const double probability) const
+{
+    const uint64_t mask = 1ULL << qubit;
+    const uint64_t kept = outcome == 1 ? mask : 0;
+    const double scale = 1 / sqrt(probability);
+    shared_ptr<MappedState> result = make_shared<MappedState>(*this);
+    for (uint64_t i = 0; i < (1ULL << _numQubits); i++)
+    {
+        result->_cells[i] = (i & mask) == kept ? result->_cells[i] * scale : 0;
+    }
+    return result;
+}
+
+const vector<pair<uint64_t, complex<double>>> MappedState::amplitudes(void) const
+{
+    vector<pair<uint64_t, complex<double>>> result;
+    for (uint64_t i = 0; i < (1ULL << _numQubits); i++)
+    {
+        if (_cells[i] != 0.0)
+        {
+            result.push_back({i, _cells[i]});
+        }
+    }
+    return result;
+}
+
+void MappedState::forEach(const function<void(const uint64_t, const complex<double> &)> &f) const
+{
+    for (uint64_t i = 0; i < (1ULL << _numQubits); i++)
+    {
+        if (_cells[i] != 0.0)
+        {
+            f(i, _cells[i]);
+        }
+    }
+}
+
+const StatePtr MappedState::transform(const Circuit &circuit) const
+{
+    shared_ptr<MappedState> result = make_shared<MappedState>(*this);
+    result->apply(circuit);
+    return result;
+}
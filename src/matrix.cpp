@@ -31,6 +31,14 @@ Matrix::Matrix(const size_t numRows, const size_t numCols, const vu::ComplexVect
     }
 }
 
+Matrix &Matrix::operator=(const Matrix &a)
+{
+    _numRows = a._numRows;
+    _numCols = a._numCols;
+    _cells = a._cells;
+    return *this;
+}
+
 const complex<double> &Matrix::at(const size_t i, const size_t j) const
 {
     validateIndices(i, j);
@@ -47,9 +55,41 @@ void Matrix::validateIndices(const size_t i, const size_t j) const
     }
 }
 
+const Matrix Matrix::power(const uint64_t exponent) const
+{
+    if (_numRows != _numCols)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected square matrix, got (" << _numRows << "x" << _numCols << ")")
+                .str());
+    }
+    Matrix result = identity(_numRows);
+    Matrix square = *this;
+    for (uint64_t k = exponent; k > 0; k >>= 1)
+    {
+        if (k & 1)
+        {
+            result = result * square;
+        }
+        if (k > 1)
+        {
+            square = square * square;
+        }
+    }
+    return result;
+}
+
 const Matrix Matrix::transpose(void) const
 {
-    return Matrix(_numCols, _numRows, _cells);
+    ComplexVect cells(_cells.size());
+    for (size_t i = 0; i < _numRows; i++)
+    {
+        for (size_t j = 0; j < _numCols; j++)
+        {
+            cells[indexOf(_numRows, j, i)] = _cells[unsafeIndexOf(i, j)];
+        }
+    }
+    return Matrix(_numCols, _numRows, cells);
 }
 
 const Matrix Matrix::conj(void) const
@@ -223,7 +263,7 @@ const Matrix Matrix::cross(const Matrix &right) const
  *
  * @param bitMap the bit map
  */
-static void validateBitMap(const indices_t &bitMap)
+void mx::validateBitMap(const indices_t &bitMap)
 {
     for (size_t i = 0; i < bitMap.size(); i++)
     {
@@ -486,14 +526,14 @@ const Matrix mx::I(const size_t bit)
     return mx::identity(n);
 }
 
-static const Matrix X_GATE(2, 2, {0, 1, 1, 0});
+const Matrix mx::X_GATE(2, 2, {0, 1, 1, 0});
 
 const Matrix mx::X(const size_t bit)
 {
     return createGate(X_GATE, {bit});
 }
 
-static const Matrix Y_GATE(2, 2,
+const Matrix mx::Y_GATE(2, 2,
                            {0, complex<double>{0, -1},
                             1i, 0});
 
@@ -502,7 +542,7 @@ const Matrix mx::Y(const size_t bit)
     return createGate(Y_GATE, {bit});
 }
 
-static const Matrix Z_GATE(2, 2,
+const Matrix mx::Z_GATE(2, 2,
                            {1, 0,
                             0, -1});
 
@@ -511,7 +551,7 @@ const Matrix mx::Z(const size_t bit)
     return createGate(Z_GATE, {bit});
 }
 
-static const Matrix H_GATE(2, 2,
+const Matrix mx::H_GATE(2, 2,
                            {HALF_SQRT2, HALF_SQRT2,
                             HALF_SQRT2, -HALF_SQRT2});
 
@@ -520,7 +560,7 @@ const Matrix mx::H(const size_t bit)
     return createGate(H_GATE, {bit});
 }
 
-static const Matrix S_GATE(2, 2,
+const Matrix mx::S_GATE(2, 2,
                            {1, 0,
                             0, 1i});
 
@@ -529,7 +569,7 @@ const Matrix mx::S(const size_t bit)
     return createGate(S_GATE, {bit});
 }
 
-static const Matrix T_GATE(2, 2,
+const Matrix mx::T_GATE(2, 2,
                            {1, 0, 0, {HALF_SQRT2, HALF_SQRT2}});
 
 const Matrix mx::T(const size_t bit)
@@ -537,7 +577,7 @@ const Matrix mx::T(const size_t bit)
     return createGate(T_GATE, {bit});
 }
 
-static const Matrix CNOT_GATE(4, 4,
+const Matrix mx::CNOT_GATE(4, 4,
                               {1, 0, 0, 0,
                                0, 1, 0, 0,
                                0, 0, 0, 1,
@@ -548,7 +588,7 @@ const Matrix mx::CNOT(const size_t data, const size_t control)
     return createGate(CNOT_GATE, {data, control});
 }
 
-static const Matrix SWAP_GATE(4, 4,
+const Matrix mx::SWAP_GATE(4, 4,
                               {1, 0, 0, 0,
                                0, 0, 1, 0,
                                0, 1, 0, 0,
@@ -591,7 +631,7 @@ const Matrix mx::qubit1(const size_t index, const size_t numQubits)
     return Matrix(nStates, nStates, cells);
 }
 
-static const Matrix CCNOT_GATE(permute({0, 1, 2, 3, 4, 5, 7, 6}));
+const Matrix mx::CCNOT_GATE(permute({0, 1, 2, 3, 4, 5, 7, 6}));
 
 const Matrix mx::CCNOT(const size_t data, const size_t control0, const size_t control1)
 {
@@ -10,6 +10,31 @@ using namespace std;
 using namespace qc;
 using namespace mx;
 
+/**
+ * Returns the result of function applied to the matrix of value,
+ * the circuit and state values are converted to dense matrix
+ *
+ * @param context the source context
+ * @param value the value convertible to matrix
+ * @param f the function
+ */
+static const Value *withMatrix(const SourceContext &context, const Value &value, const function<const Value *(const Matrix &)> &f)
+{
+    if (value.type() == ValueType::matrixValueType)
+    {
+        return f(((const MatrixValue *)&value)->value());
+    }
+    try
+    {
+        const Matrix matrix = matrixOf(value);
+        return f(matrix);
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
 ChainUnaryOperator::~ChainUnaryOperator()
 {
     if (_other)
@@ -33,6 +58,16 @@ ChainUnaryOperator *ChainUnaryOperator::mapMatrix(const MatrixMapperFunction &ma
     return new UnaryMatrixOperator(mapper, this);
 }
 
+ChainUnaryOperator *ChainUnaryOperator::mapCircuit(const CircuitMapperFunction &mapper) const
+{
+    return new UnaryCircuitOperator(mapper, this);
+}
+
+ChainUnaryOperator *ChainUnaryOperator::mapState(const StateMapperFunction &mapper) const
+{
+    return new UnaryStateOperator(mapper, this);
+}
+
 const Value *UnaryErrorOperator::apply(const SourceContext &context, const Value &value) const
 {
     stringstream stream;
@@ -56,8 +91,35 @@ const Value *UnaryComplexOperator::apply(const SourceContext &context, const Val
 
 const Value *UnaryMatrixOperator::apply(const SourceContext &context, const Value &value) const
 {
-    return value.type() == ValueType::matrixValueType
-               ? _mapper(context, ((const MatrixValue *)&value)->value())
+    return isMatrix(value)
+               ? withMatrix(context, value, [this, &context](const Matrix &m)
+                            { return _mapper(context, m); })
+               : _other->apply(context, value);
+}
+
+ChainUnaryOperator *ChainUnaryOperator::mapPauli(const PauliMapperFunction &mapper) const
+{
+    return new UnaryPauliOperator(mapper, this);
+}
+
+const Value *UnaryCircuitOperator::apply(const SourceContext &context, const Value &value) const
+{
+    return value.type() == ValueType::circuitValueType
+               ? _mapper(context, ((const CircuitValue *)&value)->value())
+               : _other->apply(context, value);
+}
+
+const Value *UnaryStateOperator::apply(const SourceContext &context, const Value &value) const
+{
+    return value.type() == ValueType::stateValueType
+               ? _mapper(context, ((const StateValue *)&value)->value())
+               : _other->apply(context, value);
+}
+
+const Value *UnaryPauliOperator::apply(const SourceContext &context, const Value &value) const
+{
+    return value.type() == ValueType::pauliValueType
+               ? _mapper(context, ((const PauliValue *)&value)->value())
                : _other->apply(context, value);
 }
 
@@ -114,6 +176,56 @@ ChainBinaryOperator *ChainBinaryOperator::mapMatrixMatrix(const MatrixMatrixMapp
     return new MatrixMatrixOperator(mapper, this);
 }
 
+ChainBinaryOperator *ChainBinaryOperator::mapCircuitCircuit(const CircuitCircuitMapperFunction &mapper) const
+{
+    return new CircuitCircuitOperator(mapper, this);
+}
+
+ChainBinaryOperator *ChainBinaryOperator::mapCircuitState(const CircuitStateMapperFunction &mapper) const
+{
+    return new CircuitStateOperator(mapper, this);
+}
+
+ChainBinaryOperator *ChainBinaryOperator::mapCircuitMatrix(const CircuitMatrixMapperFunction &mapper) const
+{
+    return new CircuitMatrixOperator(mapper, this);
+}
+
+ChainBinaryOperator *ChainBinaryOperator::mapMatrixState(const MatrixStateMapperFunction &mapper) const
+{
+    return new MatrixStateOperator(mapper, this);
+}
+
+ChainBinaryOperator *ChainBinaryOperator::mapStateState(const StateStateMapperFunction &mapper) const
+{
+    return new StateStateOperator(mapper, this);
+}
+
+ChainBinaryOperator *ChainBinaryOperator::mapPauliPauli(const PauliPauliMapperFunction &mapper) const
+{
+    return new PauliPauliOperator(mapper, this);
+}
+
+ChainBinaryOperator *ChainBinaryOperator::mapComplexPauli(const ComplexPauliMapperFunction &mapper) const
+{
+    return new ComplexPauliOperator(mapper, this);
+}
+
+ChainBinaryOperator *ChainBinaryOperator::mapPauliComplex(const PauliComplexMapperFunction &mapper) const
+{
+    return new PauliComplexOperator(mapper, this);
+}
+
+ChainBinaryOperator *ChainBinaryOperator::mapCircuitDensity(const CircuitDensityMapperFunction &mapper) const
+{
+    return new CircuitDensityOperator(mapper, this);
+}
+
+ChainBinaryOperator *ChainBinaryOperator::mapMatrixDensity(const MatrixDensityMapperFunction &mapper) const
+{
+    return new MatrixDensityOperator(mapper, this);
+}
+
 const Value *BinaryErrorOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
 {
     stringstream stream;
@@ -137,8 +249,9 @@ const Value *IntComplexOperator::apply(const SourceContext &context, const Value
 
 const Value *IntMatrixOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
 {
-    return left.type() == ValueType::intValueType && right.type() == ValueType::matrixValueType
-               ? _mapper(context, ((const IntValue *)&left)->value(), ((const MatrixValue *)&right)->value())
+    return left.type() == ValueType::intValueType && isMatrix(right)
+               ? withMatrix(context, right, [this, &context, &left](const Matrix &r)
+                            { return _mapper(context, ((const IntValue *)&left)->value(), r); })
                : _other->apply(context, left, right);
 }
 
@@ -158,28 +271,123 @@ const Value *ComplexComplexOperator::apply(const SourceContext &context, const V
 
 const Value *ComplexMatrixOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
 {
-    return left.type() == ValueType::complexValueType && right.type() == ValueType::matrixValueType
-               ? _mapper(context, ((const ComplexValue *)&left)->value(), ((const MatrixValue *)&right)->value())
+    return left.type() == ValueType::complexValueType && isMatrix(right)
+               ? withMatrix(context, right, [this, &context, &left](const Matrix &r)
+                            { return _mapper(context, ((const ComplexValue *)&left)->value(), r); })
                : _other->apply(context, left, right);
 }
 
 const Value *MatrixIntOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
 {
-    return left.type() == ValueType::matrixValueType && right.type() == ValueType::intValueType
-               ? _mapper(context, ((const MatrixValue *)&left)->value(), ((const IntValue *)&right)->value())
+    return isMatrix(left) && right.type() == ValueType::intValueType
+               ? withMatrix(context, left, [this, &context, &right](const Matrix &l)
+                            { return _mapper(context, l, ((const IntValue *)&right)->value()); })
                : _other->apply(context, left, right);
 }
 
 const Value *MatrixComplexOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
 {
-    return left.type() == ValueType::matrixValueType && right.type() == ValueType::complexValueType
-               ? _mapper(context, ((const MatrixValue *)&left)->value(), ((const ComplexValue *)&right)->value())
+    return isMatrix(left) && right.type() == ValueType::complexValueType
+               ? withMatrix(context, left, [this, &context, &right](const Matrix &l)
+                            { return _mapper(context, l, ((const ComplexValue *)&right)->value()); })
                : _other->apply(context, left, right);
 }
 
 const Value *MatrixMatrixOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
 {
-    return left.type() == ValueType::matrixValueType && right.type() == ValueType::matrixValueType
-               ? _mapper(context, ((const MatrixValue *)&left)->value(), ((const MatrixValue *)&right)->value())
+    return isMatrix(left) && isMatrix(right)
+               ? withMatrix(context, left, [this, &context, &right](const Matrix &l)
+                            { return withMatrix(context, right, [this, &context, &l](const Matrix &r)
+                                                { return _mapper(context, l, r); }); })
+               : _other->apply(context, left, right);
+}
+
+const Value *CircuitCircuitOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
+{
+    return left.type() == ValueType::circuitValueType && right.type() == ValueType::circuitValueType
+               ? _mapper(context, ((const CircuitValue *)&left)->value(), ((const CircuitValue *)&right)->value())
+               : _other->apply(context, left, right);
+}
+
+const Value *CircuitStateOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
+{
+    return left.type() == ValueType::circuitValueType && right.type() == ValueType::stateValueType
+               ? _mapper(context, ((const CircuitValue *)&left)->value(), ((const StateValue *)&right)->value())
+               : _other->apply(context, left, right);
+}
+
+const Value *CircuitMatrixOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
+{
+    return left.type() == ValueType::circuitValueType && right.type() == ValueType::matrixValueType
+               ? _mapper(context, ((const CircuitValue *)&left)->value(), ((const MatrixValue *)&right)->value())
+               : _other->apply(context, left, right);
+}
+
+const Value *MatrixStateOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
+{
+    return left.type() == ValueType::matrixValueType && right.type() == ValueType::stateValueType
+               ? _mapper(context, ((const MatrixValue *)&left)->value(), ((const StateValue *)&right)->value())
+               : _other->apply(context, left, right);
+}
+
+const Value *StateStateOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
+{
+    return left.type() == ValueType::stateValueType && right.type() == ValueType::stateValueType
+               ? _mapper(context, ((const StateValue *)&left)->value(), ((const StateValue *)&right)->value())
+               : _other->apply(context, left, right);
+}
+
+/**
+ * Returns true if the value is int or complex
+ * @param value the value
+ */
+static const bool isScalar(const Value &value)
+{
+    return value.type() == ValueType::intValueType || value.type() == ValueType::complexValueType;
+}
+
+/**
+ * Returns the complex of int or complex value
+ * @param value the value
+ */
+static const complex<double> scalarOf(const Value &value)
+{
+    return value.type() == ValueType::intValueType
+               ? complex<double>(((const IntValue *)&value)->value())
+               : ((const ComplexValue *)&value)->value();
+}
+
+const Value *PauliPauliOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
+{
+    return left.type() == ValueType::pauliValueType && right.type() == ValueType::pauliValueType
+               ? _mapper(context, ((const PauliValue *)&left)->value(), ((const PauliValue *)&right)->value())
+               : _other->apply(context, left, right);
+}
+
+const Value *ComplexPauliOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
+{
+    return isScalar(left) && right.type() == ValueType::pauliValueType
+               ? _mapper(context, scalarOf(left), ((const PauliValue *)&right)->value())
+               : _other->apply(context, left, right);
+}
+
+const Value *PauliComplexOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
+{
+    return left.type() == ValueType::pauliValueType && isScalar(right)
+               ? _mapper(context, ((const PauliValue *)&left)->value(), scalarOf(right))
+               : _other->apply(context, left, right);
+}
+
+const Value *CircuitDensityOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
+{
+    return left.type() == ValueType::circuitValueType && right.type() == ValueType::densityValueType
+               ? _mapper(context, ((const CircuitValue *)&left)->value(), ((const DensityValue *)&right)->value())
+               : _other->apply(context, left, right);
+}
+
+const Value *MatrixDensityOperator::apply(const SourceContext &context, const Value &left, const Value &right) const
+{
+    return left.type() == ValueType::matrixValueType && right.type() == ValueType::densityValueType
+               ? _mapper(context, ((const MatrixValue *)&left)->value(), ((const DensityValue *)&right)->value())
                : _other->apply(context, left, right);
 }
@@ -0,0 +1,113 @@
+#include <sstream>
+#include <algorithm>
+
+#include "oracle.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+/**
+ * The maximum number of qubits of marked flags table (64KB)
+ */
+static const size_t ORACLE_TABLE_QUBITS = 16;
+
+/**
+ * Returns the register value of the qubits in the state index
+ * @param index the state index
+ * @param qubits the qubits from the least significant
+ */
+static inline const uint64_t registerValue(const uint64_t index, const indices_t &qubits)
+{
+    uint64_t x = 0;
+    for (size_t j = 0; j < qubits.size(); j++)
+    {
+        x |= ((index >> qubits[j]) & 1) << j;
+    }
+    return x;
+}
+
+/**
+ * Negates the amplitudes of the marked register values in the range of cells
+ * @param cells the state vector cells
+ * @param from the first cell
+ * @param to the cell after the last
+ * @param qubits the qubits
+ * @param isMarked the predicate of register value
+ */
+template <class P>
+static void sweep(complex<double> *cells, const size_t from, const size_t to, const indices_t &qubits, const P &isMarked)
+{
+    for (size_t i = from; i < to; i++)
+    {
+        if (isMarked(registerValue(i, qubits)))
+        {
+            cells[i] = -cells[i];
+        }
+    }
+}
+
+/**
+ * Runs the sweep on contiguous ranges of the cells in parallel
+ * @param cells the state vector cells
+ * @param size the number of cells
+ * @param qubits the qubits
+ * @param numThreads the requested number of threads (0 for hardware concurrency)
+ * @param isMarked the predicate of register value
+ */
+template <class P>
+static void parallelSweep(complex<double> *cells, const size_t size, const indices_t &qubits, const size_t numThreads, const P &isMarked)
+{
+    parallelFor(size, threadCount(numThreads, size, size), [cells, &qubits, &isMarked](const size_t from, const size_t to)
+                { sweep(cells, from, to, qubits, isMarked); });
+}
+
+void mx::phaseOracle(complex<double> *cells, const size_t size, const indices_t &qubits, const vector<uint64_t> &marked, const size_t numThreads)
+{
+    validateBitMap(qubits);
+    for (const size_t bit : qubits)
+    {
+        if (size < (2ULL << bit))
+        {
+            throw invalid_argument(
+                (ostringstream() << "Expected state of at least " << (bit + 1) << " qubits, got " << size << " cells")
+                    .str());
+        }
+    }
+    if (marked.empty())
+    {
+        return;
+    }
+    const size_t k = qubits.size();
+    if (k <= ORACLE_TABLE_QUBITS)
+    {
+        // Flags table of register values
+        vector<uint8_t> flags(1ULL << k, 0);
+        for (const uint64_t x : marked)
+        {
+            flags[x] = 1;
+        }
+        parallelSweep(cells, size, qubits, numThreads, [&flags](const uint64_t x)
+                      { return flags[x] != 0; });
+    }
+    else
+    {
+        parallelSweep(cells, size, qubits, numThreads, [&marked](const uint64_t x)
+                      { return binary_search(marked.begin(), marked.end(), x); });
+    }
+}
+
+const Matrix mx::oracleMatrix(const size_t numQubits, const vector<uint64_t> &marked)
+{
+    const size_t m = 1ULL << numQubits;
+    ComplexVect cells(m * m, 0);
+    for (size_t i = 0; i < m; i++)
+    {
+        cells[Matrix::indexOf(m, i, i)] = 1;
+    }
+    for (const uint64_t x : marked)
+    {
+        cells[Matrix::indexOf(m, x, x)] = -1;
+    }
+    return Matrix(m, m, cells);
+}
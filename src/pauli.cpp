@@ -0,0 +1,409 @@
+#include <sstream>
+#include <algorithm>
+#include <unordered_map>
+#include <bit>
+
+#include "pauli.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+/**
+ * The maximum ratio between the state vector size and the non zero amplitudes
+ * of the states evaluated on the dense cells
+ */
+static const size_t DENSE_FILL_RATIO = 4;
+
+/**
+ * Returns the power of i
+ * @param phase the exponent
+ */
+static const complex<double> iPower(const unsigned phase)
+{
+    static const complex<double> POWERS[] = {1, complex<double>(0, 1), -1, complex<double>(0, -1)};
+    return POWERS[phase & 3];
+}
+
+/**
+ * Returns the parity of the mask bits
+ * @param mask the mask
+ */
+static inline const int parity(const uint64_t mask)
+{
+    return popcount(mask) & 1;
+}
+
+/**
+ * Returns the qubit mask
+ * @param qubit the qubit
+ */
+static const uint64_t qubitMask(const size_t qubit)
+{
+    if (qubit >= MAX_PAULI_QUBITS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected qubit < " << MAX_PAULI_QUBITS << ", got (" << qubit << ")")
+                .str());
+    }
+    return 1ULL << qubit;
+}
+
+const PauliString mx::pauliX(const size_t qubit)
+{
+    return PauliString(qubitMask(qubit), 0);
+}
+
+const PauliString mx::pauliY(const size_t qubit)
+{
+    return PauliString(qubitMask(qubit), qubitMask(qubit));
+}
+
+const PauliString mx::pauliZ(const size_t qubit)
+{
+    return PauliString(0, qubitMask(qubit));
+}
+
+const size_t PauliString::numQubits(void) const
+{
+    return max(1, 64 - countl_zero(support()));
+}
+
+const PauliString PauliString::operator*(const PauliString &right) const
+{
+    // P_a = i^|xa & za| Xa Za, Xa Za Xb Zb = (-1)^|za & xb| Xa Xb Za Zb
+    const uint64_t x = _x ^ right._x;
+    const uint64_t z = _z ^ right._z;
+    const unsigned phase = _phase + right._phase + popcount(_x & _z) + popcount(right._x & right._z) + 2 * popcount(_z & right._x) - popcount(x & z);
+    return PauliString(x, z, phase);
+}
+
+const bool PauliString::commutes(const PauliString &other) const
+{
+    return parity((_x & other._z) ^ (_z & other._x)) == 0;
+}
+
+const bool PauliString::qubitWiseCommutes(const PauliString &other) const
+{
+    return (((_x ^ other._x) | (_z ^ other._z)) & support() & other.support()) == 0;
+}
+
+const Matrix PauliString::matrix(const size_t numQubits) const
+{
+    if (numQubits > MAX_DENSE_QUBITS / 2)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Pauli string too large for dense matrix: " << numQubits << " qubits")
+                .str());
+    }
+    // i^phase P|b> = i^(phase + |x & z|) (-1)^|z & b| |b ^ x>
+    const size_t n = 1ULL << numQubits;
+    const complex<double> sign = iPower(_phase + popcount(_x & _z));
+    ComplexVect cells(n * n, 0);
+    for (uint64_t b = 0; b < n; b++)
+    {
+        cells[(b ^ _x) * n + b] = parity(_z & b) ? -sign : sign;
+    }
+    return Matrix(n, n, cells);
+}
+
+PauliSum::PauliSum(const PauliString &string, const complex<double> &coefficient)
+    : _terms{{coefficient, string}}
+{
+    simplify();
+}
+
+PauliSum::PauliSum(const vector<pair<complex<double>, PauliString>> &terms)
+    : _terms(terms)
+{
+    simplify();
+}
+
+PauliSum &PauliSum::simplify(void)
+{
+    // Folds the phases and merges the terms of the same string
+    for (auto &[c, string] : _terms)
+    {
+        c *= iPower(string.phase());
+        string = PauliString(string.x(), string.z());
+    }
+    sort(_terms.begin(), _terms.end(), [](const auto &a, const auto &b)
+         { return a.second.x() < b.second.x() || (a.second.x() == b.second.x() && a.second.z() < b.second.z()); });
+    vector<pair<complex<double>, PauliString>> terms;
+    for (const auto &term : _terms)
+    {
+        if (!terms.empty() && terms.back().second.x() == term.second.x() && terms.back().second.z() == term.second.z())
+        {
+            terms.back().first += term.first;
+        }
+        else
+        {
+            terms.push_back(term);
+        }
+    }
+    _terms.clear();
+    for (const auto &term : terms)
+    {
+        if (term.first != 0.0)
+        {
+            _terms.push_back(term);
+        }
+    }
+    return *this;
+}
+
+const size_t PauliSum::numQubits(void) const
+{
+    size_t result = 1;
+    for (const auto &[c, string] : _terms)
+    {
+        result = max(result, string.numQubits());
+    }
+    return result;
+}
+
+const PauliSum PauliSum::operator+(const PauliSum &right) const
+{
+    vector<pair<complex<double>, PauliString>> terms = _terms;
+    terms.insert(terms.end(), right._terms.begin(), right._terms.end());
+    return PauliSum(terms);
+}
+
+const PauliSum PauliSum::operator-(const PauliSum &right) const
+{
+    return *this + (-right);
+}
+
+const PauliSum PauliSum::operator-(void) const
+{
+    return *this * complex<double>(-1);
+}
+
+const PauliSum PauliSum::operator*(const PauliSum &right) const
+{
+    vector<pair<complex<double>, PauliString>> terms;
+    for (const auto &[a, p] : _terms)
+    {
+        for (const auto &[b, q] : right._terms)
+        {
+            terms.push_back({a * b, p * q});
+        }
+    }
+    return PauliSum(terms);
+}
+
+const PauliSum PauliSum::operator*(const complex<double> &right) const
+{
+    vector<pair<complex<double>, PauliString>> terms = _terms;
+    for (auto &term : terms)
+    {
+        term.first *= right;
+    }
+    return PauliSum(terms);
+}
+
+const vector<vector<size_t>> PauliSum::groups(void) const
+{
+    // Greedy grouping by the common X and Z masks of each group
+    vector<vector<size_t>> result;
+    vector<PauliString> bases;
+    for (size_t i = 0; i < _terms.size(); i++)
+    {
+        const PauliString &string = _terms[i].second;
+        size_t g = 0;
+        while (g < bases.size() && !bases[g].qubitWiseCommutes(string))
+        {
+            g++;
+        }
+        if (g == bases.size())
+        {
+            bases.push_back(PauliString());
+            result.push_back({});
+        }
+        bases[g] = PauliString(bases[g].x() | string.x(), bases[g].z() | string.z());
+        result[g].push_back(i);
+    }
+    return result;
+}
+
+const complex<double> PauliSum::expectation(const ComplexVect &cells) const
+{
+    const size_t n = cells.size();
+    const uint64_t outMask = ~(uint64_t)(n - 1);
+    complex<double> result = 0;
+    ComplexVect rotated(n);
+    for (const vector<size_t> &group : groups())
+    {
+        // Rotates the X and Y qubits of the group to the computational basis
+        uint64_t x = 0, z = 0;
+        for (const size_t i : group)
+        {
+            x |= _terms[i].second.x();
+            z |= _terms[i].second.z();
+        }
+        rotated = cells;
+        for (size_t q = 0; (1ULL << q) < n; q++)
+        {
+            const uint64_t bit = 1ULL << q;
+            if ((x & bit) == 0)
+            {
+                continue;
+            }
+            // H for X, H S^ for Y
+            const complex<double> f = (z & bit) != 0 ? complex<double>(0, -1) : 1;
+            for (uint64_t b = 0; b < n; b++)
+            {
+                if ((b & bit) == 0)
+                {
+                    const complex<double> a0 = rotated[b];
+                    const complex<double> a1 = f * rotated[b | bit];
+                    rotated[b] = (a0 + a1) * M_SQRT1_2;
+                    rotated[b | bit] = (a0 - a1) * M_SQRT1_2;
+                }
+            }
+        }
+        // Evaluates the diagonal terms by the parity of the supports
+        vector<double> sums(group.size(), 0);
+        for (uint64_t b = 0; b < n; b++)
+        {
+            const double p = norm(rotated[b]);
+            if (p == 0)
+            {
+                continue;
+            }
+            for (size_t k = 0; k < group.size(); k++)
+            {
+                sums[k] += parity(_terms[group[k]].second.support() & b) ? -p : p;
+            }
+        }
+        for (size_t k = 0; k < group.size(); k++)
+        {
+            // X and Y on the qubits out of the register have zero expectation
+            if ((_terms[group[k]].second.x() & outMask) == 0)
+            {
+                result += _terms[group[k]].first * sums[k];
+            }
+        }
+    }
+    return result;
+}
+
+const complex<double> PauliSum::expectation(const State &state) const
+{
+    vector<pair<uint64_t, complex<double>>> amplitudes;
+    state.forEach([&amplitudes](const uint64_t index, const complex<double> &value)
+                  { amplitudes.push_back({index, value}); });
+    const size_t n = state.numQubits();
+    if (n <= MAX_DENSE_QUBITS && (1ULL << n) <= DENSE_FILL_RATIO * amplitudes.size())
+    {
+        // Grouped evaluation when the amplitudes fill the state vector
+        ComplexVect cells(1ULL << n, 0);
+        for (const auto &[index, value] : amplitudes)
+        {
+            cells[index] = value;
+        }
+        return expectation(cells);
+    }
+    // Term by term on the non zero amplitudes
+    unordered_map<uint64_t, complex<double>> cells(amplitudes.begin(), amplitudes.end());
+    complex<double> result = 0;
+    for (const auto &[c, string] : _terms)
+    {
+        const complex<double> sign = iPower(popcount(string.x() & string.z()));
+        complex<double> sum = 0;
+        for (const auto &[b, value] : amplitudes)
+        {
+            const auto it = cells.find(b ^ string.x());
+            if (it != cells.end())
+            {
+                sum += conj(it->second) * (parity(string.z() & b) ? -value : value);
+            }
+        }
+        result += c * sign * sum;
+    }
+    return result;
+}
+
+const ComplexVect PauliSum::apply(const ComplexVect &cells, const size_t numThreads) const
+{
+    const size_t n = cells.size();
+    const uint64_t outMask = ~(uint64_t)(n - 1);
+    // i^|x & z| c (-1)^|z & b| folded for each term applied to |b> = |a ^ x>
+    vector<pair<complex<double>, PauliString>> terms;
+    for (const auto &[c, string] : _terms)
+    {
+        if ((string.x() & outMask) == 0)
+        {
+            terms.push_back({c * iPower(popcount(string.x() & string.z())), string});
+        }
+    }
+    ComplexVect result(n, 0);
+    auto task = [&cells, &result, &terms](const size_t from, const size_t to)
+    {
+        for (uint64_t a = from; a < to; a++)
+        {
+            complex<double> sum = 0;
+            for (const auto &[c, string] : terms)
+            {
+                const uint64_t b = a ^ string.x();
+                sum += parity(string.z() & b) ? -c * cells[b] : c * cells[b];
+            }
+            result[a] = sum;
+        }
+    };
+    parallelFor(n, threadCount(numThreads, n, n * terms.size()), task);
+    return result;
+}
+
+const Matrix PauliSum::matrix(void) const
+{
+    const size_t n = numQubits();
+    const size_t size = 1ULL << n;
+    Matrix result(size, size, ComplexVect(size * size, 0));
+    for (const auto &[c, string] : _terms)
+    {
+        result = result + string.matrix(n) * c;
+    }
+    return result;
+}
+
+ostream &operator<<(ostream &out, const PauliSum &sum)
+{
+    if (sum.terms().empty())
+    {
+        return out << "(0) I";
+    }
+    bool first = true;
+    for (const auto &[c, string] : sum.terms())
+    {
+        if (!first)
+        {
+            out << " + ";
+        }
+        first = false;
+        out << "(" << fmt(c) << ")";
+        if (string.support() == 0)
+        {
+            out << " I";
+        }
+        for (size_t q = string.numQubits(); q-- > 0;)
+        {
+            const bool x = (string.x() >> q) & 1;
+            const bool z = (string.z() >> q) & 1;
+            if (x || z)
+            {
+                out << " " << (x && z ? "Y" : x ? "X"
+                                                : "Z")
+                    << q;
+            }
+        }
+    }
+    return out;
+}
+
+const string to_string(const PauliSum &sum)
+{
+    stringstream stream;
+    stream << sum;
+    return stream.str();
+}
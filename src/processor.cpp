@@ -1,10 +1,23 @@
 #include <sstream>
+#include <climits>
 
 #include "processor.h"
 #include "values.h"
 #include "commands.h"
 #include "matrix.h"
 #include "operators.h"
+#include "circuit.h"
+#include "sparseState.h"
+#include "decisionDiagram.h"
+#include "tensorNetwork.h"
+#include "hybrid.h"
+#include "densityMatrix.h"
+#include "trajectories.h"
+#include "shardedState.h"
+#include "mappedState.h"
+#include "productState.h"
+#include "sampling.h"
+#include "expm.h"
 
 using namespace std;
 using namespace qc;
@@ -99,7 +112,15 @@ static const Value *complexNormalise(const SourceContext &context, const complex
 
 static const Value *matrixNormalise(const SourceContext &context, const Matrix &arg)
 {
-    return new MatrixValue(context, arg);
+    try
+    {
+        vu::ComplexVect cells = arg.cells();
+        return new MatrixValue(context, Matrix(arg.numRows(), arg.numCols(), vu::normalise(cells)));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
 }
 
 const ChainUnaryOperator &normOper = *(new UnaryErrorOperator())
@@ -112,6 +133,54 @@ static const Value *normMapper(const SourceContext &context, const ListValue &ar
     return normOper.apply(context, *args.values().at(0));
 };
 
+// -------- norm
+
+static const Value *intNorm(const SourceContext &context, const int arg)
+{
+    return new IntValue(context, abs(arg));
+}
+
+static const Value *complexNorm(const SourceContext &context, const complex<double> &arg)
+{
+    return new ComplexValue(context, abs(arg));
+}
+
+static const Value *matrixNorm(const SourceContext &context, const Matrix &arg)
+{
+    return new ComplexValue(context, vu::norm2(arg.cells()));
+}
+
+const ChainUnaryOperator &norm2Oper = *(new UnaryErrorOperator())
+                                           ->mapInt(intNorm)
+                                           ->mapComplex(complexNorm)
+                                           ->mapMatrix(matrixNorm);
+
+static const Value *norm2Mapper(const SourceContext &context, const ListValue &args)
+{
+    return norm2Oper.apply(context, *args.values().at(0));
+};
+
+// -------- inner
+
+static const Value *matrixInner(const SourceContext &context, const Matrix &left, const Matrix &right)
+{
+    if (left.numRows() != right.numRows() || left.numCols() != right.numCols())
+    {
+        stringstream str;
+        str << "Expected same size matrices, got (" << left.numRows() << "x" << left.numCols() << ") and (" << right.numRows() << "x" << right.numCols() << ")";
+        throw context.execException(str.str());
+    }
+    return new ComplexValue(context, vu::inner(left.cells(), right.cells()));
+}
+
+const ChainBinaryOperator &innerOper = *(new BinaryErrorOperator())
+                                            ->mapMatrixMatrix(matrixInner);
+
+static const Value *innerMapper(const SourceContext &context, const ListValue &args)
+{
+    return innerOper.apply(context, *args.values().at(0), *args.values().at(1));
+};
+
 // -------- I
 
 static const Value *intI(const SourceContext &context, const int arg)
@@ -119,111 +188,1217 @@ static const Value *intI(const SourceContext &context, const int arg)
     return new MatrixValue(context, I(arg));
 }
 
-const ChainUnaryOperator &iOper = *(new UnaryErrorOperator())
-                                       ->mapInt(intI);
-
-static const Value *iMapper(const SourceContext &context, const ListValue &args)
+const ChainUnaryOperator &iOper = *(new UnaryErrorOperator())
+                                       ->mapInt(intI);
+
+static const Value *iMapper(const SourceContext &context, const ListValue &args)
+{
+    return iOper.apply(context, *args.values().at(0));
+};
+
+// -------- H
+
+static const Value *intH(const SourceContext &context, const int arg)
+{
+    try
+    {
+        return new CircuitValue(context, hGate(arg));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainUnaryOperator &hOper = *(new UnaryErrorOperator())
+                                       ->mapInt(intH);
+
+static const Value *hMapper(const SourceContext &context, const ListValue &args)
+{
+    return hOper.apply(context, *args.values().at(0));
+};
+
+// -------- S
+
+static const Value *intS(const SourceContext &context, const int arg)
+{
+    try
+    {
+        return new CircuitValue(context, sGate(arg));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainUnaryOperator &sOper = *(new UnaryErrorOperator())
+                                       ->mapInt(intS);
+
+static const Value *sMapper(const SourceContext &context, const ListValue &args)
+{
+    return sOper.apply(context, *args.values().at(0));
+};
+
+// -------- T
+
+static const Value *intT(const SourceContext &context, const int arg)
+{
+    try
+    {
+        return new CircuitValue(context, tGate(arg));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainUnaryOperator &tOper = *(new UnaryErrorOperator())
+                                       ->mapInt(intT);
+
+static const Value *tMapper(const SourceContext &context, const ListValue &args)
+{
+    return tOper.apply(context, *args.values().at(0));
+};
+
+// -------- X
+
+static const Value *intX(const SourceContext &context, const int arg)
+{
+    try
+    {
+        return new CircuitValue(context, xGate(arg));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainUnaryOperator &xOper = *(new UnaryErrorOperator())
+                                       ->mapInt(intX);
+
+static const Value *xMapper(const SourceContext &context, const ListValue &args)
+{
+    return xOper.apply(context, *args.values().at(0));
+};
+
+// -------- Y
+
+static const Value *intY(const SourceContext &context, const int arg)
+{
+    try
+    {
+        return new CircuitValue(context, yGate(arg));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainUnaryOperator &yOper = *(new UnaryErrorOperator())
+                                       ->mapInt(intY);
+
+static const Value *yMapper(const SourceContext &context, const ListValue &args)
+{
+    return yOper.apply(context, *args.values().at(0));
+};
+
+// -------- Z
+
+static const Value *intZ(const SourceContext &context, const int arg)
+{
+    try
+    {
+        return new CircuitValue(context, zGate(arg));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainUnaryOperator &zOper = *(new UnaryErrorOperator())
+                                       ->mapInt(intZ);
+
+static const Value *zMapper(const SourceContext &context, const ListValue &args)
+{
+    return zOper.apply(context, *args.values().at(0));
+};
+
+// -------- CNOT
+
+static const Value *intCNOT(const SourceContext &context, const int data, const int control)
+{
+    try
+    {
+        return new CircuitValue(context, cnotGate(data, control));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainBinaryOperator &cnotOper = *(new BinaryErrorOperator())
+                                           ->mapIntInt(intCNOT);
+
+static const Value *cnotMapper(const SourceContext &context, const ListValue &args)
+{
+    return cnotOper.apply(context, *args.values().at(0), *args.values().at(1));
+};
+
+// -------- SWAP
+
+static const Value *intSWAP(const SourceContext &context, const int data0, const int data1)
+{
+    try
+    {
+        return new CircuitValue(context, swapGate(data0, data1));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainBinaryOperator &swapOper = *(new BinaryErrorOperator())
+                                           ->mapIntInt(intSWAP);
+
+static const Value *swapMapper(const SourceContext &context, const ListValue &args)
+{
+    return swapOper.apply(context, *args.values().at(0), *args.values().at(1));
+};
+
+//-----------------------
+
+static const Value *ccnotMapper(const SourceContext &context, const ListValue &args)
+{
+    const Value *data = args.values().at(0);
+    const Value *ctrl0 = args.values().at(1);
+    const Value *ctrl1 = args.values().at(2);
+
+    if (data->type() != ValueType::intValueType || ctrl0->type() != ValueType::intValueType || ctrl1->type() != ValueType::intValueType)
+    {
+        stringstream str;
+        str << "Unexpected arguments " << data->type() << ", " << ctrl0->type() << ", " << ctrl1->type();
+        throw context.execException(str.str());
+    }
+    try
+    {
+        return new CircuitValue(context, ccnotGate(((const IntValue *)data)->value(),
+                                                   ((const IntValue *)ctrl0)->value(),
+                                                   ((const IntValue *)ctrl1)->value()));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+// -------- Rotations
+
+/**
+ * Returns the rotation gate of the qubit and angle arguments
+ * @param context the context
+ * @param args the arguments (qubit, angles ...)
+ * @param factory the gate factory
+ */
+static const Value *rotation(const SourceContext &context, const ListValue &args,
+                             const function<const Gate(const size_t, const vector<double> &)> &factory)
+{
+    const vector<const Value *> &values = args.values();
+    bool valid = values.at(0)->type() == ValueType::intValueType;
+    for (size_t i = 1; i < values.size(); i++)
+    {
+        valid = valid && (values.at(i)->type() == ValueType::intValueType || values.at(i)->type() == ValueType::complexValueType);
+    }
+    if (!valid)
+    {
+        stringstream str;
+        str << "Unexpected arguments ";
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            str << (i > 0 ? ", " : "") << values.at(i)->type();
+        }
+        throw context.execException(str.str());
+    }
+    const int qubit = ((const IntValue *)values.at(0))->value();
+    if (qubit < 0)
+    {
+        stringstream str;
+        str << "Expected qubit >= 0, got (" << qubit << ")";
+        throw context.execException(str.str());
+    }
+    vector<double> angles;
+    for (size_t i = 1; i < values.size(); i++)
+    {
+        const complex<double> angle = values.at(i)->type() == ValueType::intValueType
+                                          ? complex<double>(((const IntValue *)values.at(i))->value())
+                                          : ((const ComplexValue *)values.at(i))->value();
+        if (angle.imag() != 0)
+        {
+            stringstream str;
+            str << "Expected real angle, got " << angle;
+            throw context.execException(str.str());
+        }
+        angles.push_back(angle.real());
+    }
+    try
+    {
+        return new CircuitValue(context, factory(qubit, angles));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+static const Value *rxMapper(const SourceContext &context, const ListValue &args)
+{
+    return rotation(context, args, [](const size_t qubit, const vector<double> &angles)
+                    { return rxGate(qubit, angles[0]); });
+};
+
+static const Value *ryMapper(const SourceContext &context, const ListValue &args)
+{
+    return rotation(context, args, [](const size_t qubit, const vector<double> &angles)
+                    { return ryGate(qubit, angles[0]); });
+};
+
+static const Value *rzMapper(const SourceContext &context, const ListValue &args)
+{
+    return rotation(context, args, [](const size_t qubit, const vector<double> &angles)
+                    { return rzGate(qubit, angles[0]); });
+};
+
+static const Value *phaseMapper(const SourceContext &context, const ListValue &args)
+{
+    return rotation(context, args, [](const size_t qubit, const vector<double> &angles)
+                    { return phaseGate(qubit, angles[0]); });
+};
+
+static const Value *u3Mapper(const SourceContext &context, const ListValue &args)
+{
+    return rotation(context, args, [](const size_t qubit, const vector<double> &angles)
+                    { return u3Gate(qubit, angles[0], angles[1], angles[2]); });
+};
+
+// -------- qbit0
+
+static const Value *intQubit0(const SourceContext &context, const int index, const int numBits)
+{
+    try
+    {
+        return new MatrixValue(context, qubit0(index, numBits));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainBinaryOperator &qubit0Oper = *(new BinaryErrorOperator())
+                                             ->mapIntInt(intQubit0);
+
+static const Value *qubit0Mapper(const SourceContext &context, const ListValue &args)
+{
+    return qubit0Oper.apply(context, *args.values().at(0), *args.values().at(1));
+};
+
+// -------- qbit1
+
+static const Value *intQubit1(const SourceContext &context, const int index, const int numBits)
+{
+    try
+    {
+        return new MatrixValue(context, qubit1(index, numBits));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainBinaryOperator &qubit1Oper = *(new BinaryErrorOperator())
+                                             ->mapIntInt(intQubit1);
+
+static const Value *qubit1Mapper(const SourceContext &context, const ListValue &args)
+{
+    return qubit1Oper.apply(context, *args.values().at(0), *args.values().at(1));
+};
+
+// -------- Pauli strings
+
+/**
+ * Returns the Pauli value of a single qubit operator
+ * @param context the context
+ * @param factory the string factory
+ * @param qubit the qubit
+ */
+static const Value *intPauli(const SourceContext &context, const PauliString (*factory)(const size_t), const int qubit)
+{
+    if (qubit < 0)
+    {
+        stringstream str;
+        str << "Expected qubit >= 0, got (" << qubit << ")";
+        throw context.execException(str.str());
+    }
+    try
+    {
+        return new PauliValue(context, make_shared<PauliSum>(factory(qubit)));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainUnaryOperator &pxOper = *(new UnaryErrorOperator())
+                                        ->mapInt([](const SourceContext &context, const int arg)
+                                                 { return intPauli(context, pauliX, arg); });
+
+const ChainUnaryOperator &pyOper = *(new UnaryErrorOperator())
+                                        ->mapInt([](const SourceContext &context, const int arg)
+                                                 { return intPauli(context, pauliY, arg); });
+
+const ChainUnaryOperator &pzOper = *(new UnaryErrorOperator())
+                                        ->mapInt([](const SourceContext &context, const int arg)
+                                                 { return intPauli(context, pauliZ, arg); });
+
+static const Value *pxMapper(const SourceContext &context, const ListValue &args)
+{
+    return pxOper.apply(context, *args.values().at(0));
+};
+
+static const Value *pyMapper(const SourceContext &context, const ListValue &args)
+{
+    return pyOper.apply(context, *args.values().at(0));
+};
+
+static const Value *pzMapper(const SourceContext &context, const ListValue &args)
+{
+    return pzOper.apply(context, *args.values().at(0));
+};
+
+// -------- sparse
+
+static const Value *matrixSparse(const SourceContext &context, const Matrix &arg)
+{
+    try
+    {
+        return new StateValue(context, make_shared<SparseState>(arg));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainUnaryOperator &sparseOper = *(new UnaryErrorOperator())
+                                            ->mapMatrix(matrixSparse);
+
+static const Value *sparseMapper(const SourceContext &context, const ListValue &args)
+{
+    return sparseOper.apply(context, *args.values().at(0));
+};
+
+// -------- qmdd
+
+static const Value *matrixQmdd(const SourceContext &context, const Matrix &arg)
+{
+    try
+    {
+        return new StateValue(context, make_shared<DDState>(arg));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainUnaryOperator &qmddOper = *(new UnaryErrorOperator())
+                                          ->mapMatrix(matrixQmdd);
+
+static const Value *qmddMapper(const SourceContext &context, const ListValue &args)
+{
+    return qmddOper.apply(context, *args.values().at(0));
+};
+
+// -------- shard
+
+static const Value *matrixShard(const SourceContext &context, const Matrix &arg)
+{
+    try
+    {
+        return new StateValue(context, make_shared<ShardedState>(defaultTransport(), arg));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainUnaryOperator &shardOper = *(new UnaryErrorOperator())
+                                           ->mapMatrix(matrixShard);
+
+static const Value *shardMapper(const SourceContext &context, const ListValue &args)
+{
+    return shardOper.apply(context, *args.values().at(0));
+};
+
+// -------- mapped
+
+static const Value *matrixMapped(const SourceContext &context, const Matrix &arg)
+{
+    try
+    {
+        return new StateValue(context, make_shared<MappedState>(arg));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainUnaryOperator &mappedOper = *(new UnaryErrorOperator())
+                                            ->mapMatrix(matrixMapped);
+
+static const Value *mappedMapper(const SourceContext &context, const ListValue &args)
+{
+    return mappedOper.apply(context, *args.values().at(0));
+};
+
+// -------- product
+
+static const Value *matrixProduct(const SourceContext &context, const Matrix &arg)
+{
+    try
+    {
+        return new StateValue(context, make_shared<ProductState>(arg));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainUnaryOperator &productOper = *(new UnaryErrorOperator())
+                                             ->mapMatrix(matrixProduct);
+
+static const Value *productMapper(const SourceContext &context, const ListValue &args)
+{
+    return productOper.apply(context, *args.values().at(0));
+};
+
+// -------- amplitude
+
+/**
+ * Returns the index of a basis state given as integer, ket or state with a single non zero amplitude
+ * @param value the value
+ */
+static const uint64_t basisIndex(const Value *value)
+{
+    if (value->type() == ValueType::intValueType)
+    {
+        const int index = ((const IntValue *)value)->value();
+        if (index < 0)
+        {
+            throw invalid_argument(
+                (ostringstream() << "Expected non negative basis state, got (" << index << ")")
+                    .str());
+        }
+        return index;
+    }
+    vector<uint64_t> indices;
+    if (value->type() == ValueType::stateValueType)
+    {
+        ((const StateValue *)value)->value().forEach([&indices](const uint64_t index, const complex<double> &)
+                                                     { indices.push_back(index); });
+    }
+    else
+    {
+        const Matrix &ket = ((const MatrixValue *)value)->value();
+        if (ket.numCols() != 1)
+        {
+            throw invalid_argument(
+                (ostringstream() << "Expected ket, got (" << ket.numRows() << "x" << ket.numCols() << ")")
+                    .str());
+        }
+        for (size_t i = 0; i < ket.numRows(); i++)
+        {
+            if (ket.cells()[i] != 0.0)
+            {
+                indices.push_back(i);
+            }
+        }
+    }
+    if (indices.size() != 1)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected basis state of one non zero amplitude, got (" << indices.size() << ")")
+                .str());
+    }
+    return indices[0];
+}
+
+/**
+ * Returns the sparse basis state value of an index, exact over 64 bits unlike the integer values
+ * @param context the context
+ * @param numQubits the number of qubits
+ * @param index the basis state index
+ */
+static const Value *basisValue(const SourceContext &context, const size_t numQubits, const uint64_t index)
+{
+    shared_ptr<SparseState> state = make_shared<SparseState>(numQubits);
+    state->add(index, 1);
+    return new StateValue(context, state);
+}
+
+static const Value *amplitudeMapper(const SourceContext &context, const ListValue &args)
+{
+    const Value *circuit = args.values().at(0);
+    const Value *out = args.values().at(1);
+    const Value *in = args.values().at(2);
+
+    const auto isBasis = [](const Value *value)
+    {
+        return value->type() == ValueType::intValueType || value->type() == ValueType::matrixValueType || value->type() == ValueType::stateValueType;
+    };
+    if ((circuit->type() != ValueType::circuitValueType && circuit->type() != ValueType::matrixValueType) || !isBasis(out) || !isBasis(in))
+    {
+        stringstream str;
+        str << "Unexpected arguments " << circuit->type() << ", " << out->type() << ", " << in->type();
+        throw context.execException(str.str());
+    }
+    try
+    {
+        const Circuit c = circuit->type() == ValueType::circuitValueType
+                              ? ((const CircuitValue *)circuit)->value()
+                              : matrixCircuit(((const MatrixValue *)circuit)->value());
+        return new ComplexValue(context, tensorAmplitude(c, basisIndex(out), basisIndex(in)));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+// -------- hybrid
+
+static const Value *hybridMapper(const SourceContext &context, const ListValue &args)
+{
+    const Value *circuit = args.values().at(0);
+    const Value *in = args.values().at(1);
+    const Value *cut = args.values().at(2);
+
+    if (circuit->type() != ValueType::circuitValueType || in->type() != ValueType::intValueType || cut->type() != ValueType::intValueType)
+    {
+        stringstream str;
+        str << "Unexpected arguments " << circuit->type() << ", " << in->type() << ", " << cut->type();
+        throw context.execException(str.str());
+    }
+    const int inState = ((const IntValue *)in)->value();
+    const int cutQubits = ((const IntValue *)cut)->value();
+    if (inState < 0 || cutQubits < 0)
+    {
+        stringstream str;
+        str << "Expected non negative arguments, got (" << inState << ", " << cutQubits << ")";
+        throw context.execException(str.str());
+    }
+    try
+    {
+        const HybridSimulator simulator(((const CircuitValue *)circuit)->value(), inState, cutQubits);
+        return new StateValue(context, simulator.state());
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+// -------- density
+
+static const Value *matrixDensity(const SourceContext &context, const Matrix &arg)
+{
+    try
+    {
+        return new DensityValue(context, make_shared<DensityMatrix>(arg));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+const ChainUnaryOperator &densityOper = *(new UnaryErrorOperator())
+                                             ->mapMatrix(matrixDensity);
+
+static const Value *densityMapper(const SourceContext &context, const ListValue &args)
+{
+    return densityOper.apply(context, *args.values().at(0));
+};
+
+/**
+ * Returns the density matrix value with the channel applied
+ * @param context the context
+ * @param args the arguments (density, qubit, probability)
+ * @param channel the channel
+ */
+static const Value *channelMapper(const SourceContext &context, const ListValue &args,
+                                  const function<void(DensityMatrix &, const size_t, const double)> &channel)
+{
+    const Value *rho = args.values().at(0);
+    const Value *qubit = args.values().at(1);
+    const Value *p = args.values().at(2);
+
+    if (rho->type() != ValueType::densityValueType || qubit->type() != ValueType::intValueType || (p->type() != ValueType::complexValueType && p->type() != ValueType::intValueType))
+    {
+        stringstream str;
+        str << "Unexpected arguments " << rho->type() << ", " << qubit->type() << ", " << p->type();
+        throw context.execException(str.str());
+    }
+    const int index = ((const IntValue *)qubit)->value();
+    if (index < 0)
+    {
+        stringstream str;
+        str << "Expected non negative qubit, got (" << index << ")";
+        throw context.execException(str.str());
+    }
+    const double probability = p->type() == ValueType::intValueType
+                                   ? ((const IntValue *)p)->value()
+                                   : ((const ComplexValue *)p)->value().real();
+    try
+    {
+        shared_ptr<DensityMatrix> result = make_shared<DensityMatrix>(((const DensityValue *)rho)->value());
+        channel(*result, index, probability);
+        return new DensityValue(context, result);
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+static const Value *depolarizeMapper(const SourceContext &context, const ListValue &args)
+{
+    return channelMapper(context, args, [](DensityMatrix &rho, const size_t qubit, const double p)
+                         { rho.depolarize(qubit, p); });
+}
+
+static const Value *dampMapper(const SourceContext &context, const ListValue &args)
+{
+    return channelMapper(context, args, [](DensityMatrix &rho, const size_t qubit, const double p)
+                         { rho.dampAmplitude(qubit, p); });
+}
+
+static const Value *dephaseMapper(const SourceContext &context, const ListValue &args)
+{
+    return channelMapper(context, args, [](DensityMatrix &rho, const size_t qubit, const double p)
+                         { rho.dephase(qubit, p); });
+}
+
+// -------- trajectories
+
+static const Value *trajectoriesMapper(const SourceContext &context, const ListValue &args)
+{
+    const Value *circuit = args.values().at(0);
+    const Value *in = args.values().at(1);
+    const Value *pDepol = args.values().at(2);
+    const Value *pDamp = args.values().at(3);
+    const Value *pDephase = args.values().at(4);
+    const Value *n = args.values().at(5);
+
+    const auto isNumber = [](const Value *value)
+    {
+        return value->type() == ValueType::complexValueType || value->type() == ValueType::intValueType;
+    };
+    const auto isBasis = [](const Value *value)
+    {
+        return value->type() == ValueType::intValueType || value->type() == ValueType::matrixValueType || value->type() == ValueType::stateValueType;
+    };
+    if (circuit->type() != ValueType::circuitValueType || !isBasis(in) || !isNumber(pDepol) || !isNumber(pDamp) || !isNumber(pDephase) || n->type() != ValueType::intValueType)
+    {
+        stringstream str;
+        str << "Unexpected arguments " << circuit->type() << ", " << in->type() << ", " << pDepol->type() << ", " << pDamp->type() << ", " << pDephase->type() << ", " << n->type();
+        throw context.execException(str.str());
+    }
+    const auto probability = [](const Value *value)
+    {
+        return value->type() == ValueType::intValueType
+                   ? ((const IntValue *)value)->value()
+                   : ((const ComplexValue *)value)->value().real();
+    };
+    const int numTrajectories = ((const IntValue *)n)->value();
+    if (numTrajectories < 1)
+    {
+        stringstream str;
+        str << "Expected at least 1 trajectory, got (" << numTrajectories << ")";
+        throw context.execException(str.str());
+    }
+    try
+    {
+        const NoiseModel noise{probability(pDepol), probability(pDamp), probability(pDephase)};
+        const TrajectorySimulator simulator(((const CircuitValue *)circuit)->value(), basisIndex(in), noise);
+        const TrajectoryResult result = simulator.run(numTrajectories);
+        // Rows of qubit probability and standard error
+        vu::ComplexVect cells;
+        for (size_t i = 0; i < simulator.numQubits(); i++)
+        {
+            cells.push_back(result.probabilities[i]);
+            cells.push_back(result.errors[i]);
+        }
+        return new MatrixValue(context, Matrix(simulator.numQubits(), 2, cells));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+static const Value *sampleMapper(const SourceContext &context, const ListValue &args, mt19937_64 &random)
+{
+    const Value *state = args.values().at(0);
+    const Value *n = args.values().at(1);
+
+    if ((state->type() != ValueType::stateValueType && state->type() != ValueType::matrixValueType) || n->type() != ValueType::intValueType)
+    {
+        stringstream str;
+        str << "Unexpected arguments " << state->type() << ", " << n->type();
+        throw context.execException(str.str());
+    }
+    const int shots = ((const IntValue *)n)->value();
+    if (shots < 1)
+    {
+        stringstream str;
+        str << "Expected at least 1 shot, got (" << shots << ")";
+        throw context.execException(str.str());
+    }
+    try
+    {
+        // Each call draws a new seed so repeated samples differ
+        const uint64_t seed = random();
+        vector<pair<uint64_t, size_t>> counts;
+        size_t numQubits;
+        if (state->type() == ValueType::stateValueType)
+        {
+            numQubits = ((const StateValue *)state)->value().numQubits();
+            counts = Sampler(((const StateValue *)state)->value()).sample(shots, seed);
+        }
+        else
+        {
+            // Dense kets are sampled by the probabilities of their cells
+            const Matrix &ket = ((const MatrixValue *)state)->value();
+            if (ket.numCols() != 1)
+            {
+                stringstream str;
+                str << "Expected ket, got (" << ket.numRows() << "x" << ket.numCols() << ")";
+                throw context.execException(str.str());
+            }
+            numQubits = vu::numBitsByState(ket.numRows() - 1);
+            counts = Sampler(ket.cells()).sample(shots, seed);
+        }
+        // The list of basis state and count tuples
+        vector<const Value *> tuples;
+        for (const auto &[index, count] : counts)
+        {
+            tuples.push_back(new ListValue(context, {basisValue(context, numQubits, index), new IntValue(context, (int)count)}));
+        }
+        return new ListValue(context, tuples);
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+static const Value *topkMapper(const SourceContext &context, const ListValue &args)
+{
+    const Value *state = args.values().at(0);
+    const Value *n = args.values().at(1);
+
+    if ((state->type() != ValueType::stateValueType && state->type() != ValueType::matrixValueType) || n->type() != ValueType::intValueType)
+    {
+        stringstream str;
+        str << "Unexpected arguments " << state->type() << ", " << n->type();
+        throw context.execException(str.str());
+    }
+    const int k = ((const IntValue *)n)->value();
+    if (k < 1)
+    {
+        stringstream str;
+        str << "Expected at least 1 basis state, got (" << k << ")";
+        throw context.execException(str.str());
+    }
+    try
+    {
+        vector<pair<uint64_t, complex<double>>> top;
+        size_t numQubits;
+        if (state->type() == ValueType::stateValueType)
+        {
+            numQubits = ((const StateValue *)state)->value().numQubits();
+            top = topK(((const StateValue *)state)->value(), k);
+        }
+        else
+        {
+            // Dense kets are scanned in place
+            const Matrix &ket = ((const MatrixValue *)state)->value();
+            if (ket.numCols() != 1)
+            {
+                stringstream str;
+                str << "Expected ket, got (" << ket.numRows() << "x" << ket.numCols() << ")";
+                throw context.execException(str.str());
+            }
+            numQubits = vu::numBitsByState(ket.numRows() - 1);
+            top = topK(ket.cells(), k);
+        }
+        // The list of basis state, amplitude and probability tuples
+        vector<const Value *> tuples;
+        for (const auto &[index, value] : top)
+        {
+            tuples.push_back(new ListValue(context, {basisValue(context, numQubits, index), new ComplexValue(context, value), new ComplexValue(context, norm(value))}));
+        }
+        return new ListValue(context, tuples);
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+static const Value *measureMapper(const SourceContext &context, const ListValue &args, mt19937_64 &random)
+{
+    const Value *state = args.values().at(0);
+    const Value *q = args.values().at(1);
+
+    if ((state->type() != ValueType::stateValueType && state->type() != ValueType::matrixValueType) || q->type() != ValueType::intValueType)
+    {
+        stringstream str;
+        str << "Unexpected arguments " << state->type() << ", " << q->type();
+        throw context.execException(str.str());
+    }
+    const int qubit = ((const IntValue *)q)->value();
+    if (qubit < 0)
+    {
+        stringstream str;
+        str << "Expected qubit >= 0, got (" << qubit << ")";
+        throw context.execException(str.str());
+    }
+    try
+    {
+        // The list of outcome and collapsed state
+        if (state->type() == ValueType::stateValueType)
+        {
+            const auto [outcome, collapsed] = measure(((const StateValue *)state)->value(), qubit, random);
+            return new ListValue(context, {new IntValue(context, outcome), new StateValue(context, collapsed)});
+        }
+        const Matrix &ket = ((const MatrixValue *)state)->value();
+        if (ket.numCols() != 1)
+        {
+            stringstream str;
+            str << "Expected ket, got (" << ket.numRows() << "x" << ket.numCols() << ")";
+            throw context.execException(str.str());
+        }
+        vu::ComplexVect cells = ket.cells();
+        const int outcome = collapse(cells, qubit, random);
+        return new ListValue(context, {new IntValue(context, outcome), new MatrixValue(context, Matrix(cells.size(), 1, cells))});
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
+
+static const Value *expectMapper(const SourceContext &context, const ListValue &args)
 {
-    return iOper.apply(context, *args.values().at(0));
-};
-
-// -------- H
+    const Value *h = args.values().at(0);
+    const Value *state = args.values().at(1);
 
-static const Value *intH(const SourceContext &context, const int arg)
-{
-    return new MatrixValue(context, H(arg));
+    if (h->type() != ValueType::pauliValueType || (state->type() != ValueType::stateValueType && state->type() != ValueType::matrixValueType))
+    {
+        stringstream str;
+        str << "Unexpected arguments " << h->type() << ", " << state->type();
+        throw context.execException(str.str());
+    }
+    const PauliSum &hamiltonian = ((const PauliValue *)h)->value();
+    if (state->type() == ValueType::stateValueType)
+    {
+        return new ComplexValue(context, hamiltonian.expectation(((const StateValue *)state)->value()));
+    }
+    const Matrix &ket = ((const MatrixValue *)state)->value();
+    if (ket.numCols() != 1)
+    {
+        stringstream str;
+        str << "Expected ket, got (" << ket.numRows() << "x" << ket.numCols() << ")";
+        throw context.execException(str.str());
+    }
+    return new ComplexValue(context, hamiltonian.expectation(ket.cells()));
 }
 
-const ChainUnaryOperator &hOper = *(new UnaryErrorOperator())
-                                       ->mapInt(intH);
+// -------- QFT, HN
 
-static const Value *hMapper(const SourceContext &context, const ListValue &args)
+/**
+ * Returns the transform gate of the qubit arguments
+ * @param context the context
+ * @param args the qubits
+ * @param factory the gate factory
+ */
+static const Value *transformGate(const SourceContext &context, const ListValue &args, const function<const Gate(const indices_t &)> &factory)
 {
-    return hOper.apply(context, *args.values().at(0));
-};
-
-// -------- S
+    const vector<const Value *> &values = args.values();
+    indices_t qubits;
+    for (const Value *value : values)
+    {
+        if (value->type() != ValueType::intValueType)
+        {
+            stringstream str;
+            str << "Unexpected arguments ";
+            for (size_t i = 0; i < values.size(); i++)
+            {
+                str << (i > 0 ? ", " : "") << values.at(i)->type();
+            }
+            throw context.execException(str.str());
+        }
+        const int qubit = ((const IntValue *)value)->value();
+        if (qubit < 0)
+        {
+            stringstream str;
+            str << "Expected qubit >= 0, got (" << qubit << ")";
+            throw context.execException(str.str());
+        }
+        qubits.push_back(qubit);
+    }
+    try
+    {
+        return new CircuitValue(context, factory(qubits));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
 
-static const Value *intS(const SourceContext &context, const int arg)
+static const Value *qftMapper(const SourceContext &context, const ListValue &args)
 {
-    return new MatrixValue(context, S(arg));
+    return transformGate(context, args, [](const indices_t &qubits)
+                         { return qftGate(qubits, false); });
 }
 
-const ChainUnaryOperator &sOper = *(new UnaryErrorOperator())
-                                       ->mapInt(intS);
-
-static const Value *sMapper(const SourceContext &context, const ListValue &args)
+static const Value *iqftMapper(const SourceContext &context, const ListValue &args)
 {
-    return sOper.apply(context, *args.values().at(0));
-};
-
-// -------- T
+    return transformGate(context, args, [](const indices_t &qubits)
+                         { return qftGate(qubits, true); });
+}
 
-static const Value *intT(const SourceContext &context, const int arg)
+static const Value *hnMapper(const SourceContext &context, const ListValue &args)
 {
-    return new MatrixValue(context, T(arg));
+    return transformGate(context, args, hnGate);
 }
 
-const ChainUnaryOperator &tOper = *(new UnaryErrorOperator())
-                                       ->mapInt(intT);
+// -------- controlled
 
-static const Value *tMapper(const SourceContext &context, const ListValue &args)
+static const Value *controlledMapper(const SourceContext &context, const ListValue &args)
 {
-    return tOper.apply(context, *args.values().at(0));
-};
+    const vector<const Value *> &values = args.values();
+    bool valid = values.at(0)->type() == ValueType::matrixValueType || values.at(0)->type() == ValueType::circuitValueType;
+    for (size_t i = 1; i < values.size(); i++)
+    {
+        valid = valid && values.at(i)->type() == ValueType::intValueType;
+    }
+    if (!valid)
+    {
+        stringstream str;
+        str << "Unexpected arguments ";
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            str << (i > 0 ? ", " : "") << values.at(i)->type();
+        }
+        throw context.execException(str.str());
+    }
+    try
+    {
+        const Matrix base = matrixOf(*values.at(0));
+        const size_t n = base.numRows();
+        if (base.numCols() != n || n < 2 || (n & (n - 1)) != 0)
+        {
+            throw invalid_argument(
+                (ostringstream() << "Expected square gate matrix of size power of 2, got (" << base.numRows() << "x" << base.numCols() << ")")
+                    .str());
+        }
+        const size_t k = vu::numBitsByState(n - 1);
+        if (values.size() < k + 2)
+        {
+            throw invalid_argument(
+                (ostringstream() << "Expected at least " << (k + 1) << " qubits, got (" << (values.size() - 1) << ")")
+                    .str());
+        }
+        indices_t controls;
+        indices_t targets;
+        for (size_t i = 1; i < values.size(); i++)
+        {
+            const int qubit = ((const IntValue *)values.at(i))->value();
+            if (qubit < 0)
+            {
+                throw invalid_argument(
+                    (ostringstream() << "Expected qubit >= 0, got (" << qubit << ")")
+                        .str());
+            }
+            (i + k < values.size() ? controls : targets).push_back(qubit);
+        }
+        return new CircuitValue(context, controlledGate(base, controls, targets));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
+}
 
-// -------- X
+// -------- oracle
 
-static const Value *intX(const SourceContext &context, const int arg)
+static const Value *oracleMapper(const SourceContext &context, const ListValue &args)
 {
-    return new MatrixValue(context, X(arg));
+    const vector<const Value *> &values = args.values();
+    bool valid = values.at(0)->type() == ValueType::matrixValueType;
+    for (size_t i = 1; i < values.size(); i++)
+    {
+        valid = valid && values.at(i)->type() == ValueType::intValueType;
+    }
+    if (!valid)
+    {
+        stringstream str;
+        str << "Unexpected arguments ";
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            str << (i > 0 ? ", " : "") << values.at(i)->type();
+        }
+        throw context.execException(str.str());
+    }
+    try
+    {
+        indices_t qubits;
+        for (size_t i = 1; i < values.size(); i++)
+        {
+            const int qubit = ((const IntValue *)values.at(i))->value();
+            if (qubit < 0)
+            {
+                throw invalid_argument(
+                    (ostringstream() << "Expected qubit >= 0, got (" << qubit << ")")
+                        .str());
+            }
+            qubits.push_back(qubit);
+        }
+        // The marked states are the non zero amplitudes of the ket
+        const Matrix &ket = ((const MatrixValue *)values.at(0))->value();
+        const size_t n = 1ULL << min(qubits.size(), (size_t)63);
+        if (ket.numCols() != 1 || ket.numRows() > n)
+        {
+            throw invalid_argument(
+                (ostringstream() << "Expected ket of at most " << n << " rows, got (" << ket.numRows() << "x" << ket.numCols() << ")")
+                    .str());
+        }
+        vector<uint64_t> marked;
+        for (size_t i = 0; i < ket.numRows(); i++)
+        {
+            if (ket.cells()[i] != 0.0)
+            {
+                marked.push_back(i);
+            }
+        }
+        return new CircuitValue(context, oracleGate(qubits, marked));
+    }
+    catch (invalid_argument ex)
+    {
+        throw context.execException(ex.what());
+    }
 }
 
-const ChainUnaryOperator &xOper = *(new UnaryErrorOperator())
-                                       ->mapInt(intX);
+// -------- batch
 
-static const Value *xMapper(const SourceContext &context, const ListValue &args)
+static const Value *batchMapper(const SourceContext &context, const ListValue &args)
 {
-    return xOper.apply(context, *args.values().at(0));
-};
+    const vector<const Value *> &values = args.values();
+    if (any_of(values.begin(), values.end(), [](const Value *value)
+               { return value->type() != ValueType::matrixValueType; }))
+    {
+        stringstream str;
+        str << "Unexpected arguments ";
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            str << (i > 0 ? ", " : "") << values.at(i)->type();
+        }
+        throw context.execException(str.str());
+    }
+    // The kets are the columns of the batch padded to the largest ket
+    size_t numRows = 0;
+    for (const Value *value : values)
+    {
+        const Matrix &ket = ((const MatrixValue *)value)->value();
+        if (ket.numCols() != 1)
+        {
+            stringstream str;
+            str << "Expected ket, got (" << ket.numRows() << "x" << ket.numCols() << ")";
+            throw context.execException(str.str());
+        }
+        numRows = max(numRows, ket.numRows());
+    }
+    const size_t numCols = values.size();
+    vu::ComplexVect cells(numRows * numCols, 0);
+    for (size_t j = 0; j < numCols; j++)
+    {
+        const Matrix &ket = ((const MatrixValue *)values.at(j))->value();
+        for (size_t i = 0; i < ket.numRows(); i++)
+        {
+            cells[Matrix::indexOf(numCols, i, j)] = ket.cells()[i];
+        }
+    }
+    return new MatrixValue(context, Matrix(numRows, numCols, cells));
+}
 
-// -------- Y
+// -------- column
 
-static const Value *intY(const SourceContext &context, const int arg)
+static const Value *matrixColumn(const SourceContext &context, const Matrix &batch, const int j)
 {
-    return new MatrixValue(context, Y(arg));
+    if (j < 0 || (size_t)j >= batch.numCols())
+    {
+        stringstream str;
+        str << "Expected column 0..." << (batch.numCols() - 1) << ", got (" << j << ")";
+        throw context.execException(str.str());
+    }
+    vu::ComplexVect cells;
+    for (size_t i = 0; i < batch.numRows(); i++)
+    {
+        cells.push_back(batch.at(i, j));
+    }
+    return new MatrixValue(context, Matrix(batch.numRows(), 1, cells));
 }
 
-const ChainUnaryOperator &yOper = *(new UnaryErrorOperator())
-                                       ->mapInt(intY);
+const ChainBinaryOperator &columnOper = *(new BinaryErrorOperator())
+                                             ->mapMatrixInt(matrixColumn);
 
-static const Value *yMapper(const SourceContext &context, const ListValue &args)
+static const Value *columnMapper(const SourceContext &context, const ListValue &args)
 {
-    return yOper.apply(context, *args.values().at(0));
-};
+    return columnOper.apply(context, *args.values().at(0), *args.values().at(1));
+}
 
-// -------- Z
+// -------- exp
 
-static const Value *intZ(const SourceContext &context, const int arg)
+static const Value *intExp(const SourceContext &context, const int arg)
 {
-    return new MatrixValue(context, Z(arg));
+    return new ComplexValue(context, exp(complex<double>(arg)));
 }
 
-const ChainUnaryOperator &zOper = *(new UnaryErrorOperator())
-                                       ->mapInt(intZ);
-
-static const Value *zMapper(const SourceContext &context, const ListValue &args)
+static const Value *complexExp(const SourceContext &context, const complex<double> &arg)
 {
-    return zOper.apply(context, *args.values().at(0));
-};
-
-// -------- CNOT
+    return new ComplexValue(context, exp(arg));
+}
 
-static const Value *intCNOT(const SourceContext &context, const int data, const int control)
+static const Value *matrixExp(const SourceContext &context, const Matrix &arg)
 {
     try
     {
-        return new MatrixValue(context, CNOT(data, control));
+        return new MatrixValue(context, expm(arg));
     }
     catch (invalid_argument ex)
     {
@@ -231,21 +1406,11 @@ static const Value *intCNOT(const SourceContext &context, const int data, const
     }
 }
 
-const ChainBinaryOperator &cnotOper = *(new BinaryErrorOperator())
-                                           ->mapIntInt(intCNOT);
-
-static const Value *cnotMapper(const SourceContext &context, const ListValue &args)
-{
-    return cnotOper.apply(context, *args.values().at(0), *args.values().at(1));
-};
-
-// -------- SWAP
-
-static const Value *intSWAP(const SourceContext &context, const int data0, const int data1)
+static const Value *pauliExp(const SourceContext &context, const PauliSum &arg)
 {
     try
     {
-        return new MatrixValue(context, SWAP(data0, data1));
+        return new MatrixValue(context, expm(arg.matrix()));
     }
     catch (invalid_argument ex)
     {
@@ -253,33 +1418,64 @@ static const Value *intSWAP(const SourceContext &context, const int data0, const
     }
 }
 
-const ChainBinaryOperator &swapOper = *(new BinaryErrorOperator())
-                                           ->mapIntInt(intSWAP);
+const ChainUnaryOperator &expOper = *(new UnaryErrorOperator())
+                                         ->mapInt(intExp)
+                                         ->mapComplex(complexExp)
+                                         ->mapMatrix(matrixExp)
+                                         ->mapPauli(pauliExp);
 
-static const Value *swapMapper(const SourceContext &context, const ListValue &args)
+static const Value *expMapper(const SourceContext &context, const ListValue &args)
 {
-    return swapOper.apply(context, *args.values().at(0), *args.values().at(1));
-};
+    return expOper.apply(context, *args.values().at(0));
+}
 
-//-----------------------
+// -------- expv
 
-static const Value *ccnotMapper(const SourceContext &context, const ListValue &args)
+static const Value *expvMapper(const SourceContext &context, const ListValue &args)
 {
-    const Value *data = args.values().at(0);
-    const Value *ctrl0 = args.values().at(1);
-    const Value *ctrl1 = args.values().at(2);
-
-    if (data->type() != ValueType::intValueType || ctrl0->type() != ValueType::intValueType || ctrl1->type() != ValueType::intValueType)
+    const Value *t = args.values().at(0);
+    const Value *h = args.values().at(1);
+    const Value *v = args.values().at(2);
+    if ((t->type() != ValueType::intValueType && t->type() != ValueType::complexValueType) ||
+        (h->type() != ValueType::matrixValueType && h->type() != ValueType::circuitValueType && h->type() != ValueType::pauliValueType) ||
+        v->type() != ValueType::matrixValueType)
     {
         stringstream str;
-        str << "Unexpected arguments " << data->type() << ", " << ctrl0->type() << ", " << ctrl1->type();
+        str << "Unexpected arguments " << t->type() << ", " << h->type() << ", " << v->type();
+        throw context.execException(str.str());
+    }
+    const complex<double> time = t->type() == ValueType::intValueType
+                                     ? complex<double>(((const IntValue *)t)->value())
+                                     : ((const ComplexValue *)t)->value();
+    const Matrix &ket = ((const MatrixValue *)v)->value();
+    if (ket.numCols() != 1)
+    {
+        stringstream str;
+        str << "Expected ket, got (" << ket.numRows() << "x" << ket.numCols() << ")";
         throw context.execException(str.str());
     }
     try
     {
-        return new MatrixValue(context, CCNOT(((const IntValue *)data)->value(),
-                                              ((const IntValue *)ctrl0)->value(),
-                                              ((const IntValue *)ctrl1)->value()));
+        vu::ComplexVect cells = ket.cells();
+        if (h->type() == ValueType::pauliValueType)
+        {
+            // Pads the ket to the qubits of the Hamiltonian
+            const PauliSum &hamiltonian = ((const PauliValue *)h)->value();
+            const size_t n = max(hamiltonian.numQubits(), vu::numBitsByState(cells.size() - 1));
+            if (n > MAX_DENSE_QUBITS)
+            {
+                throw invalid_argument(
+                    (ostringstream() << "Hamiltonian too large for dense ket: " << n << " qubits")
+                        .str());
+            }
+            cells.resize(1ULL << n, 0);
+            return new MatrixValue(context, Matrix(cells.size(), 1, expv(time, hamiltonian, cells)));
+        }
+        const Matrix op = matrixOf(*h);
+        const size_t n = max(op.numRows(), cells.size());
+        cells.resize(n, 0);
+        const Matrix a = op.numRows() < n && op.numRows() == op.numCols() ? op.extendsCross(n) : op;
+        return new MatrixValue(context, Matrix(n, 1, expv(time, a, cells)));
     }
     catch (invalid_argument ex)
     {
@@ -287,13 +1483,92 @@ static const Value *ccnotMapper(const SourceContext &context, const ListValue &a
     }
 }
 
-// -------- qbit0
+// -------- pow
 
-static const Value *intQubit0(const SourceContext &context, const int index, const int numBits)
+static const Value *powMapper(const SourceContext &context, const ListValue &args)
 {
+    const Value *x = args.values().at(0);
+    const Value *k = args.values().at(1);
+    const bool isScalar = x->type() == ValueType::intValueType || x->type() == ValueType::complexValueType;
+    if ((k->type() != ValueType::intValueType && !(isScalar && k->type() == ValueType::complexValueType)) ||
+        (!isScalar && x->type() != ValueType::matrixValueType && x->type() != ValueType::circuitValueType &&
+         x->type() != ValueType::pauliValueType))
+    {
+        stringstream str;
+        str << "Unexpected arguments " << x->type() << ", " << k->type();
+        throw context.execException(str.str());
+    }
+    auto complexOf = [](const Value *value)
+    {
+        return value->type() == ValueType::intValueType
+                   ? complex<double>(((const IntValue *)value)->value())
+                   : ((const ComplexValue *)value)->value();
+    };
+    if (k->type() == ValueType::complexValueType)
+    {
+        return new ComplexValue(context, pow(complexOf(x), complexOf(k)));
+    }
+    const int exponent = ((const IntValue *)k)->value();
+    if (isScalar)
+    {
+        if (x->type() == ValueType::intValueType && exponent >= 0)
+        {
+            // Integer power by squaring, the complex power if it overflows the integer range
+            int64_t result = 1;
+            int64_t square = ((const IntValue *)x)->value();
+            bool overflow = false;
+            for (int e = exponent; e > 0 && !overflow; e >>= 1)
+            {
+                if (e & 1)
+                {
+                    result *= square;
+                    overflow = result > INT_MAX || result < INT_MIN;
+                }
+                if (e > 1)
+                {
+                    square *= square;
+                    overflow = overflow || square > INT_MAX;
+                }
+            }
+            if (!overflow)
+            {
+                return new IntValue(context, (int)result);
+            }
+        }
+        return new ComplexValue(context, pow(complexOf(x), (double)exponent));
+    }
+    if (exponent < 0)
+    {
+        stringstream str;
+        str << "Expected non negative exponent, got (" << exponent << ")";
+        throw context.execException(str.str());
+    }
     try
     {
-        return new MatrixValue(context, qubit0(index, numBits));
+        if (x->type() == ValueType::circuitValueType)
+        {
+            // The power gate chooses between repeated and dense application on the applied state
+            return new CircuitValue(context, Circuit({powerGate(((const CircuitValue *)x)->value(), exponent)}));
+        }
+        if (x->type() == ValueType::pauliValueType)
+        {
+            const PauliSum &sum = ((const PauliValue *)x)->value();
+            PauliSum result = PauliSum(PauliString());
+            PauliSum square = sum;
+            for (int e = exponent; e > 0; e >>= 1)
+            {
+                if (e & 1)
+                {
+                    result = result * square;
+                }
+                if (e > 1)
+                {
+                    square = square * square;
+                }
+            }
+            return new PauliValue(context, make_shared<const PauliSum>(result));
+        }
+        return new MatrixValue(context, ((const MatrixValue *)x)->value().power(exponent));
     }
     catch (invalid_argument ex)
     {
@@ -301,21 +1576,60 @@ static const Value *intQubit0(const SourceContext &context, const int index, con
     }
 }
 
-const ChainBinaryOperator &qubit0Oper = *(new BinaryErrorOperator())
-                                             ->mapIntInt(intQubit0);
-
-static const Value *qubit0Mapper(const SourceContext &context, const ListValue &args)
-{
-    return qubit0Oper.apply(context, *args.values().at(0), *args.values().at(1));
-};
-
-// -------- qbit1
+// -------- ptrace
 
-static const Value *intQubit1(const SourceContext &context, const int index, const int numBits)
+static const Value *ptraceMapper(const SourceContext &context, const ListValue &args)
 {
+    const vector<const Value *> &values = args.values();
+    bool valid = values.at(0)->type() == ValueType::matrixValueType || values.at(0)->type() == ValueType::circuitValueType ||
+                 values.at(0)->type() == ValueType::densityValueType;
+    for (size_t i = 1; i < values.size(); i++)
+    {
+        valid = valid && values.at(i)->type() == ValueType::intValueType;
+    }
+    if (!valid)
+    {
+        stringstream str;
+        str << "Unexpected arguments ";
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            str << (i > 0 ? ", " : "") << values.at(i)->type();
+        }
+        throw context.execException(str.str());
+    }
     try
     {
-        return new MatrixValue(context, qubit1(index, numBits));
+        indices_t keep;
+        size_t n = 1;
+        for (size_t i = 1; i < values.size(); i++)
+        {
+            const int qubit = ((const IntValue *)values.at(i))->value();
+            if (qubit < 0)
+            {
+                throw invalid_argument(
+                    (ostringstream() << "Expected qubit >= 0, got (" << qubit << ")")
+                        .str());
+            }
+            keep.push_back(qubit);
+            n = max(n, (size_t)qubit + 1);
+        }
+        if (values.at(0)->type() == ValueType::densityValueType)
+        {
+            return new MatrixValue(context, ((const DensityValue *)values.at(0))->value().partialTrace(keep));
+        }
+        // Pads the ket or operator to the kept qubits
+        const Matrix state = matrixOf(*values.at(0));
+        if (n > MAX_DENSE_QUBITS)
+        {
+            throw invalid_argument(
+                (ostringstream() << "Qubit too large for dense state: " << n << " qubits")
+                    .str());
+        }
+        const size_t size = max(state.numRows(), (size_t)1 << n);
+        const Matrix padded = state.numRows() >= size  ? state
+                              : state.numCols() == 1 ? state.extendsRows(size)
+                                                     : state.extendsCross(size);
+        return new MatrixValue(context, partialTrace(padded, keep));
     }
     catch (invalid_argument ex)
     {
@@ -323,14 +1637,6 @@ static const Value *intQubit1(const SourceContext &context, const int index, con
     }
 }
 
-const ChainBinaryOperator &qubit1Oper = *(new BinaryErrorOperator())
-                                             ->mapIntInt(intQubit1);
-
-static const Value *qubit1Mapper(const SourceContext &context, const ListValue &args)
-{
-    return qubit1Oper.apply(context, *args.values().at(0), *args.values().at(1));
-};
-
 const map<string, FunctionDef> qc::QU_PROCESSOR_FUNCTIONS{
     {"sqrt", FunctionDef("sqrt", 1, sqrtMapper)},
     {"ary", FunctionDef("ary", 2, aryFuncMapper)},
@@ -346,9 +1652,46 @@ const map<string, FunctionDef> qc::QU_PROCESSOR_FUNCTIONS{
     {"SWAP", FunctionDef("SWAP", 2, swapMapper)},
     {"CNOT", FunctionDef("CNOT", 2, cnotMapper)},
     {"CCNOT", FunctionDef("CCNOT", 3, ccnotMapper)},
+    {"RX", FunctionDef("RX", 2, rxMapper)},
+    {"RY", FunctionDef("RY", 2, ryMapper)},
+    {"RZ", FunctionDef("RZ", 2, rzMapper)},
+    {"PHASE", FunctionDef("PHASE", 2, phaseMapper)},
+    {"U3", FunctionDef("U3", 4, u3Mapper)},
     {"qubit0", FunctionDef("qubit0", 2, qubit0Mapper)},
     {"qubit1", FunctionDef("qubit1", 2, qubit1Mapper)},
-    {"normalise", FunctionDef("normalise", 1, normMapper)}};
+    {"normalise", FunctionDef("normalise", 1, normMapper)},
+    {"norm", FunctionDef("norm", 1, norm2Mapper)},
+    {"inner", FunctionDef("inner", 2, innerMapper)},
+    {"sparse", FunctionDef("sparse", 1, sparseMapper)},
+    {"qmdd", FunctionDef("qmdd", 1, qmddMapper)},
+    {"amplitude", FunctionDef("amplitude", 3, amplitudeMapper)},
+    {"hybrid", FunctionDef("hybrid", 3, hybridMapper)},
+    {"density", FunctionDef("density", 1, densityMapper)},
+    {"depolarize", FunctionDef("depolarize", 3, depolarizeMapper)},
+    {"damp", FunctionDef("damp", 3, dampMapper)},
+    {"dephase", FunctionDef("dephase", 3, dephaseMapper)},
+    {"trajectories", FunctionDef("trajectories", 6, trajectoriesMapper)},
+    {"shard", FunctionDef("shard", 1, shardMapper)},
+    {"mapped", FunctionDef("mapped", 1, mappedMapper)},
+    {"product", FunctionDef("product", 1, productMapper)},
+    {"sample", FunctionDef("sample", 2, sampleMapper)},
+    {"topk", FunctionDef("topk", 2, topkMapper)},
+    {"measure", FunctionDef("measure", 2, measureMapper)},
+    {"PX", FunctionDef("PX", 1, pxMapper)},
+    {"PY", FunctionDef("PY", 1, pyMapper)},
+    {"PZ", FunctionDef("PZ", 1, pzMapper)},
+    {"expect", FunctionDef("expect", 2, expectMapper)},
+    {"controlled", FunctionDef("controlled", 3, controlledMapper, true)},
+    {"QFT", FunctionDef("QFT", 1, qftMapper, true)},
+    {"IQFT", FunctionDef("IQFT", 1, iqftMapper, true)},
+    {"HN", FunctionDef("HN", 1, hnMapper, true)},
+    {"oracle", FunctionDef("oracle", 2, oracleMapper, true)},
+    {"batch", FunctionDef("batch", 1, batchMapper, true)},
+    {"column", FunctionDef("column", 2, columnMapper)},
+    {"exp", FunctionDef("exp", 1, expMapper)},
+    {"expv", FunctionDef("expv", 3, expvMapper)},
+    {"pow", FunctionDef("pow", 2, powMapper)},
+    {"ptrace", FunctionDef("ptrace", 2, ptraceMapper, true)}};
 
 static const Value *intNegate(const SourceContext &context, const int state)
 {
@@ -385,18 +1728,30 @@ static const Value *matrixDagger(const SourceContext &context, const Matrix &val
     return new MatrixValue(context, value.dagger());
 }
 
+static const Value *circuitDagger(const SourceContext &context, const Circuit &value)
+{
+    return new CircuitValue(context, value.dagger());
+}
+
 const ChainUnaryOperator &int2StateOper = *(new UnaryErrorOperator())
                                                ->mapInt(int2State);
 
 const ChainUnaryOperator &daggerOper = *(new UnaryErrorOperator())
                                             ->mapInt(intDagger)
                                             ->mapComplex(complexDagger)
-                                            ->mapMatrix(matrixDagger);
+                                            ->mapMatrix(matrixDagger)
+                                            ->mapCircuit(circuitDagger);
+
+static const Value *pauliNegate(const SourceContext &context, const PauliSum &arg)
+{
+    return new PauliValue(context, make_shared<PauliSum>(-arg));
+}
 
 const ChainUnaryOperator &negOper = *(new UnaryErrorOperator())
                                          ->mapInt(intNegate)
                                          ->mapComplex(complexNegate)
-                                         ->mapMatrix(matrixNegate);
+                                         ->mapMatrix(matrixNegate)
+                                         ->mapPauli(pauliNegate);
 
 const Value *Processor::dagger(const SourceContext &source, const Value *arg)
 {
@@ -477,8 +1832,10 @@ const Value *Processor::callFunction(const SourceContext &source, const string &
 {
     try
     {
-        const FunctionMapper &mapper = QU_PROCESSOR_FUNCTIONS.at(id).mapper();
-        const Value *result = mapper(source, *(const ListValue *)args);
+        const FunctionDef &def = QU_PROCESSOR_FUNCTIONS.at(id);
+        const Value *result = def.randomMapper()
+                                  ? def.randomMapper()(source, *(const ListValue *)args, _random)
+                                  : def.mapper()(source, *(const ListValue *)args);
         delete args;
         return result;
     }
@@ -494,8 +1851,19 @@ static const Value *crossMapper(const SourceContext &source, const Matrix &left,
     return new MatrixValue(source, left.cross(right));
 };
 
+static const Value *crossStateStateMapper(const SourceContext &source, const State &left, const State &right)
+{
+    const ProductState *l = dynamic_cast<const ProductState *>(&left);
+    const ProductState *r = dynamic_cast<const ProductState *>(&right);
+    // Product states are joined without materializing the tensor product
+    return l != NULL && r != NULL
+               ? (const Value *)new StateValue(source, make_shared<ProductState>(l->cross(*r)))
+               : (const Value *)new MatrixValue(source, left.ket().cross(right.ket()));
+};
+
 static ChainBinaryOperator &crossOp = *(new BinaryErrorOperator())
-                                           ->mapMatrixMatrix(crossMapper);
+                                           ->mapMatrixMatrix(crossMapper)
+                                           ->mapStateState(crossStateStateMapper);
 
 const Value *Processor::cross(const SourceContext &source, const Value *left, const Value *right)
 {
@@ -549,6 +1917,34 @@ static const Value *mulMatrixMatrixMapper(const SourceContext &source, const Mat
     return new MatrixValue(source, left.multiply(right));
 };
 
+static const Value *mulMatrixDensityMapper(const SourceContext &source, const Matrix &left, const DensityMatrix &right)
+{
+    const size_t n = 1ULL << right.numQubits();
+    try
+    {
+        return new ComplexValue(source, right.expectation(left.numRows() < n ? left.extendsCross(n) : left));
+    }
+    catch (invalid_argument ex)
+    {
+        throw source.execException(ex.what());
+    }
+};
+
+static const Value *mulPauliPauliMapper(const SourceContext &source, const PauliSum &left, const PauliSum &right)
+{
+    return new PauliValue(source, make_shared<PauliSum>(left * right));
+};
+
+static const Value *mulComplexPauliMapper(const SourceContext &source, const complex<double> &left, const PauliSum &right)
+{
+    return new PauliValue(source, make_shared<PauliSum>(right * left));
+};
+
+static const Value *mulPauliComplexMapper(const SourceContext &source, const PauliSum &left, const complex<double> &right)
+{
+    return new PauliValue(source, make_shared<PauliSum>(left * right));
+};
+
 static ChainBinaryOperator &mulOp = *(new BinaryErrorOperator())
                                          ->mapMatrixMatrix(mulMatrixMatrixMapper)
                                          ->mapMatrixComplex(mulMatrixComplexMapper)
@@ -556,7 +1952,11 @@ static ChainBinaryOperator &mulOp = *(new BinaryErrorOperator())
                                          ->mapComplexComplex(mulComplexComplexMapper)
                                          ->mapComplexInt(mulComplexIntMapper)
                                          ->mapIntComplex(mulIntComplexMapper)
-                                         ->mapIntInt(mulIntIntMapper);
+                                         ->mapIntInt(mulIntIntMapper)
+                                         ->mapMatrixDensity(mulMatrixDensityMapper)
+                                         ->mapPauliPauli(mulPauliPauliMapper)
+                                         ->mapComplexPauli(mulComplexPauliMapper)
+                                         ->mapPauliComplex(mulPauliComplexMapper);
 
 const Value *Processor::mul(const SourceContext &source, const Value *left, const Value *right)
 {
@@ -580,6 +1980,57 @@ static const Value *mulStarMatrixMatrixMapper(const SourceContext &source, const
     return new MatrixValue(source, left * right);
 };
 
+static const Value *mulStarCircuitCircuitMapper(const SourceContext &source, const Circuit &left, const Circuit &right)
+{
+    return new CircuitValue(source, left * right);
+};
+
+static const Value *mulStarCircuitStateMapper(const SourceContext &source, const Circuit &left, const State &right)
+{
+    return new StateValue(source, right.transform(left));
+};
+
+static const Value *mulStarCircuitMatrixMapper(const SourceContext &source, const Circuit &left, const Matrix &right)
+{
+    const size_t numRows = right.numRows();
+    const size_t numCols = right.numCols();
+    if (numRows < 2 || (numRows & (numRows - 1)) != 0 || (numCols > 1 && vu::numBitsByState(numRows - 1) < left.numQubits()))
+    {
+        return new MatrixValue(source, left.matrix() * right);
+    }
+    // Applies the gate kernels to the ket or to the batch of kets as the columns of matrix
+    const size_t n = max(left.numQubits(), vu::numBitsByState(numRows - 1));
+    if (n > MAX_DENSE_QUBITS)
+    {
+        throw source.execException(
+            (ostringstream() << "Circuit too large for dense ket: " << n << " qubits")
+                .str());
+    }
+    vu::ComplexVect cells = right.cells();
+    cells.resize(numCols << n, 0);
+    left.apply(cells, numCols);
+    return new MatrixValue(source, Matrix(cells.size() / numCols, numCols, cells));
+};
+
+static const Value *mulStarMatrixStateMapper(const SourceContext &source, const Matrix &left, const State &right)
+{
+    return new StateValue(source, right.transform(matrixCircuit(left)));
+};
+
+static const Value *mulStarCircuitDensityMapper(const SourceContext &source, const Circuit &left, const DensityMatrix &right)
+{
+    shared_ptr<DensityMatrix> result = make_shared<DensityMatrix>(right);
+    result->apply(left);
+    return new DensityValue(source, result);
+};
+
+static const Value *mulStarMatrixDensityMapper(const SourceContext &source, const Matrix &left, const DensityMatrix &right)
+{
+    shared_ptr<DensityMatrix> result = make_shared<DensityMatrix>(right);
+    result->apply(matrixCircuit(left));
+    return new DensityValue(source, result);
+};
+
 static ChainBinaryOperator &mulStarOp = *(new BinaryErrorOperator())
                                              ->mapMatrixMatrix(mulStarMatrixMatrixMapper)
                                              ->mapMatrixComplex(mulMatrixComplexMapper)
@@ -587,7 +2038,16 @@ static ChainBinaryOperator &mulStarOp = *(new BinaryErrorOperator())
                                              ->mapComplexComplex(mulComplexComplexMapper)
                                              ->mapComplexInt(mulComplexIntMapper)
                                              ->mapIntComplex(mulIntComplexMapper)
-                                             ->mapIntInt(mulIntIntMapper);
+                                             ->mapIntInt(mulIntIntMapper)
+                                             ->mapCircuitCircuit(mulStarCircuitCircuitMapper)
+                                             ->mapCircuitState(mulStarCircuitStateMapper)
+                                             ->mapCircuitMatrix(mulStarCircuitMatrixMapper)
+                                             ->mapMatrixState(mulStarMatrixStateMapper)
+                                             ->mapCircuitDensity(mulStarCircuitDensityMapper)
+                                             ->mapMatrixDensity(mulStarMatrixDensityMapper)
+                                             ->mapPauliPauli(mulPauliPauliMapper)
+                                             ->mapComplexPauli(mulComplexPauliMapper)
+                                             ->mapPauliComplex(mulPauliComplexMapper);
 
 const Value *Processor::mulStar(const SourceContext &source, const Value *left, const Value *right)
 {
@@ -694,12 +2154,18 @@ static const Value *addMatrixMatrixMapper(const SourceContext &source, const Mat
     return new MatrixValue(source, left + right);
 };
 
+static const Value *addPauliPauliMapper(const SourceContext &source, const PauliSum &left, const PauliSum &right)
+{
+    return new PauliValue(source, make_shared<PauliSum>(left + right));
+};
+
 static ChainBinaryOperator &addOp = *(new BinaryErrorOperator())
                                          ->mapMatrixMatrix(addMatrixMatrixMapper)
                                          ->mapComplexComplex(addComplexComplexMapper)
                                          ->mapComplexInt(addComplexIntMapper)
                                          ->mapIntComplex(addIntComplexMapper)
-                                         ->mapIntInt(addIntIntMapper);
+                                         ->mapIntInt(addIntIntMapper)
+                                         ->mapPauliPauli(addPauliPauliMapper);
 
 const Value *Processor::add(const SourceContext &source, const Value *left, const Value *right)
 {
@@ -743,12 +2209,18 @@ static const Value *subMatrixMatrixMapper(const SourceContext &source, const Mat
     return new MatrixValue(source, left - right);
 };
 
+static const Value *subPauliPauliMapper(const SourceContext &source, const PauliSum &left, const PauliSum &right)
+{
+    return new PauliValue(source, make_shared<PauliSum>(left - right));
+};
+
 static ChainBinaryOperator &subOp = *(new BinaryErrorOperator())
                                          ->mapMatrixMatrix(subMatrixMatrixMapper)
                                          ->mapComplexComplex(subComplexComplexMapper)
                                          ->mapComplexInt(subComplexIntMapper)
                                          ->mapIntComplex(subIntComplexMapper)
-                                         ->mapIntInt(subIntIntMapper);
+                                         ->mapIntInt(subIntIntMapper)
+                                         ->mapPauliPauli(subPauliPauliMapper);
 
 const Value *Processor::sub(const SourceContext &source, const Value *left, const Value *right)
 {
@@ -0,0 +1,291 @@
+#include <sstream>
+#include <algorithm>
+
+#include "productState.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+/**
+ * The tolerance of the factorization test
+ */
+static const double FACTOR_EPSILON = 1e-12;
+
+/**
+ * Returns the factors (qubit amplitudes and rest amplitudes) of a local qubit of the amplitudes
+ * or empty rest amplitudes if the qubit is entangled
+ * @param cells the amplitudes
+ * @param bit the local qubit
+ */
+static const pair<ComplexVect, ComplexVect> factorQubit(const ComplexVect &cells, const size_t bit)
+{
+    // Splits the amplitudes by the qubit value
+    const uint64_t low = (1ULL << bit) - 1;
+    const size_t n = cells.size() / 2;
+    ComplexVect u(n), v(n);
+    double uu = 0, vv = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const uint64_t index = ((i & ~low) << 1) | (i & low);
+        u[i] = cells[index];
+        v[i] = cells[index | (1ULL << bit)];
+        uu += norm(u[i]);
+        vv += norm(v[i]);
+    }
+    if (uu == 0 && vv == 0)
+    {
+        return {{}, {}};
+    }
+    // u and v must be parallel to the rest amplitudes
+    ComplexVect rest = uu >= vv ? u : v;
+    const double scale = 1 / sqrt(max(uu, vv));
+    complex<double> a = 0, b = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        rest[i] *= scale;
+        a += conj(rest[i]) * u[i];
+        b += conj(rest[i]) * v[i];
+    }
+    const double total = uu + vv;
+    if (abs(norm(a) - uu) > FACTOR_EPSILON * total || abs(norm(b) - vv) > FACTOR_EPSILON * total)
+    {
+        return {{}, {}};
+    }
+    return {{a, b}, rest};
+}
+
+ProductState::ProductState(const Matrix &ket)
+{
+    if (ket.numCols() != 1)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected ket, got (" << ket.numRows() << "x" << ket.numCols() << ")")
+                .str());
+    }
+    _numQubits = max<size_t>(numBitsByState(ket.numRows() - 1), 1);
+    Cluster rest{{}, ket.cells()};
+    rest.cells.resize(1ULL << _numQubits, 0);
+    for (size_t i = 0; i < _numQubits; i++)
+    {
+        rest.qubits.push_back(i);
+    }
+    // Splits the factorizable qubits
+    for (size_t bit = 0; bit < rest.qubits.size() && rest.qubits.size() > 1;)
+    {
+        const auto [qubit, cells] = factorQubit(rest.cells, bit);
+        if (cells.empty())
+        {
+            bit++;
+            continue;
+        }
+        // The |0> qubits are implicit
+        if (abs(qubit[0] - 1.0) > FACTOR_EPSILON || abs(qubit[1]) > FACTOR_EPSILON)
+        {
+            _clusters.push_back(Cluster{{rest.qubits[bit]}, qubit});
+        }
+        rest.qubits.erase(rest.qubits.begin() + bit);
+        rest.cells = cells;
+    }
+    _clusters.push_back(rest);
+}
+
+const size_t ProductState::maxClusterQubits(void) const
+{
+    size_t result = 0;
+    for (const Cluster &cluster : _clusters)
+    {
+        result = max(result, cluster.qubits.size());
+    }
+    return result;
+}
+
+const ProductState ProductState::cross(const ProductState &right) const
+{
+    vector<Cluster> clusters = right._clusters;
+    for (Cluster cluster : _clusters)
+    {
+        for (size_t &qubit : cluster.qubits)
+        {
+            qubit += right._numQubits;
+        }
+        clusters.push_back(cluster);
+    }
+    return ProductState(_numQubits + right._numQubits, clusters);
+}
+
+const size_t ProductState::merge(const indices_t &qubits)
+{
+    // Collects the clusters of the qubits (new |0> clusters for the qubits out of clusters)
+    vector<size_t> selected;
+    for (const size_t qubit : qubits)
+    {
+        size_t found = _clusters.size();
+        for (size_t i = 0; i < _clusters.size(); i++)
+        {
+            if (find(_clusters[i].qubits.begin(), _clusters[i].qubits.end(), qubit) != _clusters[i].qubits.end())
+            {
+                found = i;
+                break;
+            }
+        }
+        if (found == _clusters.size())
+        {
+            _clusters.push_back(Cluster{{qubit}, {1, 0}});
+        }
+        if (find(selected.begin(), selected.end(), found) == selected.end())
+        {
+            selected.push_back(found);
+        }
+    }
+    size_t total = 0;
+    for (const size_t i : selected)
+    {
+        total += _clusters[i].qubits.size();
+    }
+    if (total > MAX_DENSE_QUBITS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Cluster too large: " << total << " qubits")
+                .str());
+    }
+    // Kronecker product of the selected clusters into the first one
+    sort(selected.begin(), selected.end());
+    Cluster &target = _clusters[selected[0]];
+    for (size_t k = 1; k < selected.size(); k++)
+    {
+        const Cluster &other = _clusters[selected[k]];
+        const size_t n = target.cells.size();
+        ComplexVect cells(n * other.cells.size());
+        for (size_t j = 0; j < other.cells.size(); j++)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                cells[j * n + i] = target.cells[i] * other.cells[j];
+            }
+        }
+        target.cells = cells;
+        target.qubits.insert(target.qubits.end(), other.qubits.begin(), other.qubits.end());
+    }
+    for (size_t k = selected.size() - 1; k > 0; k--)
+    {
+        _clusters.erase(_clusters.begin() + selected[k]);
+    }
+    return selected[0];
+}
+
+ProductState &ProductState::apply(const Gate &gate)
+{
+    _numQubits = max(_numQubits, gate.numQubits());
+    Cluster &cluster = _clusters[merge(gate.qubits())];
+    auto local = [&cluster](const indices_t &qubits)
+    {
+        indices_t result;
+        for (const size_t bit : qubits)
+        {
+            result.push_back(find(cluster.qubits.begin(), cluster.qubits.end(), bit) - cluster.qubits.begin());
+        }
+        return result;
+    };
+    gate.remap(local(gate.bits()), local(gate.controls())).apply(cluster.cells);
+    return *this;
+}
+
+ProductState &ProductState::apply(const Circuit &circuit)
+{
+    for (const Gate &gate : circuit.gates())
+    {
+        apply(gate);
+    }
+    return *this;
+}
+
+const complex<double> ProductState::at(const uint64_t index) const
+{
+    uint64_t rest = index;
+    complex<double> result = 1;
+    for (const Cluster &cluster : _clusters)
+    {
+        uint64_t local = 0;
+        for (size_t i = 0; i < cluster.qubits.size(); i++)
+        {
+            local |= ((index >> cluster.qubits[i]) & 1) << i;
+            rest &= ~(1ULL << cluster.qubits[i]);
+        }
+        result *= cluster.cells[local];
+    }
+    // The qubits out of clusters are |0>
+    return rest == 0 ? result : 0;
+}
+
+const StatePtr ProductState::project(const size_t qubit, const int outcome, const double probability) const
+{
+    // Projects only the cluster of the qubit, the qubits out of clusters are |0>
+    shared_ptr<ProductState> result = make_shared<ProductState>(*this);
+    for (Cluster &cluster : result->_clusters)
+    {
+        const auto it = find(cluster.qubits.begin(), cluster.qubits.end(), qubit);
+        if (it == cluster.qubits.end())
+        {
+            continue;
+        }
+        const uint64_t mask = 1ULL << (it - cluster.qubits.begin());
+        const uint64_t kept = outcome == 1 ? mask : 0;
+        const double scale = 1 / sqrt(probability);
+        for (uint64_t i = 0; i < cluster.cells.size(); i++)
+        {
+            cluster.cells[i] = (i & mask) == kept ? cluster.cells[i] * scale : 0;
+        }
+    }
+    return result;
+}
+
+const vector<pair<uint64_t, complex<double>>> ProductState::productAmplitudes(void) const
+{
+    vector<pair<uint64_t, complex<double>>> result{{0, 1}};
+    for (const Cluster &cluster : _clusters)
+    {
+        vector<pair<uint64_t, complex<double>>> next;
+        for (uint64_t local = 0; local < cluster.cells.size(); local++)
+        {
+            if (cluster.cells[local] == 0.0)
+            {
+                continue;
+            }
+            uint64_t offset = 0;
+            for (size_t i = 0; i < cluster.qubits.size(); i++)
+            {
+                offset |= ((local >> i) & 1) << cluster.qubits[i];
+            }
+            for (const auto &[index, value] : result)
+            {
+                next.push_back({index | offset, value * cluster.cells[local]});
+            }
+        }
+        result = next;
+    }
+    return result;
+}
+
+const vector<pair<uint64_t, complex<double>>> ProductState::amplitudes(void) const
+{
+    vector<pair<uint64_t, complex<double>>> result = productAmplitudes();
+    sort(result.begin(), result.end(), [](const auto &a, const auto &b)
+         { return a.first < b.first; });
+    return result;
+}
+
+void ProductState::forEach(const function<void(const uint64_t, const complex<double> &)> &f) const
+{
+    for (const auto &[index, value] : productAmplitudes())
+    {
+        f(index, value);
+    }
+}
+
+const StatePtr ProductState::transform(const Circuit &circuit) const
+{
+    shared_ptr<ProductState> result = make_shared<ProductState>(*this);
+    result->apply(circuit);
+    return result;
+}
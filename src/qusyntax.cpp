@@ -25,8 +25,6 @@ const RuleMap Syntax::build(void)
         "pi", // imaginary unit
         "x",  // cross-operator
         // Functions
-        "exp",
-        "pow",
         "sin",
         "cos",
         "tan",
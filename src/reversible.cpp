@@ -0,0 +1,48 @@
+#include <sstream>
+#include <algorithm>
+#include <bit>
+
+#include "reversible.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+void mx::reversible(complex<double> *cells, const size_t size, const vector<ReversibleOp> &ops, const size_t numThreads)
+{
+    uint64_t bits = 0;
+    for (const ReversibleOp &op : ops)
+    {
+        bits |= op.controls | op.flips;
+    }
+    const size_t n = bit_width(bits);
+    if (size < (1ULL << n))
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected state of at least " << n << " qubits, got " << size << " cells")
+                .str());
+    }
+    // Each operation is an involution so the inverse network is the reversed sequence
+    const vector<ReversibleOp> inverse(ops.rbegin(), ops.rend());
+    ComplexVect result(size);
+    const size_t threads = threadCount(numThreads, size, size);
+    parallelFor(size, threads, [cells, &result, &inverse](const size_t from, const size_t to)
+                {
+        for (size_t i = from; i < to; i++)
+        {
+            result[i] = cells[applyReversible(i, inverse)];
+        } });
+    parallelFor(size, threads, [cells, &result](const size_t from, const size_t to)
+                { copy(result.begin() + from, result.begin() + to, cells + from); });
+}
+
+const Matrix mx::reversibleMatrix(const size_t numQubits, const vector<ReversibleOp> &ops)
+{
+    const size_t m = 1ULL << numQubits;
+    ComplexVect cells(m * m, 0);
+    for (size_t j = 0; j < m; j++)
+    {
+        cells[Matrix::indexOf(m, applyReversible(j, ops), j)] = 1;
+    }
+    return Matrix(m, m, cells);
+}
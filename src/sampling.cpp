@@ -0,0 +1,315 @@
+#include <sstream>
+#include <atomic>
+#include <algorithm>
+#include <queue>
+
+#include "sampling.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+/**
+ * The number of shots drawn by each random stream
+ */
+static const size_t SHOTS_PER_STREAM = 1 << 16;
+
+AliasTable::AliasTable(const vector<double> &weights)
+    : _thresholds(weights.size()), _aliases(weights.size())
+{
+    const size_t n = weights.size();
+    double total = 0;
+    for (const double w : weights)
+    {
+        if (w < 0)
+        {
+            throw invalid_argument(
+                (ostringstream() << "Expected non negative weight, got (" << w << ")")
+                    .str());
+        }
+        total += w;
+    }
+    if (n == 0 || total <= 0)
+    {
+        throw invalid_argument("Expected positive weights");
+    }
+    // Splits the scaled weights in under full and over full outcomes
+    vector<double> scaled(n);
+    vector<size_t> small, large;
+    for (size_t i = 0; i < n; i++)
+    {
+        scaled[i] = weights[i] * n / total;
+        (scaled[i] < 1 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty())
+    {
+        const size_t s = small.back();
+        const size_t l = large.back();
+        small.pop_back();
+        _thresholds[s] = scaled[s];
+        _aliases[s] = l;
+        scaled[l] -= 1 - scaled[s];
+        if (scaled[l] < 1)
+        {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // The residual outcomes are full by rounding errors
+    for (const size_t i : small)
+    {
+        _thresholds[i] = 1;
+        _aliases[i] = i;
+    }
+    for (const size_t i : large)
+    {
+        _thresholds[i] = 1;
+        _aliases[i] = i;
+    }
+}
+
+const size_t AliasTable::sample(mt19937_64 &random) const
+{
+    const size_t i = uniform_int_distribution<size_t>(0, _thresholds.size() - 1)(random);
+    return uniform_real_distribution<double>(0, 1)(random) < _thresholds[i] ? i : _aliases[i];
+}
+
+/**
+ * Returns the alias table of the probabilities computed in parallel ranges
+ * @param size the number of outcomes
+ * @param numThreads the number of threads (0 for hardware concurrency)
+ * @param probability the probability of an outcome
+ */
+template <class F>
+static const AliasTable createTable(const size_t size, const size_t numThreads, const F &probability)
+{
+    vector<double> weights(size);
+    parallelFor(size, threadCount(numThreads, size, size), [&weights, &probability](const size_t from, const size_t to)
+                {
+        for (size_t i = from; i < to; i++)
+        {
+            weights[i] = probability(i);
+        } });
+    return AliasTable(weights);
+}
+
+Sampler::Sampler(const vector<pair<uint64_t, complex<double>>> &amplitudes, const size_t numThreads)
+    : _table(createTable(amplitudes.size(), numThreads, [&amplitudes](const size_t i)
+                         { return norm(amplitudes[i].second); }))
+{
+    for (const auto &[index, value] : amplitudes)
+    {
+        _states.push_back(index);
+    }
+}
+
+Sampler::Sampler(const State &state, const size_t numThreads)
+    : Sampler(state.amplitudes(), numThreads)
+{
+}
+
+Sampler::Sampler(const ComplexVect &cells, const size_t numThreads)
+    : _table(createTable(cells.size(), numThreads, [&cells](const size_t i)
+                         { return norm(cells[i]); }))
+{
+}
+
+const vector<pair<uint64_t, size_t>> Sampler::sample(const size_t shots, const uint64_t seed, const size_t numThreads) const
+{
+    if (shots < 1)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected at least 1 shot, got (" << shots << ")")
+                .str());
+    }
+    // Draws the blocks of shots in parallel, each block with its own random stream
+    const size_t numStreams = (shots + SHOTS_PER_STREAM - 1) / SHOTS_PER_STREAM;
+    const size_t n = threadCount(numThreads, numStreams, shots);
+    vector<vector<size_t>> counts(n, vector<size_t>(_table.size(), 0));
+    atomic<size_t> next(0);
+    const auto task = [this, seed, shots, numStreams, &counts, &next](const size_t t)
+    {
+        for (size_t stream = next++; stream < numStreams; stream = next++)
+        {
+            mt19937_64 random(streamSeed(seed, stream));
+            const size_t end = min(shots, (stream + 1) * SHOTS_PER_STREAM);
+            for (size_t i = stream * SHOTS_PER_STREAM; i < end; i++)
+            {
+                counts[t][_table.sample(random)]++;
+            }
+        }
+    };
+    // One range of a single task for each thread
+    parallelFor(n, n, [&task](const size_t from, const size_t to)
+                {
+        for (size_t t = from; t < to; t++)
+        {
+            task(t);
+        } });
+    // The histogram of the basis states
+    vector<pair<uint64_t, size_t>> result;
+    for (size_t i = 0; i < _table.size(); i++)
+    {
+        size_t count = 0;
+        for (const vector<size_t> &c : counts)
+        {
+            count += c[i];
+        }
+        if (count > 0)
+        {
+            // The outcomes of the dense state vectors are the basis states
+            result.push_back({_states.empty() ? i : _states[i], count});
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the random outcome of a qubit measure
+ * @param p0 the probability of outcome 0
+ * @param p1 the probability of outcome 1
+ * @param random the random generator
+ */
+static const int drawOutcome(const double p0, const double p1, mt19937_64 &random)
+{
+    if (p0 + p1 <= 0)
+    {
+        throw invalid_argument("Expected non zero state");
+    }
+    return uniform_real_distribution<double>(0, p0 + p1)(random) < p1 ? 1 : 0;
+}
+
+/**
+ * Throws the exception if the qubit is out of the register
+ * @param qubit the qubit
+ */
+static void validateQubit(const size_t qubit)
+{
+    if (qubit >= MAX_QUBITS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Qubit index out of range 0..." << MAX_QUBITS - 1 << ", got (" << qubit << ")")
+                .str());
+    }
+}
+
+const int mx::collapse(ComplexVect &cells, const size_t qubit, mt19937_64 &random)
+{
+    validateQubit(qubit);
+    const uint64_t mask = 1ULL << qubit;
+    double p0 = 0, p1 = 0;
+    for (uint64_t i = 0; i < cells.size(); i++)
+    {
+        ((i & mask) != 0 ? p1 : p0) += norm(cells[i]);
+    }
+    const int outcome = drawOutcome(p0, p1, random);
+    const uint64_t kept = outcome == 1 ? mask : 0;
+    const double scale = 1 / sqrt(outcome == 1 ? p1 : p0);
+    for (uint64_t i = 0; i < cells.size(); i++)
+    {
+        cells[i] = (i & mask) == kept ? cells[i] * scale : 0;
+    }
+    return outcome;
+}
+
+const pair<int, StatePtr> mx::measure(const State &state, const size_t qubit, mt19937_64 &random)
+{
+    validateQubit(qubit);
+    const uint64_t mask = 1ULL << qubit;
+    double p0 = 0, p1 = 0;
+    state.forEach([mask, &p0, &p1](const uint64_t index, const complex<double> &value)
+                  { ((index & mask) != 0 ? p1 : p0) += norm(value); });
+    const int outcome = drawOutcome(p0, p1, random);
+    return {outcome, state.project(qubit, outcome, outcome == 1 ? p1 : p0)};
+}
+
+typedef pair<uint64_t, complex<double>> Amplitude;
+
+/**
+ * Returns true if the amplitude precedes the other by decreasing probability and increasing basis state
+ * @param a the amplitude
+ * @param b the other amplitude
+ */
+static const bool before(const Amplitude &a, const Amplitude &b)
+{
+    const double pa = norm(a.second);
+    const double pb = norm(b.second);
+    return pa > pb || (pa == pb && a.first < b.first);
+}
+
+/**
+ * The bounded heap of the most probable amplitudes (the top is the least probable)
+ */
+typedef priority_queue<Amplitude, vector<Amplitude>, decltype(&before)> AmplitudeHeap;
+
+/**
+ * Pushes the amplitude into the heap of at most k amplitudes
+ * @param heap the heap
+ * @param k the number of amplitudes
+ * @param amplitude the amplitude
+ */
+static void pushBounded(AmplitudeHeap &heap, const size_t k, const Amplitude &amplitude)
+{
+    if (heap.size() < k)
+    {
+        heap.push(amplitude);
+    }
+    else if (k > 0 && before(amplitude, heap.top()))
+    {
+        heap.pop();
+        heap.push(amplitude);
+    }
+}
+
+/**
+ * Returns the k first amplitudes of the merged heaps
+ * @param heaps the heaps
+ * @param k the number of amplitudes
+ */
+static const vector<Amplitude> mergeHeaps(vector<AmplitudeHeap> &heaps, const size_t k)
+{
+    vector<Amplitude> result;
+    for (AmplitudeHeap &heap : heaps)
+    {
+        for (; !heap.empty(); heap.pop())
+        {
+            result.push_back(heap.top());
+        }
+    }
+    sort(result.begin(), result.end(), before);
+    if (result.size() > k)
+    {
+        result.resize(k);
+    }
+    return result;
+}
+
+const vector<pair<uint64_t, complex<double>>> mx::topK(const State &state, const size_t k)
+{
+    vector<AmplitudeHeap> heaps(1, AmplitudeHeap(before));
+    state.forEach([&heaps, k](const uint64_t index, const complex<double> &value)
+                  { pushBounded(heaps[0], k, {index, value}); });
+    return mergeHeaps(heaps, k);
+}
+
+const vector<pair<uint64_t, complex<double>>> mx::topK(const ComplexVect &cells, const size_t k, const size_t numThreads)
+{
+    const size_t n = threadCount(numThreads, cells.size(), cells.size());
+    const size_t range = (cells.size() + n - 1) / n;
+    vector<AmplitudeHeap> heaps(n, AmplitudeHeap(before));
+    // One range of the cells for each thread
+    parallelFor(n, n, [&cells, &heaps, range, k](const size_t from, const size_t to)
+                {
+        for (size_t t = from; t < to; t++)
+        {
+            const size_t end = min(cells.size(), (t + 1) * range);
+            for (size_t i = t * range; i < end; i++)
+            {
+                if (cells[i] != 0.0)
+                {
+                    pushBounded(heaps[t], k, {i, cells[i]});
+                }
+            }
+        } });
+    return mergeHeaps(heaps, k);
+}
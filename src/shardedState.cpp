@@ -0,0 +1,347 @@
+#include <sstream>
+#include <algorithm>
+
+#include "shardedState.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+/**
+ * The minimum number of local qubits (the qubits of the largest standard gate)
+ */
+static const size_t MIN_LOCAL_QUBITS = 3;
+
+ShardedState::ShardedState(const shared_ptr<Transport> &transport, const Matrix &ket)
+    : _transport(transport), _numGlobal(0)
+{
+    const size_t size = transport->size();
+    if ((size & (size - 1)) != 0)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected number of workers power of 2, got (" << size << ")")
+                .str());
+    }
+    if (ket.numCols() != 1)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected ket, got (" << ket.numRows() << "x" << ket.numCols() << ")")
+                .str());
+    }
+    while ((1ULL << _numGlobal) < size)
+    {
+        _numGlobal++;
+    }
+    _numQubits = max(numBitsByState(ket.numRows() - 1), _numGlobal + MIN_LOCAL_QUBITS);
+    if (numLocal() > MAX_DENSE_QUBITS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Shard too large: " << numLocal() << " qubits")
+                .str());
+    }
+    const size_t n = 1ULL << numLocal();
+    const uint64_t offset = (uint64_t)transport->rank() << numLocal();
+    _shard.assign(n, 0);
+    for (size_t i = 0; i < n && offset + i < ket.numRows(); i++)
+    {
+        _shard[i] = ket.cells()[offset + i];
+    }
+}
+
+/**
+ * Returns the entries received from the peer in exchange of the sent entries
+ * @param transport the transport
+ * @param peer the peer rank
+ * @param entries the sent entries
+ */
+template <class T>
+static const vector<T> exchangeEntries(Transport &transport, const size_t peer, const vector<T> &entries)
+{
+    const uint64_t count = entries.size();
+    uint64_t peerCount;
+    transport.exchange(peer, &count, &peerCount, sizeof(count));
+    vector<T> result(peerCount);
+    if (transport.rank() < peer)
+    {
+        transport.send(peer, entries.data(), count * sizeof(T));
+        transport.recv(peer, result.data(), peerCount * sizeof(T));
+    }
+    else
+    {
+        transport.recv(peer, result.data(), peerCount * sizeof(T));
+        transport.send(peer, entries.data(), count * sizeof(T));
+    }
+    return result;
+}
+
+const vector<ShardedState::Entry> ShardedState::allToAll(const vector<vector<Entry>> &entries) const
+{
+    const size_t rank = _transport->rank();
+    vector<Entry> result = entries[rank];
+    for (size_t i = 1; i < _transport->size(); i++)
+    {
+        const size_t peer = rank ^ i;
+        const vector<Entry> received = exchangeEntries(*_transport, peer, entries[peer]);
+        result.insert(result.end(), received.begin(), received.end());
+    }
+    return result;
+}
+
+void ShardedState::resize(const size_t numQubits)
+{
+    const size_t newLocal = numQubits - _numGlobal;
+    if (newLocal > MAX_DENSE_QUBITS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Shard too large: " << newLocal << " qubits")
+                .str());
+    }
+    // Sends the non zero amplitudes to the owners of the new layout
+    const uint64_t offset = (uint64_t)_transport->rank() << numLocal();
+    vector<vector<Entry>> outgoing(_transport->size());
+    for (size_t i = 0; i < _shard.size(); i++)
+    {
+        if (_shard[i] != 0.0)
+        {
+            const uint64_t index = offset + i;
+            outgoing[index >> newLocal].push_back(Entry{index, _shard[i].real(), _shard[i].imag()});
+        }
+    }
+    const vector<Entry> incoming = allToAll(outgoing);
+    const uint64_t mask = (1ULL << newLocal) - 1;
+    _shard.assign(1ULL << newLocal, 0);
+    for (const Entry &entry : incoming)
+    {
+        _shard[entry.index & mask] = complex<double>(entry.re, entry.im);
+    }
+    _numQubits = numQubits;
+}
+
+void ShardedState::swapGlobal(const size_t global, const size_t local)
+{
+    // Exchanges the amplitudes with the local qubit different from the global qubit of this rank
+    const size_t rank = _transport->rank();
+    const size_t partner = rank ^ (1ULL << global);
+    const uint64_t bit = (rank >> global) & 1;
+    const size_t half = _shard.size() / 2;
+    ComplexVect out;
+    out.reserve(half);
+    for (size_t i = 0; i < _shard.size(); i++)
+    {
+        if (((i >> local) & 1) != bit)
+        {
+            out.push_back(_shard[i]);
+        }
+    }
+    ComplexVect in(half);
+    _transport->exchange(partner, out.data(), in.data(), half * sizeof(complex<double>));
+    size_t k = 0;
+    for (size_t i = 0; i < _shard.size(); i++)
+    {
+        if (((i >> local) & 1) != bit)
+        {
+            _shard[i] = in[k++];
+        }
+    }
+}
+
+ShardedState &ShardedState::apply(const Gate &gate)
+{
+    if (gate.numQubits() > _numQubits)
+    {
+        resize(gate.numQubits());
+    }
+    const size_t n = numLocal();
+    if (gate.kernel() == GateKernel::oracle)
+    {
+        // Negates the marked amplitudes of the shard in place, the global bits are given by the rank
+        const indices_t qubits = gate.qubits();
+        const size_t k = gate.bits().size();
+        const uint64_t oracleControls = ((1ULL << gate.controls().size()) - 1) << k;
+        const uint64_t offset = (uint64_t)_transport->rank() << n;
+        for (size_t i = 0; i < _shard.size(); i++)
+        {
+            const uint64_t index = offset + i;
+            uint64_t x = 0;
+            for (size_t j = 0; j < qubits.size(); j++)
+            {
+                x |= ((index >> qubits[j]) & 1) << j;
+            }
+            if ((x & oracleControls) == oracleControls && binary_search(gate.marked().begin(), gate.marked().end(), x & ~oracleControls))
+            {
+                _shard[i] = -_shard[i];
+            }
+        }
+        return *this;
+    }
+    indices_t bits = gate.bits();
+    if (bits.size() + gate.controls().size() > n && (gate.kernel() == GateKernel::hadamard || gate.kernel() == GateKernel::fourier || gate.kernel() == GateKernel::inverseFourier))
+    {
+        // The transforms wider than the shard swap in only the qubits of their decomposed gates
+        for (const Gate &g : gate.decomposed())
+        {
+            apply(g);
+        }
+        return *this;
+    }
+    // The global controls select the whole shard (and the partner shards of the swaps)
+    const size_t rank = _transport->rank();
+    indices_t controls;
+    bool selected = true;
+    for (const size_t bit : gate.controls())
+    {
+        if (bit < n)
+        {
+            controls.push_back(bit);
+        }
+        else
+        {
+            selected = selected && ((rank >> (bit - n)) & 1) != 0;
+        }
+    }
+    if (bits.size() + controls.size() > n)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected at least " << (bits.size() + controls.size()) << " local qubits, got " << n)
+                .str());
+    }
+    if (!selected)
+    {
+        return *this;
+    }
+    // Swaps the global gate qubits with the local qubits not used by the gate
+    vector<bool> busy(n, false);
+    for (const size_t bit : bits)
+    {
+        if (bit < n)
+        {
+            busy[bit] = true;
+        }
+    }
+    for (const size_t bit : controls)
+    {
+        busy[bit] = true;
+    }
+    vector<pair<size_t, size_t>> swaps;
+    size_t local = n;
+    for (size_t &bit : bits)
+    {
+        if (bit >= n)
+        {
+            do
+            {
+                local--;
+            } while (busy[local]);
+            busy[local] = true;
+            swapGlobal(bit - n, local);
+            swaps.push_back({bit - n, local});
+            bit = local;
+        }
+    }
+    gate.remap(bits, controls).apply(_shard);
+    for (auto it = swaps.rbegin(); it != swaps.rend(); ++it)
+    {
+        swapGlobal(it->first, it->second);
+    }
+    return *this;
+}
+
+ShardedState &ShardedState::apply(const Circuit &circuit)
+{
+    for (const Gate &gate : circuit.gates())
+    {
+        apply(gate);
+    }
+    return *this;
+}
+
+const complex<double> ShardedState::at(const uint64_t index) const
+{
+    if ((index >> _numQubits) != 0)
+    {
+        return 0;
+    }
+    const size_t rank = _transport->rank();
+    const size_t owner = index >> numLocal();
+    complex<double> result = 0;
+    if (rank == owner)
+    {
+        result = _shard[index & ((1ULL << numLocal()) - 1)];
+        for (size_t peer = 0; peer < _transport->size(); peer++)
+        {
+            if (peer != rank)
+            {
+                _transport->send(peer, &result, sizeof(result));
+            }
+        }
+    }
+    else
+    {
+        _transport->recv(owner, &result, sizeof(result));
+    }
+    return result;
+}
+
+const StatePtr ShardedState::project(const size_t qubit, const int outcome, const double probability) const
+{
+    // Each worker projects its own shard, the global qubits select whole shards
+    const uint64_t mask = 1ULL << qubit;
+    const uint64_t kept = outcome == 1 ? mask : 0;
+    const uint64_t offset = (uint64_t)_transport->rank() << numLocal();
+    const double scale = 1 / sqrt(probability);
+    shared_ptr<ShardedState> result = make_shared<ShardedState>(*this);
+    for (size_t i = 0; i < result->_shard.size(); i++)
+    {
+        result->_shard[i] = ((offset + i) & mask) == kept ? result->_shard[i] * scale : 0;
+    }
+    return result;
+}
+
+const vector<pair<uint64_t, complex<double>>> ShardedState::gather(void) const
+{
+    const size_t rank = _transport->rank();
+    const uint64_t offset = (uint64_t)rank << numLocal();
+    vector<Entry> entries;
+    for (size_t i = 0; i < _shard.size(); i++)
+    {
+        if (_shard[i] != 0.0)
+        {
+            entries.push_back(Entry{offset + i, _shard[i].real(), _shard[i].imag()});
+        }
+    }
+    vector<Entry> all = entries;
+    for (size_t i = 1; i < _transport->size(); i++)
+    {
+        const vector<Entry> received = exchangeEntries(*_transport, rank ^ i, entries);
+        all.insert(all.end(), received.begin(), received.end());
+    }
+    vector<pair<uint64_t, complex<double>>> result;
+    for (const Entry &entry : all)
+    {
+        result.push_back({entry.index, complex<double>(entry.re, entry.im)});
+    }
+    return result;
+}
+
+const vector<pair<uint64_t, complex<double>>> ShardedState::amplitudes(void) const
+{
+    vector<pair<uint64_t, complex<double>>> result = gather();
+    sort(result.begin(), result.end(), [](const auto &a, const auto &b)
+         { return a.first < b.first; });
+    return result;
+}
+
+void ShardedState::forEach(const function<void(const uint64_t, const complex<double> &)> &f) const
+{
+    for (const auto &[index, value] : gather())
+    {
+        f(index, value);
+    }
+}
+
+const StatePtr ShardedState::transform(const Circuit &circuit) const
+{
+    shared_ptr<ShardedState> result = make_shared<ShardedState>(*this);
+    result->apply(circuit);
+    return result;
+}
@@ -0,0 +1,369 @@
+#include <sstream>
+#include <algorithm>
+
+#include "sparseState.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+/**
+ * The minimum number of hash table slots
+ */
+static const size_t MIN_CAPACITY = 16;
+
+/**
+ * Returns the hash of basis state index (splitmix64 finalizer)
+ * @param index the index
+ */
+static inline const uint64_t hashOf(const uint64_t index)
+{
+    uint64_t z = index + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+SparseState::SparseState(const size_t numQubits)
+    : _numQubits(numQubits), _size(0), _numRemoved(0), _entries(MIN_CAPACITY, Entry{0, 0, false, false})
+{
+}
+
+SparseState::SparseState(const Matrix &ket) : SparseState(numBitsByState(ket.numRows() - 1))
+{
+    if (ket.numCols() != 1)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected ket, got (" << ket.numRows() << "x" << ket.numCols() << ")")
+                .str());
+    }
+    const ComplexVect &cells = ket.cells();
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        add(i, cells[i]);
+    }
+}
+
+const size_t SparseState::find(const uint64_t index) const
+{
+    // Returns the slot of the index or the first free slot (reusing the removed ones)
+    const size_t mask = _entries.size() - 1;
+    size_t i = hashOf(index) & mask;
+    size_t free = _entries.size();
+    while (_entries[i].used || _entries[i].removed)
+    {
+        if (_entries[i].used && _entries[i].key == index)
+        {
+            return i;
+        }
+        if (!_entries[i].used && free == _entries.size())
+        {
+            free = i;
+        }
+        i = (i + 1) & mask;
+    }
+    return free < _entries.size() ? free : i;
+}
+
+void SparseState::rehash(const size_t capacity)
+{
+    vector<Entry> entries(capacity, Entry{0, 0, false, false});
+    entries.swap(_entries);
+    _numRemoved = 0;
+    for (const Entry &entry : entries)
+    {
+        if (entry.used)
+        {
+            _entries[find(entry.key)] = entry;
+        }
+    }
+}
+
+const complex<double> SparseState::at(const uint64_t index) const
+{
+    const Entry &entry = _entries[find(index)];
+    return entry.used ? entry.value : 0;
+}
+
+SparseState &SparseState::add(const uint64_t index, const complex<double> &value)
+{
+    size_t i = find(index);
+    if (_entries[i].used)
+    {
+        _entries[i].value += value;
+        if (norm(_entries[i].value) <= TOLERANCE)
+        {
+            // Cancelled amplitude
+            _entries[i].used = false;
+            _entries[i].removed = true;
+            _size--;
+            _numRemoved++;
+        }
+        return *this;
+    }
+    if (norm(value) <= TOLERANCE)
+    {
+        return *this;
+    }
+    if ((_size + _numRemoved + 1) * 2 > _entries.size())
+    {
+        // Doubles the table if the amplitudes fill it, otherwise clears the removed slots
+        rehash((_size + 1) * 4 > _entries.size() ? _entries.size() * 2 : _entries.size());
+        i = find(index);
+    }
+    if (_entries[i].removed)
+    {
+        _numRemoved--;
+    }
+    _entries[i] = Entry{index, value, true, false};
+    _size++;
+    return *this;
+}
+
+SparseState &SparseState::apply(const Gate &gate)
+{
+    if (gate.kernel() == GateKernel::hadamard || gate.kernel() == GateKernel::fourier || gate.kernel() == GateKernel::inverseFourier)
+    {
+        // The transforms split in gates of at most 2 qubits without dense expansion
+        for (const Gate &g : gate.decomposed())
+        {
+            apply(g);
+        }
+        return *this;
+    }
+    if (gate.kernel() == GateKernel::oracle)
+    {
+        // Negates in place the marked entries with all the controls set
+        const indices_t qubits = gate.qubits();
+        const size_t k = gate.bits().size();
+        const uint64_t controlMask = ((1ULL << gate.controls().size()) - 1) << k;
+        _numQubits = max(_numQubits, gate.numQubits());
+        for (Entry &entry : _entries)
+        {
+            if (!entry.used)
+            {
+                continue;
+            }
+            uint64_t x = 0;
+            for (size_t i = 0; i < qubits.size(); i++)
+            {
+                x |= ((entry.key >> qubits[i]) & 1) << i;
+            }
+            if ((x & controlMask) == controlMask && binary_search(gate.marked().begin(), gate.marked().end(), x & ~controlMask))
+            {
+                entry.value = -entry.value;
+            }
+        }
+        return *this;
+    }
+    if (gate.kernel() == GateKernel::reversible)
+    {
+        // Remaps the basis states by the bit operations
+        const vector<ReversibleOp> ops = reversibleOps(gate);
+        _numQubits = max(_numQubits, gate.numQubits());
+        SparseState result(_numQubits);
+        for (const Entry &entry : _entries)
+        {
+            if (entry.used)
+            {
+                result.add(applyReversible(entry.key, ops), entry.value);
+            }
+        }
+        _entries.swap(result._entries);
+        _size = result._size;
+        _numRemoved = result._numRemoved;
+        return *this;
+    }
+    if (gate.kernel() == GateKernel::power && gate.controls().empty())
+    {
+        // Repeats the circuit keeping the state sparse
+        const vector<Gate> gates = gate.repeated();
+        for (uint64_t i = 0; i < gate.exponent(); i++)
+        {
+            for (const Gate &g : gates)
+            {
+                apply(g);
+            }
+        }
+        return *this;
+    }
+    if (gate.kernel() != GateKernel::matrix)
+    {
+        return apply(gate.expand());
+    }
+    const indices_t &bits = gate.bits();
+    const size_t k = bits.size();
+    const size_t n = 1ULL << k;
+    const ComplexVect &cells = gate.base().cells();
+
+    // Register offsets of each gate basis state
+    vector<uint64_t> offsets(n, 0);
+    for (size_t j = 0; j < n; j++)
+    {
+        for (size_t i = 0; i < k; i++)
+        {
+            if ((j >> i) & 1)
+            {
+                offsets[j] |= 1ULL << bits[i];
+            }
+        }
+    }
+    const uint64_t mask = offsets[n - 1];
+    uint64_t controlMask = 0;
+    for (const size_t bit : gate.controls())
+    {
+        controlMask |= 1ULL << bit;
+    }
+    auto local = [&bits, k](const uint64_t index)
+    {
+        size_t j = 0;
+        for (size_t i = 0; i < k; i++)
+        {
+            j |= ((index >> bits[i]) & 1) << i;
+        }
+        return j;
+    };
+
+    _numQubits = max(_numQubits, gate.numQubits());
+    SparseState result(_numQubits);
+    if (gate.isPermutation())
+    {
+        // Remaps the basis states
+        vector<size_t> rows(n, 0);
+        ComplexVect factors(n, 0);
+        for (size_t j = 0; j < n; j++)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                const complex<double> &cell = cells[Matrix::indexOf(n, i, j)];
+                if (norm(cell) != 0)
+                {
+                    rows[j] = i;
+                    factors[j] = cell;
+                }
+            }
+        }
+        for (const Entry &entry : _entries)
+        {
+            if (entry.used && (entry.key & controlMask) != controlMask)
+            {
+                // Not selected by the controls
+                result.add(entry.key, entry.value);
+            }
+            else if (entry.used)
+            {
+                const size_t j = local(entry.key);
+                result.add((entry.key & ~mask) | offsets[rows[j]], entry.value * factors[j]);
+            }
+        }
+    }
+    else
+    {
+        // Splits the amplitudes of each group of basis states sharing the not gate qubits
+        SparseState done(_numQubits);
+        ComplexVect in(n, 0);
+        for (const Entry &entry : _entries)
+        {
+            if (!entry.used)
+            {
+                continue;
+            }
+            if ((entry.key & controlMask) != controlMask)
+            {
+                // Not selected by the controls
+                result.add(entry.key, entry.value);
+                continue;
+            }
+            const uint64_t rest = entry.key & ~mask;
+            if (done.at(rest) != 0.0)
+            {
+                continue;
+            }
+            done.add(rest, 1);
+            for (size_t j = 0; j < n; j++)
+            {
+                in[j] = at(rest | offsets[j]);
+            }
+            for (size_t i = 0; i < n; i++)
+            {
+                complex<double> value;
+                for (size_t j = 0; j < n; j++)
+                {
+                    value += cells[Matrix::indexOf(n, i, j)] * in[j];
+                }
+                result.add(rest | offsets[i], value);
+            }
+        }
+    }
+    _entries.swap(result._entries);
+    _size = result._size;
+    _numRemoved = result._numRemoved;
+    return *this;
+}
+
+SparseState &SparseState::apply(const Circuit &circuit)
+{
+    for (const Gate &gate : circuit.gates())
+    {
+        apply(gate);
+    }
+    return *this;
+}
+
+const StatePtr SparseState::transform(const Circuit &circuit) const
+{
+    shared_ptr<SparseState> result = make_shared<SparseState>(*this);
+    result->apply(circuit);
+    return result;
+}
+
+const StatePtr SparseState::project(const size_t qubit, const int outcome, const double probability) const
+{
+    // Frees the slots of the other outcome and rescales the kept amplitudes in place
+    const uint64_t mask = 1ULL << qubit;
+    const uint64_t kept = outcome == 1 ? mask : 0;
+    const double scale = 1 / sqrt(probability);
+    shared_ptr<SparseState> result = make_shared<SparseState>(*this);
+    for (Entry &entry : result->_entries)
+    {
+        if (entry.used && (entry.key & mask) == kept)
+        {
+            entry.value *= scale;
+        }
+        else if (entry.used)
+        {
+            entry.used = false;
+            entry.removed = true;
+            result->_size--;
+            result->_numRemoved++;
+        }
+    }
+    return result;
+}
+
+const vector<pair<uint64_t, complex<double>>> SparseState::amplitudes(void) const
+{
+    vector<pair<uint64_t, complex<double>>> result;
+    result.reserve(_size);
+    for (const Entry &entry : _entries)
+    {
+        if (entry.used && norm(entry.value) > TOLERANCE)
+        {
+            result.push_back({entry.key, entry.value});
+        }
+    }
+    sort(result.begin(), result.end(), [](const auto &a, const auto &b)
+         { return a.first < b.first; });
+    return result;
+}
+
+void SparseState::forEach(const function<void(const uint64_t, const complex<double> &)> &f) const
+{
+    for (const Entry &entry : _entries)
+    {
+        if (entry.used && norm(entry.value) > TOLERANCE)
+        {
+            f(entry.key, entry.value);
+        }
+    }
+}
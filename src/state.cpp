@@ -0,0 +1,100 @@
+#include <sstream>
+
+#include "state.h"
+#include "sparseState.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+const Matrix State::ket(void) const
+{
+    const size_t n = numQubits();
+    if (n > MAX_DENSE_QUBITS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "State too large for dense ket: " << n << " qubits")
+                .str());
+    }
+    ComplexVect cells(1ULL << n, 0);
+    for (const auto &[i, value] : amplitudes())
+    {
+        cells[i] = value;
+    }
+    return Matrix(cells.size(), 1, cells);
+}
+
+void State::forEach(const function<void(const uint64_t, const complex<double> &)> &f) const
+{
+    for (const auto &[i, value] : amplitudes())
+    {
+        f(i, value);
+    }
+}
+
+const StatePtr State::project(const size_t qubit, const int outcome, const double probability) const
+{
+    // Collects the kept amplitudes in a sparse state
+    const uint64_t mask = 1ULL << qubit;
+    const uint64_t kept = outcome == 1 ? mask : 0;
+    const double scale = 1 / sqrt(probability);
+    shared_ptr<SparseState> result = make_shared<SparseState>(numQubits());
+    forEach([result, mask, kept, scale](const uint64_t index, const complex<double> &value)
+            {
+        if ((index & mask) == kept)
+        {
+            result->add(index, value * scale);
+        } });
+    return result;
+}
+
+const Circuit mx::matrixCircuit(const Matrix &matrix)
+{
+    const size_t n = matrix.numRows();
+    if (n != matrix.numCols() || n < 2 || (n & (n - 1)) != 0)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected square matrix of size power of 2, got (" << matrix.numRows() << "x" << matrix.numCols() << ")")
+                .str());
+    }
+    indices_t bits;
+    for (size_t i = 0; (1ULL << i) < n; i++)
+    {
+        bits.push_back(i);
+    }
+    return Circuit(Gate("M", matrix, bits));
+}
+
+ostream &operator<<(ostream &out, const State &state)
+{
+    const auto amplitudes = state.amplitudes();
+    if (amplitudes.empty())
+    {
+        return out << "(0.0) |" << (~0ULL >> (64 - state.numQubits())) << ">";
+    }
+    bool first = true;
+    for (const auto &[i, cell] : amplitudes)
+    {
+        if (!first)
+        {
+            out << " + ";
+        }
+        first = false;
+        if (cell.imag() == 0 && cell.real() == 1)
+        {
+            out << "|" << i << ">";
+        }
+        else
+        {
+            out << "(" << fmt(cell) << ") |" << i << ">";
+        }
+    }
+    return out;
+}
+
+const string to_string(const State &state)
+{
+    stringstream stream;
+    stream << state;
+    return stream.str();
+}
@@ -0,0 +1,381 @@
+#include <sstream>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <unordered_map>
+
+#include "tensorNetwork.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+/**
+ * Returns the positions of labels in the index labels
+ * @param indices the index labels
+ * @param labels the labels
+ */
+static const indices_t positionsOf(const vector<uint32_t> &indices, const vector<uint32_t> &labels)
+{
+    indices_t result;
+    for (const uint32_t label : labels)
+    {
+        result.push_back(find(indices.begin(), indices.end(), label) - indices.begin());
+    }
+    return result;
+}
+
+/**
+ * Returns the bits of offset at the positions packed in a value
+ * @param offset the offset
+ * @param positions the bit positions
+ */
+static inline const size_t gather(const size_t offset, const indices_t &positions)
+{
+    size_t result = 0;
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+        result |= ((offset >> positions[i]) & 1) << i;
+    }
+    return result;
+}
+
+Tensor::Tensor(const vector<uint32_t> &indices, const ComplexVect &cells) : _indices(indices), _cells(cells)
+{
+    if (indices.size() >= 64 || cells.size() != (1ULL << indices.size()))
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected " << indices.size() << " indices tensor, got " << cells.size() << " cells")
+                .str());
+    }
+}
+
+const Tensor Tensor::contract(const Tensor &other) const
+{
+    vector<uint32_t> shared;
+    vector<uint32_t> freeLeft;
+    vector<uint32_t> freeRight;
+    for (const uint32_t label : _indices)
+    {
+        if (find(other._indices.begin(), other._indices.end(), label) != other._indices.end())
+        {
+            shared.push_back(label);
+        }
+        else
+        {
+            freeLeft.push_back(label);
+        }
+    }
+    for (const uint32_t label : other._indices)
+    {
+        if (find(shared.begin(), shared.end(), label) == shared.end())
+        {
+            freeRight.push_back(label);
+        }
+    }
+    if (freeLeft.size() + freeRight.size() > MAX_DENSE_QUBITS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Tensor too large: " << (freeLeft.size() + freeRight.size()) << " indices")
+                .str());
+    }
+
+    // Reshapes the tensors to matrices (free left x shared) and (shared x free right)
+    const size_t numRows = 1ULL << freeLeft.size();
+    const size_t numInner = 1ULL << shared.size();
+    const size_t numCols = 1ULL << freeRight.size();
+    const indices_t leftRows = positionsOf(_indices, freeLeft);
+    const indices_t leftInner = positionsOf(_indices, shared);
+    const indices_t rightInner = positionsOf(other._indices, shared);
+    const indices_t rightCols = positionsOf(other._indices, freeRight);
+    ComplexVect a(_cells.size());
+    for (size_t i = 0; i < _cells.size(); i++)
+    {
+        a[gather(i, leftRows) * numInner + gather(i, leftInner)] = _cells[i];
+    }
+    ComplexVect b(other._cells.size());
+    for (size_t i = 0; i < other._cells.size(); i++)
+    {
+        b[gather(i, rightInner) * numCols + gather(i, rightCols)] = other._cells[i];
+    }
+    ComplexVect cells;
+    blockMul(cells, a, b, numRows, numInner, numCols);
+
+    // The row major result has the right free indices in the low bits
+    vector<uint32_t> indices(freeRight);
+    indices.insert(indices.end(), freeLeft.begin(), freeLeft.end());
+    return Tensor(indices, cells);
+}
+
+/**
+ * Appends the tensor of the gate matrix moving the gate wires to new labels
+ * @param tensors the tensors
+ * @param wires the current labels of the qubit wires
+ * @param label the next free label
+ * @param gate the expanded gate
+ */
+static void pushGate(vector<Tensor> &tensors, vector<uint32_t> &wires, uint32_t &label, const Gate &gate)
+{
+    // Input wires are the low indices, output wires are the high indices
+    const indices_t &bits = gate.bits();
+    const size_t k = bits.size();
+    const Matrix &base = gate.base();
+    vector<uint32_t> indices;
+    for (const size_t bit : bits)
+    {
+        indices.push_back(wires[bit]);
+    }
+    for (const size_t bit : bits)
+    {
+        wires[bit] = label++;
+        indices.push_back(wires[bit]);
+    }
+    ComplexVect cells(base.cells().size());
+    for (size_t row = 0; row < base.numRows(); row++)
+    {
+        for (size_t col = 0; col < base.numCols(); col++)
+        {
+            cells[col | (row << k)] = base.at(row, col);
+        }
+    }
+    tensors.push_back(Tensor(indices, cells));
+}
+
+/**
+ * Appends the diagonal tensors of the phase oracle moving the gate wires to new labels.
+ * Each marked value negates the amplitudes by a chain of rank 4 tensors (in, out, matched before, matched after)
+ * so the tensors grow linearly with the number of qubits
+ * @param tensors the tensors
+ * @param wires the current labels of the qubit wires
+ * @param label the next free label
+ * @param gate the oracle gate
+ */
+static void pushOracle(vector<Tensor> &tensors, vector<uint32_t> &wires, uint32_t &label, const Gate &gate)
+{
+    // The controls extend the register with the marked values having all the controls set
+    const indices_t qubits = gate.qubits();
+    const uint64_t controlMask = ((1ULL << gate.controls().size()) - 1) << gate.bits().size();
+    for (const uint64_t marked : gate.marked())
+    {
+        const uint64_t value = marked | controlMask;
+        uint32_t matched = label++;
+        tensors.push_back(Tensor({matched}, {0, 1}));
+        for (size_t i = 0; i < qubits.size(); i++)
+        {
+            const uint32_t in = wires[qubits[i]];
+            const uint32_t out = label++;
+            const uint32_t next = label++;
+            const size_t bit = (value >> i) & 1;
+            ComplexVect cells(16, 0);
+            for (size_t b = 0; b < 2; b++)
+            {
+                for (size_t before = 0; before < 2; before++)
+                {
+                    const size_t after = before & (b == bit ? 1 : 0);
+                    cells[b | (b << 1) | (before << 2) | (after << 3)] = 1;
+                }
+            }
+            tensors.push_back(Tensor({in, out, matched, next}, cells));
+            wires[qubits[i]] = out;
+            matched = next;
+        }
+        tensors.push_back(Tensor({matched}, {1, -1}));
+    }
+}
+
+const TensorNetwork TensorNetwork::amplitude(const Circuit &circuit, const uint64_t out, const uint64_t in)
+{
+    const size_t n = max(circuit.numQubits(), max(numBitsByState(out), numBitsByState(in)));
+    vector<Tensor> tensors;
+    vector<uint32_t> wires;
+    uint32_t label = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        wires.push_back(label++);
+        tensors.push_back(((in >> i) & 1) != 0
+                              ? Tensor({wires[i]}, {0, 1})
+                              : Tensor({wires[i]}, {1, 0}));
+    }
+    for (const Gate &circuitGate : circuit.gates())
+    {
+        // The transforms are contracted by their 1 and 2 qubit gates
+        for (const Gate &decomposedGate : circuitGate.decomposed())
+        {
+            if (decomposedGate.kernel() == GateKernel::oracle)
+            {
+                pushOracle(tensors, wires, label, decomposedGate);
+            }
+            else
+            {
+                pushGate(tensors, wires, label, decomposedGate.expand());
+            }
+        }
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        tensors.push_back(((out >> i) & 1) != 0
+                              ? Tensor({wires[i]}, {0, 1})
+                              : Tensor({wires[i]}, {1, 0}));
+    }
+    return TensorNetwork(tensors);
+}
+
+const ContractionPath TensorNetwork::search(const double temperature, const uint64_t seed) const
+{
+    vector<vector<uint32_t>> sets;
+    unordered_map<uint32_t, vector<size_t>> owners;
+    double peakSize = 0;
+    for (size_t i = 0; i < _tensors.size(); i++)
+    {
+        vector<uint32_t> set(_tensors[i].indices());
+        sort(set.begin(), set.end());
+        for (const uint32_t label : set)
+        {
+            owners[label].push_back(i);
+        }
+        sets.push_back(set);
+        peakSize = max(peakSize, exp2(set.size()));
+    }
+    vector<bool> alive(sets.size(), true);
+    mt19937_64 random(seed);
+    vector<pair<size_t, size_t>> steps;
+    double flops = 0;
+    for (size_t step = 1; step < _tensors.size(); step++)
+    {
+        // Collects the pairs of connected tensors
+        vector<pair<size_t, size_t>> pairs;
+        for (size_t i = 0; i < sets.size(); i++)
+        {
+            if (alive[i])
+            {
+                for (const uint32_t label : sets[i])
+                {
+                    for (const size_t j : owners[label])
+                    {
+                        if (j > i)
+                        {
+                            pairs.push_back({i, j});
+                        }
+                    }
+                }
+            }
+        }
+        sort(pairs.begin(), pairs.end());
+        pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
+        if (pairs.empty())
+        {
+            // Outer product of the two smallest disconnected tensors
+            vector<size_t> ids;
+            for (size_t i = 0; i < sets.size(); i++)
+            {
+                if (alive[i])
+                {
+                    ids.push_back(i);
+                }
+            }
+            sort(ids.begin(), ids.end(), [&sets](const size_t a, const size_t b)
+                 { return sets[a].size() < sets[b].size(); });
+            pairs.push_back({min(ids[0], ids[1]), max(ids[0], ids[1])});
+        }
+
+        // Scores the size growth of each pair
+        vector<vector<uint32_t>> results;
+        vector<double> scores;
+        double minScore = INFINITY;
+        for (const auto &[i, j] : pairs)
+        {
+            vector<uint32_t> result;
+            set_symmetric_difference(sets[i].begin(), sets[i].end(), sets[j].begin(), sets[j].end(), back_inserter(result));
+            const double score = exp2(result.size()) - exp2(sets[i].size()) - exp2(sets[j].size());
+            minScore = min(minScore, score);
+            results.push_back(result);
+            scores.push_back(score);
+        }
+        size_t chosen = min_element(scores.begin(), scores.end()) - scores.begin();
+        if (temperature > 0 && pairs.size() > 1)
+        {
+            const double scale = temperature * max(1.0, abs(minScore));
+            vector<double> weights;
+            for (const double score : scores)
+            {
+                weights.push_back(exp(-(score - minScore) / scale));
+            }
+            chosen = discrete_distribution<size_t>(weights.begin(), weights.end())(random);
+        }
+
+        const auto [i, j] = pairs[chosen];
+        vector<uint32_t> all;
+        set_union(sets[i].begin(), sets[i].end(), sets[j].begin(), sets[j].end(), back_inserter(all));
+        flops += exp2(all.size());
+        peakSize = max(peakSize, exp2(results[chosen].size()));
+
+        const size_t id = sets.size();
+        for (const uint32_t label : all)
+        {
+            vector<size_t> &owner = owners[label];
+            owner.erase(remove_if(owner.begin(), owner.end(), [i, j](const size_t k)
+                                  { return k == i || k == j; }),
+                        owner.end());
+        }
+        for (const uint32_t label : results[chosen])
+        {
+            owners[label].push_back(id);
+        }
+        sets.push_back(results[chosen]);
+        alive.push_back(true);
+        alive[i] = false;
+        alive[j] = false;
+        steps.push_back({i, j});
+    }
+    return ContractionPath(steps, flops, peakSize);
+}
+
+const ContractionPath TensorNetwork::greedyPath(void) const
+{
+    return search(0, 0);
+}
+
+const ContractionPath TensorNetwork::optimizePath(const size_t trials, const uint64_t seed) const
+{
+    ContractionPath best = greedyPath();
+    for (size_t i = 0; i < trials; i++)
+    {
+        const ContractionPath path = search(1, seed + i);
+        if (path < best)
+        {
+            best = path;
+        }
+    }
+    return best;
+}
+
+const complex<double> TensorNetwork::contract(const ContractionPath &path) const
+{
+    vector<shared_ptr<const Tensor>> tensors;
+    for (const Tensor &tensor : _tensors)
+    {
+        tensors.push_back(make_shared<Tensor>(tensor));
+    }
+    for (const auto &[i, j] : path.steps())
+    {
+        tensors.push_back(make_shared<Tensor>(tensors.at(i)->contract(*tensors.at(j))));
+        // Releases the contracted tensors
+        tensors[i].reset();
+        tensors[j].reset();
+    }
+    const Tensor &result = *tensors.back();
+    if (result.rank() != 0)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected scalar network, got " << result.rank() << " open indices")
+                .str());
+    }
+    return result.cells()[0];
+}
+
+const complex<double> mx::tensorAmplitude(const Circuit &circuit, const uint64_t out, const uint64_t in)
+{
+    const TensorNetwork network = TensorNetwork::amplitude(circuit, out, in);
+    return network.contract(network.optimizePath());
+}
@@ -0,0 +1,253 @@
+#include <gtest/gtest.h>
+
+#include "circuit.h"
+#include "testUtils.h"
+
+#define HALF_SQRT2 (sqrt(2) / 2)
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+using namespace tu;
+
+TEST(testCircuit, gateMatrix)
+{
+    EXPECT_EQ(to_string(X(1)), to_string(xGate(1).matrix()));
+    EXPECT_EQ(to_string(H(0)), to_string(hGate(0).matrix()));
+    EXPECT_EQ(to_string(CNOT(1, 0)), to_string(cnotGate(1, 0).matrix()));
+    EXPECT_EQ(to_string(SWAP(0, 2)), to_string(swapGate(0, 2).matrix()));
+    EXPECT_EQ(to_string(CCNOT(3, 0, 1)), to_string(ccnotGate(3, 0, 1).matrix()));
+}
+
+TEST(testCircuit, gateNumQubits)
+{
+    EXPECT_EQ(1, xGate(0).numQubits());
+    EXPECT_EQ(3, cnotGate(0, 2).numQubits());
+    EXPECT_EQ(61, ccnotGate(60, 0, 1).numQubits());
+}
+
+TEST(testCircuit, gateInvalid)
+{
+    EXPECT_THROW({
+        try
+        {
+            cnotGate(1, 1);
+        }
+        catch (invalid_argument ex)
+        {
+            EXPECT_STREQ("Expected all different indices [1, 1]", ex.what());
+            throw;
+        } }, invalid_argument);
+    EXPECT_THROW(xGate(64), invalid_argument);
+    EXPECT_THROW(Gate("G", X_GATE, {0, 1}), invalid_argument);
+}
+
+TEST(testCircuit, isPermutation)
+{
+    EXPECT_TRUE(xGate(0).isPermutation());
+    EXPECT_TRUE(yGate(0).isPermutation());
+    EXPECT_TRUE(zGate(0).isPermutation());
+    EXPECT_TRUE(tGate(0).isPermutation());
+    EXPECT_TRUE(cnotGate(0, 1).isPermutation());
+    EXPECT_TRUE(ccnotGate(0, 1, 2).isPermutation());
+    EXPECT_FALSE(hGate(0).isPermutation());
+}
+
+TEST(testCircuit, product)
+{
+    const Circuit ha = Circuit(cnotGate(1, 0)) * Circuit(cnotGate(2, 1)) * Circuit(ccnotGate(3, 1, 2)) * Circuit(cnotGate(1, 0)) * Circuit(ccnotGate(3, 0, 1));
+    const Matrix exp = CNOT(1, 0) * CNOT(2, 1) * CCNOT(3, 1, 2) * CNOT(1, 0) * CCNOT(3, 0, 1);
+
+    EXPECT_EQ(5, ha.gates().size());
+    EXPECT_EQ("CCNOT(3,0,1)", ha.gates().front().name());
+    EXPECT_EQ(4, ha.numQubits());
+    EXPECT_EQ(to_string(exp), to_string(ha.matrix()));
+}
+
+TEST(testCircuit, dagger)
+{
+    const Circuit c = Circuit(sGate(0)) * Circuit(hGate(1));
+    EXPECT_EQ(to_string(c.matrix().dagger()), to_string(c.dagger().matrix()));
+    EXPECT_EQ("S(0)^", c.dagger().gates().front().name());
+}
+
+TEST(testCircuit, tostring)
+{
+    EXPECT_EQ(to_string(X(0)), to_string(Circuit(xGate(0))));
+    EXPECT_EQ("CNOT(60,0) * X(2)", to_string(Circuit(cnotGate(60, 0)) * Circuit(xGate(2))));
+}
+
+TEST(testCircuit, rotations)
+{
+    const double theta = 0.3;
+    const double c = cos(theta / 2);
+    const double s = sin(theta / 2);
+    EXPECT_EQ(to_string(Matrix(2, 2, {c, complex<double>(0, -s), complex<double>(0, -s), c})), to_string(rxGate(0, theta).base()));
+    EXPECT_EQ(to_string(Matrix(2, 2, {c, -s, s, c})), to_string(ryGate(0, theta).base()));
+    EXPECT_EQ(to_string(Matrix(2, 2, {polar(1.0, -theta / 2), 0, 0, polar(1.0, theta / 2)})), to_string(rzGate(0, theta).base()));
+    EXPECT_EQ(to_string(Matrix(2, 2, {1, 0, 0, polar(1.0, theta)})), to_string(phaseGate(0, theta).base()));
+    EXPECT_EQ("RX(2,0.3)", rxGate(2, theta).name());
+    EXPECT_EQ("U3(0,0.3,0.1,0.2)", u3Gate(0, theta, 0.1, 0.2).name());
+    // U3(theta, -pi/2, pi/2) = RX(theta)
+    const Matrix u3 = u3Gate(0, theta, -M_PI / 2, M_PI / 2).base();
+    const Matrix rx = rxGate(0, theta).base();
+    for (size_t i = 0; i < 4; i++)
+    {
+        EXPECT_NEAR(0, abs(u3.cells()[i] - rx.cells()[i]), 1e-12);
+    }
+}
+
+TEST(testCircuit, diagonal)
+{
+    EXPECT_TRUE(rzGate(0, 0.3).isDiagonal());
+    EXPECT_TRUE(phaseGate(0, 0.3).isDiagonal());
+    EXPECT_TRUE(zGate(1).isDiagonal());
+    EXPECT_FALSE(cnotGate(0, 1).isDiagonal());
+    EXPECT_FALSE(rxGate(0, 0.3).isDiagonal());
+}
+
+TEST(testCircuit, applySingle)
+{
+    ComplexVect cells;
+    for (size_t i = 0; i < 8; i++)
+    {
+        cells.push_back(complex<double>(i + 1, 1.0 - i));
+    }
+    for (const Gate &gate : {rxGate(1, 0.3), ryGate(2, 0.7), rzGate(0, 1.1), phaseGate(1, 0.4), u3Gate(2, 0.5, 0.6, 0.7)})
+    {
+        const size_t bit = gate.bits()[0];
+        const ComplexVect &base = gate.base().cells();
+        ComplexVect result = cells;
+        gate.apply(result);
+        for (size_t i = 0; i < 8; i++)
+        {
+            const size_t row = (i >> bit) & 1;
+            const complex<double> expected = base[row * 2 + row] * cells[i] + base[row * 2 + 1 - row] * cells[i ^ (1ULL << bit)];
+            EXPECT_NEAR(0, abs(expected - result[i]), 1e-12) << gate.name();
+        }
+    }
+}
+
+TEST(testCircuit, controlled)
+{
+    const Gate cx = controlledGate(X_GATE, {1}, {0});
+    EXPECT_EQ("C1U(0;1)", cx.name());
+    EXPECT_EQ(2, cx.numQubits());
+    EXPECT_EQ(to_string(CNOT(0, 1)), to_string(cx.matrix()));
+    EXPECT_EQ(to_string(CCNOT(3, 0, 1)), to_string(controlledGate(X_GATE, {0, 1}, {3}).matrix()));
+    EXPECT_EQ(to_string(CCNOT(3, 0, 1)), to_string(controlledGate(X_GATE, {0, 1}, {3}).expand().matrix()));
+    EXPECT_EQ(to_string(controlledGate(H_GATE, {2}, {0}).matrix().dagger()), to_string(controlledGate(H_GATE, {2}, {0}).dagger().matrix()));
+    EXPECT_THROW(controlledGate(X_GATE, {0}, {0}), invalid_argument);
+}
+
+TEST(testCircuit, applyControlled)
+{
+    ComplexVect cells;
+    for (size_t i = 0; i < 16; i++)
+    {
+        cells.push_back(complex<double>(i + 1, 1.0 - i));
+    }
+    for (const Gate &gate : {controlledGate(ryGate(0, 0.3).base(), {1, 3}, {2}),
+                             controlledGate(SWAP_GATE, {0}, {3, 1}),
+                             controlledGate(rzGate(0, 0.7).base(), {3}, {0})})
+    {
+        const Matrix ket = gate.matrix() * Matrix(16, 1, cells);
+        ComplexVect result = cells;
+        gate.apply(result);
+        for (size_t i = 0; i < 16; i++)
+        {
+            EXPECT_NEAR(0, abs(ket.cells()[i] - result[i]), 1e-12) << gate.name();
+        }
+    }
+}
+
+TEST(testCircuit, applyBatch)
+{
+    // Mixed kernels on 3 qubits applied to 3 kets at once
+    const Circuit c = Circuit(qftGate({0, 2}, false)) * Circuit(cnotGate(2, 0)) * Circuit(xGate(1)) * Circuit(ryGate(0, 0.4)) * Circuit(hGate(1)) * Circuit(hGate(0)) * Circuit(controlledGate(T_GATE, {1}, {2}));
+    const size_t numCols = 3;
+    ComplexVect cells;
+    for (size_t i = 0; i < 8 * numCols; i++)
+    {
+        cells.push_back(complex<double>(cos(i * 0.7), sin(i * 1.3)));
+    }
+    const Matrix exp = c.matrix() * Matrix(8, numCols, cells);
+    ComplexVect act = cells;
+    c.apply(act, numCols);
+    for (size_t i = 0; i < act.size(); i++)
+    {
+        EXPECT_NEAR(0, abs(exp.cells()[i] - act[i]), 1e-12) << i;
+    }
+    EXPECT_THROW(c.apply(act, 5), invalid_argument);
+}
+
+TEST(testCircuit, matrixByColumns)
+{
+    // Parallel columns on 7 qubits against the dense product of gate matrices
+    const Circuit c = Circuit(qftGate({0, 6, 3}, false)) * Circuit(ccnotGate(6, 0, 2)) * Circuit(rxGate(5, 0.3)) * Circuit(hGate(1)) * Circuit(controlledGate(S_GATE, {4}, {6})) * Circuit(hGate(4));
+    Matrix exp = c.gates().back().matrix();
+    for (size_t i = c.gates().size() - 1; i > 0; i--)
+    {
+        exp = exp * c.gates()[i - 1].matrix();
+    }
+    const Matrix act = c.matrix();
+    ASSERT_EQ(128, act.numRows());
+    ASSERT_EQ(128, act.numCols());
+    for (size_t i = 0; i < act.cells().size(); i++)
+    {
+        EXPECT_NEAR(0, abs(exp.cells()[i] - act.cells()[i]), 1e-12) << i;
+    }
+}
+
+TEST(testCircuit, decomposed)
+{
+    const ComplexVect cells = testCells(5);
+    for (const Gate &gate : {qftGate({0, 3, 1}, false), qftGate({4, 0, 2, 1}, true), hnGate({1, 3}),
+                             qftGate({2, 0}, false).remap({2, 0}, {4}), hnGate({0, 1}).remap({0, 1}, {3, 2})})
+    {
+        ComplexVect exp = cells;
+        gate.apply(exp);
+        ComplexVect act = cells;
+        for (const Gate &g : gate.decomposed())
+        {
+            EXPECT_GE(2, g.bits().size()) << g.name();
+            g.apply(act);
+        }
+        for (size_t i = 0; i < act.size(); i++)
+        {
+            EXPECT_NEAR(0, abs(exp[i] - act[i]), 1e-12) << gate.name() << ", " << i;
+        }
+    }
+    EXPECT_EQ(1, xGate(0).decomposed().size());
+}
+
+TEST(testCircuit, power)
+{
+    const Circuit c = Circuit(ryGate(0, 0.3)) * Circuit(cnotGate(2, 0));
+    const Matrix u = c.matrix();
+    const ComplexVect cells = testCells(3);
+    // Few repetitions are applied gate by gate, many by the dense power
+    for (const uint64_t k : {0, 1, 7, 1000})
+    {
+        const Gate g = powerGate(c, k);
+        EXPECT_EQ(GateKernel::power, g.kernel());
+        EXPECT_EQ(indices_t({0, 2}), g.bits());
+        const Matrix exp = u.power(k) * Matrix(8, 1, cells);
+        ComplexVect act = cells;
+        g.apply(act);
+        for (size_t i = 0; i < act.size(); i++)
+        {
+            EXPECT_NEAR(0, abs(exp.cells()[i] - act[i]), 1e-9) << k << ", " << i;
+        }
+    }
+    const Gate g = powerGate(c, 7);
+    EXPECT_EQ("POW(0,2)^7", g.name());
+    const Matrix id = g.dagger().matrix() * g.matrix();
+    for (size_t i = 0; i < 8; i++)
+    {
+        for (size_t j = 0; j < 8; j++)
+        {
+            EXPECT_NEAR(i == j ? 1 : 0, abs(id.at(i, j)), 1e-12);
+        }
+    }
+}
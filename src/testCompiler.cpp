@@ -154,6 +154,16 @@ INSTANTIATE_TEST_SUITE_P(testCompilerError,
                              vector<string>{"CNOT(1,2,3);", "CNOT requires 2 arguments: actual (3)"},
                              vector<string>{"CCNOT(1,2);", "CCNOT requires 3 arguments: actual (2)"},
                              vector<string>{"CCNOT(1,2,3,4);", "CCNOT requires 3 arguments: actual (4)"},
+                             vector<string>{"controlled(X(0),1);", "controlled requires at least 3 arguments: actual (2)"},
+                             vector<string>{"QFT();", "QFT requires at least 1 arguments: actual (0)"},
+                             vector<string>{"HN();", "HN requires at least 1 arguments: actual (0)"},
+                             vector<string>{"oracle(|0>);", "oracle requires at least 2 arguments: actual (1)"},
+                             vector<string>{"batch();", "batch requires at least 1 arguments: actual (0)"},
+                             vector<string>{"column(|0>);", "column requires 2 arguments: actual (1)"},
+                             vector<string>{"exp();", "exp requires 1 arguments: actual (0)"},
+                             vector<string>{"expv(1, PZ(0));", "expv requires 3 arguments: actual (2)"},
+                             vector<string>{"pow(1);", "pow requires 2 arguments: actual (1)"},
+                             vector<string>{"ptrace(|0>);", "ptrace requires at least 2 arguments: actual (1)"},
                              vector<string>{"I();", "I requires 1 arguments: actual (0)"},
                              vector<string>{"I(1,2);", "I requires 1 arguments: actual (2)"},
                              vector<string>{"H();", "H requires 1 arguments: actual (0)"},
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include "decisionDiagram.h"
+#include "testUtils.h"
+
+#define HALF_SQRT2 (sqrt(2) / 2)
+
+using namespace std;
+using namespace mx;
+using namespace tu;
+
+TEST(testDecisionDiagram, complexTable)
+{
+    ComplexTable table(1e-10);
+
+    EXPECT_EQ(ComplexTable::ZERO, table.lookup(0));
+    EXPECT_EQ(ComplexTable::ZERO, table.lookup(1e-12));
+    EXPECT_EQ(ComplexTable::ONE, table.lookup(1));
+    EXPECT_EQ(ComplexTable::ONE, table.lookup(1 + 1e-12));
+
+    const uint32_t id = table.lookup(complex<double>(HALF_SQRT2, -0.5));
+    EXPECT_EQ(id, table.lookup(complex<double>(HALF_SQRT2 + 5e-11, -0.5 - 5e-11)));
+    EXPECT_EQ(3, table.size());
+}
+
+TEST(testDecisionDiagram, uniqueNodes)
+{
+    DDPackage package;
+    const DDEdge leaf{DDPackage::TERMINAL, ComplexTable::ONE};
+
+    const uint32_t two = package.lookup(2);
+    const DDEdge a = package.makeNode(0, {leaf, leaf});
+    const DDEdge b = package.makeNode(0, {DDEdge{DDPackage::TERMINAL, two}, DDEdge{DDPackage::TERMINAL, two}});
+
+    EXPECT_EQ(a.node, b.node);
+    EXPECT_EQ(complex<double>(2), package.weight(b));
+    EXPECT_EQ(DDPackage::ZERO_EDGE, package.makeNode(0, {DDPackage::ZERO_EDGE, DDPackage::ZERO_EDGE}));
+}
+
+TEST(testDecisionDiagram, create)
+{
+    const DDState s(ketBase(2) + ketBase(0) * 2.0);
+
+    EXPECT_EQ(2, s.numQubits());
+    EXPECT_EQ(complex<double>(2), s.at(0));
+    EXPECT_EQ(complex<double>(0), s.at(1));
+    EXPECT_EQ(complex<double>(1), s.at(2));
+    EXPECT_EQ(complex<double>(0), s.at(3));
+    EXPECT_EQ("(2) |0> + |2>", to_string(s));
+}
+
+TEST(testDecisionDiagram, sharing)
+{
+    // The uniform superposition is a chain of one node per qubit
+    const DDState s(Matrix(16, 1, vu::ComplexVect(16, 0.25)));
+
+    EXPECT_EQ(4, s.size());
+    EXPECT_EQ(complex<double>(0.25), s.at(11));
+}
+
+TEST(testDecisionDiagram, denseEquivalence)
+{
+    const Circuit c = Circuit(hGate(0)) * Circuit(cnotGate(1, 0)) * Circuit(tGate(2)) * Circuit(hGate(2)) * Circuit(swapGate(0, 2)) * Circuit(hGate(1)) * Circuit(yGate(1)) * Circuit(sGate(0));
+    const Matrix in = ketBase(5);
+    const StatePtr s = DDState(in).transform(c);
+    const Matrix exp = c.matrix() * in;
+    const Matrix act = s->ket();
+
+    expectNear(exp, act);
+}
+
+TEST(testDecisionDiagram, halfAdder)
+{
+    const Circuit ha = Circuit(cnotGate(1, 0)) * Circuit(cnotGate(2, 1)) * Circuit(ccnotGate(3, 1, 2)) * Circuit(cnotGate(1, 0)) * Circuit(ccnotGate(3, 0, 1));
+    for (int in = 0; in < 4; in++)
+    {
+        const StatePtr s = DDState(ketBase(in)).transform(ha);
+        EXPECT_EQ(to_string(ha.matrix() * ketBase(in)), to_string(*s));
+    }
+}
+
+TEST(testDecisionDiagram, projector)
+{
+    const Circuit bell = Circuit(cnotGate(1, 0)) * Circuit(hGate(0));
+    const StatePtr s = DDState(ketBase(0)).transform(bell);
+    const StatePtr p = s->transform(matrixCircuit(qubit1(1, 2)));
+
+    EXPECT_NEAR(HALF_SQRT2, p->at(3).real(), 1e-12);
+    EXPECT_EQ(1, p->amplitudes().size());
+}
+
+TEST(testDecisionDiagram, wideRegister)
+{
+    // GHZ state on 64 qubits is a diagram of two nodes per qubit
+    Circuit ghz(hGate(0));
+    for (size_t i = 1; i < 64; i++)
+    {
+        ghz = Circuit(cnotGate(i, i - 1)) * ghz;
+    }
+    const StatePtr s = DDState(ketBase(0)).transform(ghz);
+    const DDState &dd = *(const DDState *)s.get();
+
+    EXPECT_EQ(64, s->numQubits());
+    EXPECT_LE(dd.size(), 128);
+    EXPECT_NEAR(HALF_SQRT2, s->at(0).real(), 1e-12);
+    EXPECT_NEAR(HALF_SQRT2, s->at(~0ULL).real(), 1e-12);
+    EXPECT_EQ(complex<double>(0), s->at(1));
+    EXPECT_EQ(2, s->amplitudes().size());
+    EXPECT_THROW(s->ket(), invalid_argument);
+}
+
+TEST(testDecisionDiagram, kernels)
+{
+    // Controls above and below the targets, controlled transforms and oracles
+    const Circuit c = Circuit(oracleGate({3, 0}, {1, 2}).remap({3, 0}, {4})) * Circuit(controlledGate(ryGate(0, 0.4).base(), {0, 4}, {2})) * Circuit(qftGate({1, 3, 0}, true).remap({1, 3, 0}, {2})) * Circuit(controlledGate(SWAP_GATE, {1}, {4, 0})) * Circuit(hnGate({0, 2, 4}));
+    const Matrix in = ketBase(6).extendsRows(32);
+    const StatePtr s = DDState(in).transform(c);
+
+    expectNear(c.matrix() * in, s->ket());
+}
+
+TEST(testDecisionDiagram, wideKernels)
+{
+    // Gates wider than the dense expansion
+    const indices_t controls{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    const StatePtr c = DDState(ketBase(4094)).transform(Circuit(controlledGate(X_GATE, controls, {0})));
+    EXPECT_NEAR(1, c->at(4095).real(), 1e-12);
+
+    const StatePtr o = DDState(ketBase(3)).transform(Circuit(oracleGate({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}, {3})));
+    EXPECT_NEAR(-1, o->at(3).real(), 1e-12);
+
+    const indices_t qubits{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    const StatePtr q = DDState(ketBase(0)).transform(Circuit(qftGate(qubits, false)));
+    const DDState &dd = *(const DDState *)q.get();
+    EXPECT_NEAR(1 / sqrt(2048.0), q->at(1234).real(), 1e-12);
+    EXPECT_LE(dd.size(), 11);
+}
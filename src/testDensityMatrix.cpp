@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include "densityMatrix.h"
+#include "testUtils.h"
+
+using namespace std;
+using namespace mx;
+using namespace tu;
+
+TEST(testDensityMatrix, create)
+{
+    const DensityMatrix rho(PLUS_KET);
+
+    EXPECT_EQ(1, rho.numQubits());
+    expectNear(PLUS_KET * PLUS_KET.dagger(), rho.matrix());
+    EXPECT_NEAR(1, rho.trace().real(), 1e-12);
+}
+
+TEST(testDensityMatrix, applyGates)
+{
+    const Circuit c = Circuit(hGate(0)) * Circuit(cnotGate(2, 0)) * Circuit(tGate(2)) * Circuit(hGate(1)) * Circuit(sGate(0)) * Circuit(yGate(1));
+    const Matrix in = ketBase(3);
+    DensityMatrix rho(in);
+    rho.apply(c);
+    const Matrix out = c.matrix() * in;
+
+    EXPECT_EQ(3, rho.numQubits());
+    expectNear(out * out.dagger(), rho.matrix());
+}
+
+TEST(testDensityMatrix, depolarize)
+{
+    DensityMatrix rho(ketBase(0));
+    rho.depolarize(0, 0.75);
+
+    // Full depolarization gives the maximally mixed state
+    expectNear(Matrix(2, 2, {0.5, 0, 0, 0.5}), rho.matrix());
+    EXPECT_NEAR(0.5, rho.probability(0), 1e-12);
+}
+
+TEST(testDensityMatrix, dampAmplitude)
+{
+    DensityMatrix rho(ketBase(3));
+    rho.dampAmplitude(1, 0.25);
+
+    EXPECT_NEAR(1, rho.trace().real(), 1e-12);
+    EXPECT_NEAR(1, rho.probability(0), 1e-12);
+    EXPECT_NEAR(0.75, rho.probability(1), 1e-12);
+}
+
+TEST(testDensityMatrix, dephase)
+{
+    DensityMatrix rho(PLUS_KET);
+    rho.dephase(0, 0.5);
+
+    // Full dephasing removes the coherences
+    expectNear(Matrix(2, 2, {0.5, 0, 0, 0.5}), rho.matrix());
+}
+
+TEST(testDensityMatrix, expectation)
+{
+    DensityMatrix rho(ketBase(0));
+    rho.apply(Circuit(cnotGate(1, 0)) * Circuit(hGate(0)));
+
+    EXPECT_NEAR(0.5, rho.expectation(qubit1(1, 2)).real(), 1e-12);
+    EXPECT_NEAR(0.5, rho.probability(1), 1e-12);
+    EXPECT_THROW(rho.expectation(qubit1(0, 1)), invalid_argument);
+}
+
+TEST(testDensityMatrix, invalidProbability)
+{
+    DensityMatrix rho(ketBase(0));
+
+    EXPECT_THROW(rho.depolarize(0, 1.5), invalid_argument);
+    EXPECT_THROW(rho.dephase(0, -0.1), invalid_argument);
+}
+
+/**
+ * Returns the reduced density matrix by the sum over the full density matrix
+ */
+static const Matrix referenceTrace(const Matrix &rho, const indices_t &keep)
+{
+    const size_t n = rho.numRows();
+    const size_t m = 1ULL << keep.size();
+    auto local = [&keep](const size_t index)
+    {
+        size_t result = 0;
+        for (size_t i = 0; i < keep.size(); i++)
+        {
+            result |= ((index >> keep[i]) & 1) << i;
+        }
+        return result;
+    };
+    uint64_t mask = 0;
+    for (const size_t bit : keep)
+    {
+        mask |= 1ULL << bit;
+    }
+    vu::ComplexVect cells(m * m, 0);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            if ((i & ~mask) == (j & ~mask))
+            {
+                cells[local(i) * m + local(j)] += rho.at(i, j);
+            }
+        }
+    }
+    return Matrix(m, m, cells);
+}
+
+TEST(testDensityMatrix, partialTrace)
+{
+    // Bell pair on qubits 0, 1 with qubit 2 in |1>
+    vu::ComplexVect bell = ketBase(4).extendsRows(8).cells();
+    (Circuit(cnotGate(1, 0)) * Circuit(hGate(0))).apply(bell);
+    const Matrix ket(8, 1, bell);
+
+    expectNear(Matrix(2, 2, {0.5, 0, 0, 0.5}), partialTrace(ket, {0}));
+    expectNear(Matrix(2, 2, {0, 0, 0, 1}), partialTrace(ket, {2}));
+    expectNear(referenceTrace(DensityMatrix(ket).matrix(), {1, 0}), partialTrace(ket, {1, 0}));
+
+    vu::ComplexVect cells;
+    for (size_t i = 0; i < 16; i++)
+    {
+        cells.push_back(complex<double>(cos(i * 0.7), sin(i * 1.3)) / 2.8);
+    }
+    const Matrix psi(16, 1, cells);
+    DensityMatrix rho(psi);
+    rho.depolarize(1, 0.3);
+    const Matrix exp = referenceTrace(rho.matrix(), {2, 0});
+    expectNear(exp, rho.partialTrace({2, 0}));
+    expectNear(exp, partialTrace(rho.matrix(), {2, 0}));
+    expectNear(referenceTrace(DensityMatrix(psi).matrix(), {3, 1, 0}), partialTrace(psi, {3, 1, 0}));
+    expectNear(Matrix(1, 1, {DensityMatrix(psi).trace()}), partialTrace(psi, {}));
+}
+
+TEST(testDensityMatrix, partialTraceParallel)
+{
+    // 12 qubits reduced to 3 by parallel row blocks
+    vu::ComplexVect cells;
+    for (size_t i = 0; i < 4096; i++)
+    {
+        cells.push_back(complex<double>(cos(i * 0.37), sin(i * 0.11)));
+    }
+    vu::normalise(cells);
+    const Matrix psi(4096, 1, cells);
+    const Matrix exp = partialTrace(psi, {11, 0, 5}, 1);
+    const Matrix act = partialTrace(psi, {11, 0, 5}, 3);
+
+    expectNear(exp, act);
+    complex<double> trace = 0;
+    for (size_t i = 0; i < 8; i++)
+    {
+        trace += act.at(i, i);
+    }
+    EXPECT_NEAR(1, trace.real(), 1e-12);
+}
+
+TEST(testDensityMatrix, invalidPartialTrace)
+{
+    EXPECT_THROW(partialTrace(ketBase(3), {0, 0}), invalid_argument);
+    EXPECT_THROW(partialTrace(ketBase(3), {2}), invalid_argument);
+    EXPECT_THROW(partialTrace(Matrix(2, 3, {1, 0, 0, 0, 1, 0}), {0}), invalid_argument);
+    EXPECT_THROW(partialTrace(Matrix(3, 1, {1, 0, 0}), {0}), invalid_argument);
+}
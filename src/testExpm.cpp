@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <numbers>
+
+#include "expm.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+static const complex<double> I_UNIT(0, 1);
+
+/**
+ * Returns the test matrix
+ * @param n the size
+ * @param scale the scale of cells
+ */
+static const Matrix testMatrix(const size_t n, const double scale)
+{
+    ComplexVect cells;
+    for (size_t i = 0; i < n * n; i++)
+    {
+        cells.push_back(complex<double>(cos(i * 0.7), sin(i * 1.3)) * scale);
+    }
+    return Matrix(n, n, cells);
+}
+
+/**
+ * Returns the test vector
+ * @param n the size
+ */
+static const ComplexVect testVector(const size_t n)
+{
+    ComplexVect cells;
+    for (size_t i = 0; i < n; i++)
+    {
+        cells.push_back(complex<double>(sin(i * 0.3), cos(i * 1.1)));
+    }
+    return cells;
+}
+
+TEST(testExpm, diagonal)
+{
+    const Matrix act = expm(Matrix(2, 2, {1, 0, 0, complex<double>(0, numbers::pi)}));
+    EXPECT_NEAR(0, abs(numbers::e - act.at(0, 0)), 1e-14);
+    EXPECT_NEAR(0, abs(-1.0 - act.at(1, 1)), 1e-14);
+    EXPECT_EQ(0.0, act.at(0, 1));
+}
+
+TEST(testExpm, pauliRotation)
+{
+    // exp(-i theta X) = cos(theta) I - i sin(theta) X
+    const double theta = 0.3;
+    const Matrix act = expm(PauliSum(pauliX(0), -I_UNIT * theta).matrix());
+    EXPECT_NEAR(0, abs(cos(theta) - act.at(0, 0)), 1e-15);
+    EXPECT_NEAR(0, abs(-I_UNIT * sin(theta) - act.at(0, 1)), 1e-15);
+}
+
+TEST(testExpm, scaling)
+{
+    // Large norm with squaring: exp(A) exp(-A) = I
+    const Matrix a = testMatrix(6, 3);
+    const Matrix id = expm(a) * expm(-a);
+    for (size_t i = 0; i < 6; i++)
+    {
+        for (size_t j = 0; j < 6; j++)
+        {
+            EXPECT_NEAR(i == j ? 1 : 0, abs(id.at(i, j)), 1e-9);
+        }
+    }
+    EXPECT_THROW(expm(Matrix(2, 1, {1, 0})), invalid_argument);
+}
+
+TEST(testExpm, expvMatrix)
+{
+    const Matrix a = testMatrix(64, 0.2);
+    const ComplexVect v = testVector(64);
+    for (const complex<double> t : {complex<double>(0.5), complex<double>(0, -3)})
+    {
+        const Matrix exp = expm(a * t) * Matrix(64, 1, v);
+        const ComplexVect act = expv(t, a, v);
+        for (size_t i = 0; i < 64; i++)
+        {
+            EXPECT_NEAR(0, abs(exp.cells()[i] - act[i]), 1e-9 * abs(exp.cells()[i]) + 1e-10) << i;
+        }
+    }
+    EXPECT_THROW(expv(1.0, testMatrix(4, 1), v), invalid_argument);
+}
+
+TEST(testExpm, expvPauli)
+{
+    // Transverse field Ising chain evolution
+    const size_t n = 6;
+    PauliSum h(pauliZ(0) * pauliZ(1));
+    for (size_t q = 1; q + 1 < n; q++)
+    {
+        h = h + PauliSum(pauliZ(q) * pauliZ(q + 1));
+    }
+    for (size_t q = 0; q < n; q++)
+    {
+        h = h + PauliSum(pauliX(q), 0.7);
+    }
+    ComplexVect v(1ULL << n, 0);
+    v[0] = 1;
+    const complex<double> t(0, -2.5);
+    const Matrix exp = expm(h.matrix() * t) * Matrix(v.size(), 1, v);
+    const ComplexVect act = expv(t, h, v);
+    for (size_t i = 0; i < v.size(); i++)
+    {
+        EXPECT_NEAR(0, abs(exp.cells()[i] - act[i]), 1e-10) << i;
+    }
+    EXPECT_NEAR(1, norm2(act), 1e-12);
+    EXPECT_THROW(expv(t, h, ComplexVect(4, 1)), invalid_argument);
+}
+
+TEST(testExpm, invariantSubspace)
+{
+    // Breakdown on the first Krylov vector of an eigenvector
+    const ComplexVect act = expv(complex<double>(0, -1), PauliSum(pauliZ(0) * pauliZ(1)), ComplexVect{0, 1, 0, 0});
+    EXPECT_NEAR(0, abs(exp(I_UNIT) - act[1]), 1e-14);
+    EXPECT_EQ(0.0, act[0]);
+}
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include <numbers>
+
+#include "fourier.h"
+#include "circuit.h"
+#include "testUtils.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+using namespace tu;
+
+TEST(testFourier, matrix)
+{
+    // The 1 qubit transform is H
+    const Matrix f1 = fourierMatrix(1, false);
+    for (size_t i = 0; i < 4; i++)
+    {
+        EXPECT_NEAR(0, abs(f1.cells()[i] - H_GATE.cells()[i]), 1e-15);
+    }
+    const Matrix f3 = fourierMatrix(3, false);
+    const Matrix id = f3 * fourierMatrix(3, true);
+    for (size_t i = 0; i < 8; i++)
+    {
+        for (size_t j = 0; j < 8; j++)
+        {
+            EXPECT_NEAR(i == j ? 1 : 0, abs(id.at(i, j)), 1e-12);
+        }
+    }
+}
+
+TEST(testFourier, denseEquivalence)
+{
+    const ComplexVect cells = testCells(4);
+    for (const indices_t &qubits : {indices_t{0, 1, 2, 3}, indices_t{0, 1}, indices_t{3, 1}, indices_t{2, 0, 3}})
+    {
+        for (const bool inverse : {false, true})
+        {
+            const Matrix exp = createGate(fourierMatrix(qubits.size(), inverse), qubits).extendsCross(16) * Matrix(16, 1, cells);
+            ComplexVect act = cells;
+            fourier(act.data(), act.size(), qubits, inverse);
+            for (size_t i = 0; i < 16; i++)
+            {
+                EXPECT_NEAR(0, abs(exp.cells()[i] - act[i]), 1e-12) << to_string(qubits) << " " << inverse;
+            }
+        }
+    }
+}
+
+TEST(testFourier, basisState)
+{
+    // Crosses the cache blocks and the parallel size
+    const size_t n = 17;
+    const uint64_t m = 1ULL << n;
+    const uint64_t x = 12345;
+    ComplexVect cells(m, 0);
+    cells[x] = 1;
+    indices_t qubits;
+    for (size_t i = 0; i < n; i++)
+    {
+        qubits.push_back(i);
+    }
+    fourier(cells.data(), m, qubits, false, 4);
+    for (const uint64_t y : vector<uint64_t>{0, 1, 777, m - 1})
+    {
+        const complex<double> exp = polar(1 / sqrt((double)m), 2 * numbers::pi * ((x * y) % m) / m);
+        EXPECT_NEAR(0, abs(exp - cells[y]), 1e-12) << y;
+    }
+}
+
+TEST(testFourier, roundTrip)
+{
+    // Parallel groups and parallel transforms
+    const ComplexVect cells = testCells(17);
+    for (const indices_t &qubits : {indices_t{16, 3, 5}, indices_t{2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 0}})
+    {
+        ComplexVect act = cells;
+        fourier(act.data(), act.size(), qubits, false, 4);
+        fourier(act.data(), act.size(), qubits, true, 4);
+        for (size_t i = 0; i < act.size(); i += 997)
+        {
+            EXPECT_NEAR(0, abs(cells[i] - act[i]), 1e-12);
+        }
+    }
+}
+
+TEST(testFourier, gate)
+{
+    const Gate qft = qftGate({1, 0}, false);
+    EXPECT_EQ("QFT(1,0)", qft.name());
+    EXPECT_EQ(GateKernel::fourier, qft.kernel());
+    EXPECT_FALSE(qft.isDense());
+    EXPECT_EQ("IQFT(1,0)^", qftGate({1, 0}, true).dagger().name());
+    EXPECT_EQ(GateKernel::fourier, qftGate({1, 0}, true).dagger().kernel());
+    EXPECT_EQ(to_string(createGate(fourierMatrix(2, false), {1, 0})), to_string(qft.matrix()));
+
+    ComplexVect act = testCells(3);
+    qft.apply(act);
+    const Matrix exp = qft.matrix().extendsCross(8) * Matrix(8, 1, testCells(3));
+    for (size_t i = 0; i < 8; i++)
+    {
+        EXPECT_NEAR(0, abs(exp.cells()[i] - act[i]), 1e-12);
+    }
+    EXPECT_THROW(qftGate({}, false), invalid_argument);
+    EXPECT_THROW(qftGate({1, 1}, false), invalid_argument);
+}
+
+TEST(testFourier, hadamardMatrix)
+{
+    const Matrix h1 = hadamardMatrix(1);
+    for (size_t i = 0; i < 4; i++)
+    {
+        EXPECT_NEAR(0, abs(h1.cells()[i] - H_GATE.cells()[i]), 1e-15);
+    }
+    const Matrix h3 = hadamardMatrix(3);
+    const Matrix id = h3 * h3;
+    for (size_t i = 0; i < 8; i++)
+    {
+        for (size_t j = 0; j < 8; j++)
+        {
+            EXPECT_NEAR(i == j ? 1 : 0, abs(id.at(i, j)), 1e-12);
+        }
+    }
+}
+
+TEST(testFourier, hadamardEquivalence)
+{
+    const ComplexVect cells = testCells(4);
+    for (const indices_t &qubits : {indices_t{0}, indices_t{3}, indices_t{0, 1, 2, 3}, indices_t{3, 1}, indices_t{2, 0, 3}})
+    {
+        const Matrix exp = createGate(hadamardMatrix(qubits.size()), qubits).extendsCross(16) * Matrix(16, 1, cells);
+        ComplexVect act = cells;
+        hadamard(act.data(), act.size(), qubits);
+        for (size_t i = 0; i < 16; i++)
+        {
+            EXPECT_NEAR(0, abs(exp.cells()[i] - act[i]), 1e-12) << to_string(qubits);
+        }
+    }
+}
+
+TEST(testFourier, hadamardRoundTrip)
+{
+    // Cache blocked low qubits and parallel passes on high qubits
+    const ComplexVect cells = testCells(17);
+    for (const indices_t &qubits : {indices_t{16, 3, 5}, indices_t{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}})
+    {
+        ComplexVect act = cells;
+        hadamard(act.data(), act.size(), qubits, 4);
+        hadamard(act.data(), act.size(), qubits, 4);
+        for (size_t i = 0; i < act.size(); i += 997)
+        {
+            EXPECT_NEAR(0, abs(cells[i] - act[i]), 1e-12);
+        }
+    }
+}
+
+TEST(testFourier, hadamardBasisState)
+{
+    // H on every qubit of |0> is the uniform superposition
+    const size_t n = 15;
+    const uint64_t m = 1ULL << n;
+    ComplexVect cells(m, 0);
+    cells[0] = 1;
+    indices_t qubits;
+    for (size_t i = 0; i < n; i++)
+    {
+        qubits.push_back(i);
+    }
+    hadamard(cells.data(), m, qubits, 4);
+    for (const uint64_t y : vector<uint64_t>{0, 1, 777, m - 1})
+    {
+        EXPECT_NEAR(0, abs(1 / sqrt((double)m) - cells[y]), 1e-12) << y;
+    }
+}
+
+TEST(testFourier, hnGate)
+{
+    const Gate hn = hnGate({2, 0});
+    EXPECT_EQ("HN(2,0)", hn.name());
+    EXPECT_EQ(GateKernel::hadamard, hn.kernel());
+    EXPECT_FALSE(hn.isDense());
+    EXPECT_EQ(GateKernel::hadamard, hn.dagger().kernel());
+    EXPECT_EQ(to_string(createGate(hadamardMatrix(2), {2, 0})), to_string(hn.matrix()));
+    EXPECT_THROW(hnGate({}), invalid_argument);
+    EXPECT_THROW(hnGate({1, 1}), invalid_argument);
+}
+
+TEST(testFourier, fused)
+{
+    // Gates are applied from the right
+    const Circuit c = Circuit(hGate(0)) * Circuit(hGate(0)) * Circuit(cnotGate(1, 0)) * Circuit(hGate(2)) * Circuit(hGate(1)) * Circuit(hGate(0));
+    const Circuit f = c.fused();
+    ASSERT_EQ(4, f.gates().size());
+    EXPECT_EQ("HN(0,1,2)", f.gates()[0].name());
+    EXPECT_EQ(GateKernel::hadamard, f.gates()[0].kernel());
+    EXPECT_EQ(cnotGate(1, 0).name(), f.gates()[1].name());
+    // H twice on the same qubit is not merged
+    EXPECT_EQ(hGate(0).name(), f.gates()[2].name());
+    EXPECT_EQ(hGate(0).name(), f.gates()[3].name());
+
+    ComplexVect act = testCells(3);
+    for (const Gate &gate : f.gates())
+    {
+        gate.apply(act);
+    }
+    const Matrix exp = c.matrix().extendsCross(8) * Matrix(8, 1, testCells(3));
+    for (size_t i = 0; i < 8; i++)
+    {
+        EXPECT_NEAR(0, abs(exp.cells()[i] - act[i]), 1e-12);
+    }
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include "hybrid.h"
+#include "testUtils.h"
+
+#define HALF_SQRT2 (sqrt(2) / 2)
+
+using namespace std;
+using namespace mx;
+using namespace tu;
+
+TEST(testHybrid, localGates)
+{
+    const Circuit c = Circuit(xGate(3)) * Circuit(hGate(0));
+    const HybridSimulator sim(c, 0, 2);
+
+    EXPECT_EQ(4, sim.numQubits());
+    EXPECT_EQ(1, sim.numPaths());
+    EXPECT_EQ(to_string(c.matrix() * ketBase(0)), to_string(*sim.state()));
+}
+
+TEST(testHybrid, controlledCrossing)
+{
+    // CNOT crossing the cut is split into two terms
+    const Circuit bell = Circuit(cnotGate(1, 0)) * Circuit(hGate(0));
+    const HybridSimulator sim(bell, 0, 1, 2);
+
+    EXPECT_EQ(2, sim.numPaths());
+    EXPECT_EQ(2, sim.numWorkers());
+    const vector<complex<double>> amps = sim.amplitudes({0, 1, 2, 3});
+    EXPECT_NEAR(HALF_SQRT2, amps[0].real(), 1e-12);
+    EXPECT_NEAR(0, abs(amps[1]), 1e-12);
+    EXPECT_NEAR(0, abs(amps[2]), 1e-12);
+    EXPECT_NEAR(HALF_SQRT2, amps[3].real(), 1e-12);
+}
+
+TEST(testHybrid, denseEquivalence)
+{
+    const Circuit c = Circuit(hGate(0)) * Circuit(cnotGate(2, 0)) * Circuit(tGate(2)) * Circuit(hGate(3)) * Circuit(swapGate(1, 3)) * Circuit(ccnotGate(0, 3, 1)) * Circuit(sGate(1)) * Circuit(yGate(2));
+    for (uint64_t in = 0; in < 16; in += 5)
+    {
+        for (size_t cut = 1; cut < 4; cut++)
+        {
+            const HybridSimulator sim(c, in, cut, 3);
+            const Matrix exp = c.matrix() * ketBase(in);
+            const Matrix act = sim.state()->ket();
+            expectNear(exp, act);
+        }
+    }
+}
+
+TEST(testHybrid, wideRegister)
+{
+    // 40 qubits GHZ with a single gate crossing the cut
+    Circuit ghz(hGate(0));
+    for (size_t i = 1; i < 40; i++)
+    {
+        ghz = Circuit(cnotGate(i, i - 1)) * ghz;
+    }
+    const HybridSimulator sim(ghz, 0, 20);
+
+    EXPECT_EQ(2, sim.numPaths());
+    const vector<complex<double>> amps = sim.amplitudes({0, (1ULL << 40) - 1, 1});
+    EXPECT_NEAR(HALF_SQRT2, amps[0].real(), 1e-12);
+    EXPECT_NEAR(HALF_SQRT2, amps[1].real(), 1e-12);
+    EXPECT_NEAR(0, abs(amps[2]), 1e-12);
+}
+
+TEST(testHybrid, invalidCut)
+{
+    EXPECT_THROW(HybridSimulator(Circuit(cnotGate(1, 0)), 0, 0), invalid_argument);
+    EXPECT_THROW(HybridSimulator(Circuit(cnotGate(1, 0)), 0, 2), invalid_argument);
+    EXPECT_THROW(HybridSimulator(Circuit(cnotGate(40, 0)), 0, 1), invalid_argument);
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include "mappedState.h"
+#include "sparseState.h"
+#include "testUtils.h"
+
+using namespace std;
+using namespace mx;
+using namespace tu;
+
+TEST(testMappedState, create)
+{
+    const MappedState state(ketBase(5));
+
+    EXPECT_EQ(3, state.numQubits());
+    EXPECT_EQ(1.0, state.at(5));
+    EXPECT_EQ(0.0, state.at(4));
+    EXPECT_EQ(0.0, state.at(8));
+}
+
+TEST(testMappedState, chunkGates)
+{
+    // Gates within the chunks, across a chunk pair and across 4 chunks with resize
+    const Circuit c = Circuit(hGate(0)) * Circuit(hGate(4)) * Circuit(cnotGate(3, 0)) * Circuit(ccnotGate(1, 5, 4)) * Circuit(swapGate(2, 5)) * Circuit(sGate(5));
+    MappedState state(ketBase(1), 2);
+    state.apply(c);
+
+    EXPECT_EQ(6, state.numQubits());
+    EXPECT_EQ(to_string(SparseState(ketBase(1)).transform(c)->ket()), to_string(state.ket()));
+}
+
+TEST(testMappedState, chunkKernels)
+{
+    // Transforms, oracles and high controls spanning the chunk group qubits
+    const Circuit c = Circuit(oracleGate({5, 0, 3}, {1, 6}).remap({5, 0, 3}, {4})) * Circuit(qftGate({0, 4, 2, 5}, false)) * Circuit(controlledGate(ryGate(0, 0.3).base(), {5, 1}, {3})) * Circuit(hnGate({0, 1, 2, 3, 4, 5})) * Circuit(qftGate({1, 5}, true).remap({1, 5}, {3}));
+    const Matrix in = ketBase(9).extendsRows(64);
+    MappedState state(in, 2);
+    state.apply(c);
+
+    expectNear(c.matrix() * in, state.ket());
+}
+
+TEST(testMappedState, transform)
+{
+    const MappedState state(ketBase(0), 1);
+    const StatePtr result = state.transform(Circuit(xGate(2)));
+
+    EXPECT_EQ(1.0, state.at(0));
+    EXPECT_EQ(1.0, result->at(4));
+    EXPECT_EQ(0.0, result->at(0));
+}
+
+TEST(testMappedState, invalid)
+{
+    EXPECT_THROW(MappedState(Matrix(2, 2, {1, 0, 0, 1})), invalid_argument);
+    EXPECT_THROW(MappedState(ketBase(0)).apply(Circuit(xGate(MAX_MAPPED_QUBITS))), invalid_argument);
+}
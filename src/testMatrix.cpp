@@ -999,3 +999,52 @@ INSTANTIATE_TEST_SUITE_P(testMatrix,
                              tuple<indices_t, Matrix, Matrix>{{2, 1, 0}, {ketBase(5)}, {ketBase(5).extendsRows(8)}},
                              tuple<indices_t, Matrix, Matrix>{{2, 1, 0}, {ketBase(6)}, {ketBase(6).extendsRows(8)}},
                              /**/ tuple<indices_t, Matrix, Matrix>{{2, 1, 0}, {ketBase(7)}, {ketBase(3).extendsRows(8)}}));
+
+TEST(testMatrix, norm2)
+{
+    // Large vector summed by parallel blocks
+    const size_t n = (1 << 19) + 3;
+    ComplexVect a(n, complex<double>(0.5, 0.5));
+
+    EXPECT_NEAR(sqrt(n * 0.5), norm2(a), 1e-9);
+    EXPECT_DOUBLE_EQ(5, norm2(ComplexVect{3, complex<double>(0, 4)}));
+}
+
+TEST(testMatrix, inner)
+{
+    const ComplexVect a{1, complex<double>(0, 1), 2};
+    const ComplexVect b{complex<double>(0, 1), 1, 3};
+
+    EXPECT_EQ(complex<double>(6, 0), inner(a, b));
+    EXPECT_THROW(inner(a, ComplexVect{1}), invalid_argument);
+}
+
+TEST(testMatrix, normalise)
+{
+    ComplexVect a{3, complex<double>(0, 4)};
+    normalise(a);
+
+    EXPECT_DOUBLE_EQ(0.6, a[0].real());
+    EXPECT_DOUBLE_EQ(0.8, a[1].imag());
+    ComplexVect zero(4, 0);
+    EXPECT_THROW(normalise(zero), invalid_argument);
+}
+
+TEST(testMatrix, power)
+{
+    const Matrix a(2, 2, {1, 1, 0, 1});
+
+    EXPECT_EQ(ComplexVect({1, 13, 0, 1}), a.power(13).cells());
+    EXPECT_EQ(ComplexVect({1, 0, 0, 1}), a.power(0).cells());
+    EXPECT_EQ(a.cells(), a.power(1).cells());
+    EXPECT_THROW(Matrix(2, 1, {1, 0}).power(2), invalid_argument);
+}
+
+TEST(testMatrix, transpose)
+{
+    const Matrix a(2, 3, {1, 2, 3, complex<double>(0, 4), 5, 6});
+
+    EXPECT_EQ(ComplexVect({1, complex<double>(0, 4), 2, 5, 3, 6}), a.transpose().cells());
+    EXPECT_EQ(3, a.transpose().numRows());
+    EXPECT_EQ(ComplexVect({1, complex<double>(0, -4), 2, 5, 3, 6}), a.dagger().cells());
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include "oracle.h"
+#include "circuit.h"
+#include "testUtils.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+using namespace tu;
+
+TEST(testOracle, matrix)
+{
+    const Matrix m = oracleMatrix(2, {1, 2});
+    EXPECT_EQ(to_string(Matrix(4, 4, {1, 0, 0, 0, 0, -1, 0, 0, 0, 0, -1, 0, 0, 0, 0, 1})), to_string(m));
+}
+
+TEST(testOracle, denseEquivalence)
+{
+    const ComplexVect cells = testCells(4);
+    for (const indices_t &qubits : {indices_t{0}, indices_t{3, 1}, indices_t{2, 0, 3}})
+    {
+        const vector<uint64_t> marked{0, (1ULL << qubits.size()) - 1};
+        const Matrix exp = createGate(oracleMatrix(qubits.size(), marked), qubits).extendsCross(16) * Matrix(16, 1, cells);
+        ComplexVect act = cells;
+        phaseOracle(act.data(), act.size(), qubits, marked);
+        for (size_t i = 0; i < 16; i++)
+        {
+            EXPECT_EQ(exp.cells()[i], act[i]) << to_string(qubits);
+        }
+    }
+}
+
+TEST(testOracle, parallel)
+{
+    // Flags table and sorted search of marked values on a parallel size
+    const size_t n = 18;
+    const ComplexVect cells = testCells(n);
+    indices_t qubits;
+    for (size_t i = 0; i < n; i++)
+    {
+        qubits.push_back(n - 1 - i);
+    }
+    for (const size_t k : {(size_t)3, n})
+    {
+        const indices_t register_(qubits.begin(), qubits.begin() + k);
+        const vector<uint64_t> marked{1, 5, (1ULL << k) - 2};
+        ComplexVect act = cells;
+        phaseOracle(act.data(), act.size(), register_, marked, 4);
+        for (size_t i = 0; i < act.size(); i++)
+        {
+            uint64_t x = 0;
+            for (size_t j = 0; j < k; j++)
+            {
+                x |= ((i >> register_[j]) & 1) << j;
+            }
+            const bool isMarked = find(marked.begin(), marked.end(), x) != marked.end();
+            ASSERT_EQ(isMarked ? -cells[i] : cells[i], act[i]) << k << " " << i;
+        }
+    }
+}
+
+TEST(testOracle, gate)
+{
+    const Gate oracle = oracleGate({2, 0}, {3, 1, 3});
+    EXPECT_EQ("ORACLE(2,0)", oracle.name());
+    EXPECT_EQ(GateKernel::oracle, oracle.kernel());
+    EXPECT_EQ((vector<uint64_t>{1, 3}), oracle.marked());
+    EXPECT_TRUE(oracle.isDiagonal());
+    EXPECT_FALSE(oracle.isDense());
+    EXPECT_EQ(oracle.marked(), oracle.dagger().marked());
+    EXPECT_EQ(to_string(createGate(oracleMatrix(2, {1, 3}), {2, 0})), to_string(oracle.matrix()));
+    EXPECT_THROW(oracleGate({}, {0}), invalid_argument);
+    EXPECT_THROW(oracleGate({1, 1}, {0}), invalid_argument);
+    EXPECT_THROW(oracleGate({0, 1}, {4}), invalid_argument);
+}
+
+TEST(testOracle, controlled)
+{
+    const Gate oracle = oracleGate({0, 2}, {1}).remap({0, 2}, {1});
+    ComplexVect act = testCells(3);
+    oracle.apply(act);
+    const Matrix exp = oracle.matrix().extendsCross(8) * Matrix(8, 1, testCells(3));
+    for (size_t i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(exp.cells()[i], act[i]) << i;
+    }
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include "pauli.h"
+#include "sparseState.h"
+#include "testUtils.h"
+
+using namespace std;
+using namespace mx;
+
+static const complex<double> I_UNIT(0, 1);
+
+TEST(testPauli, matrix)
+{
+    EXPECT_EQ(to_string(Matrix(2, 2, {0, 1, 1, 0})), to_string(pauliX(0).matrix(1)));
+    EXPECT_EQ(to_string(Matrix(2, 2, {0, -I_UNIT, I_UNIT, 0})), to_string(pauliY(0).matrix(1)));
+    EXPECT_EQ(to_string(Matrix(2, 2, {1, 0, 0, -1})), to_string(pauliZ(0).matrix(1)));
+}
+
+TEST(testPauli, product)
+{
+    // X Y = i Z, Y X = -i Z, Z Z = I
+    const PauliString xy = pauliX(0) * pauliY(0);
+    const PauliString yx = pauliY(0) * pauliX(0);
+
+    EXPECT_EQ(0, xy.x());
+    EXPECT_EQ(1, xy.z());
+    EXPECT_EQ(1, xy.phase());
+    EXPECT_EQ(3, yx.phase());
+    EXPECT_EQ(0, (pauliZ(3) * pauliZ(3)).support());
+
+    // Products agree with the dense matrices
+    const PauliString a = pauliX(0) * pauliY(1) * pauliZ(2);
+    const PauliString b = pauliY(0) * pauliY(2);
+    EXPECT_EQ(to_string(a.matrix(3) * b.matrix(3)), to_string((a * b).matrix(3)));
+}
+
+TEST(testPauli, commutes)
+{
+    EXPECT_FALSE(pauliX(0).commutes(pauliZ(0)));
+    EXPECT_TRUE((pauliX(0) * pauliX(1)).commutes(pauliZ(0) * pauliZ(1)));
+    EXPECT_FALSE((pauliX(0) * pauliX(1)).qubitWiseCommutes(pauliZ(0) * pauliZ(1)));
+    EXPECT_TRUE((pauliX(0) * pauliZ(1)).qubitWiseCommutes(pauliX(0) * pauliX(2)));
+}
+
+TEST(testPauli, sum)
+{
+    const PauliSum h = PauliSum(pauliX(0), 2) + PauliSum(pauliZ(1)) - PauliSum(pauliX(0));
+
+    ASSERT_EQ(2, h.terms().size());
+    EXPECT_EQ("(1) Z1 + (1) X0", to_string(h));
+    EXPECT_EQ("(0) I", to_string(h - h));
+    EXPECT_EQ("(i) Z0", to_string(PauliSum(pauliX(0)) * PauliSum(pauliY(0))));
+}
+
+TEST(testPauli, groups)
+{
+    const PauliSum h = PauliSum(pauliX(0)) + PauliSum(pauliX(1)) + PauliSum(pauliZ(0)) + PauliSum(pauliZ(0) * pauliZ(1)) + PauliSum(pauliY(2));
+
+    EXPECT_EQ(2, h.groups().size());
+}
+
+TEST(testPauli, expectation)
+{
+    const Circuit c = Circuit(cnotGate(1, 0)) * Circuit(hGate(0)) * Circuit(sGate(2)) * Circuit(hGate(2));
+    const StatePtr state = SparseState(ketBase(0)).transform(c);
+    const Matrix ket = state->ket();
+    const PauliSum h = PauliSum(pauliX(0) * pauliX(1), 0.5) + PauliSum(pauliZ(0) * pauliZ(1), 2) + PauliSum(pauliY(2), 3) + PauliSum(pauliX(2)) + PauliSum(pauliZ(1)) + PauliSum(PauliString(), 0.25) + PauliSum(pauliX(5));
+
+    // Dense reference <psi| H |psi>
+    const Matrix dense = h.matrix();
+    const Matrix psi = ket.extendsCross(dense.numRows());
+    const complex<double> expected = (psi.dagger() * dense * psi).at(0, 0);
+
+    EXPECT_NEAR(expected.real(), h.expectation(ket.cells()).real(), 1e-12);
+    EXPECT_NEAR(expected.imag(), h.expectation(ket.cells()).imag(), 1e-12);
+    EXPECT_NEAR(expected.real(), h.expectation(*state).real(), 1e-12);
+    EXPECT_NEAR(5.75, expected.real(), 1e-12);
+}
+
+TEST(testPauli, sparseExpectation)
+{
+    // Large register evaluated on the non zero amplitudes
+    const StatePtr state = SparseState(ketBase(0)).transform(Circuit(cnotGate(40, 0)) * Circuit(hGate(0)));
+    const PauliSum h = PauliSum(pauliX(0) * pauliX(40)) + PauliSum(pauliZ(40), 2);
+
+    EXPECT_NEAR(1, h.expectation(*state).real(), 1e-12);
+
+    // Few amplitudes of a register small enough for the dense state vector
+    const StatePtr small = SparseState(ketBase(0)).transform(Circuit(cnotGate(25, 0)) * Circuit(hGate(0)));
+    EXPECT_NEAR(1, (PauliSum(pauliX(0) * pauliX(25)) + PauliSum(pauliZ(25), 2)).expectation(*small).real(), 1e-12);
+}
+
+TEST(testPauli, invalid)
+{
+    EXPECT_THROW(pauliX(64), invalid_argument);
+}
+
+TEST(testPauli, apply)
+{
+    const PauliSum h = PauliSum(pauliX(0) * pauliZ(2), 0.5) + PauliSum(pauliY(1), -1.5) + PauliSum(pauliZ(0) * pauliZ(1));
+    const vu::ComplexVect cells = tu::testCells(3);
+    const vu::ComplexVect act = h.apply(cells);
+    const Matrix exp = h.matrix() * Matrix(8, 1, cells);
+    for (size_t i = 0; i < 8; i++)
+    {
+        EXPECT_NEAR(0, abs(exp.cells()[i] - act[i]), 1e-12) << i;
+    }
+    // X out of the register maps to zero
+    EXPECT_EQ(0.0, PauliSum(pauliX(3)).apply(cells)[0]);
+}
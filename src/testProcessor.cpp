@@ -1,10 +1,15 @@
 #include <gtest/gtest.h>
 
 #include <iostream>
+#include <climits>
 
 #include "processor.h"
 #include "values.h"
 #include "matrix.h"
+#include "circuit.h"
+#include "fourier.h"
+#include "oracle.h"
+#include "sparseState.h"
 #include "tokenizer.h"
 #include "compiler.h"
 #include "qusyntax.h"
@@ -156,7 +161,77 @@ INSTANTIATE_TEST_SUITE_P(testProcessorError,
                              pair<string, string>{"CCNOT(0,0,1);", "Expected all different indices [0, 0, 1]"},
                              pair<string, string>{"CCNOT(0,1,0);", "Expected all different indices [0, 1, 0]"},
                              pair<string, string>{"CCNOT(0,1,1);", "Expected all different indices [0, 1, 1]"},
-                             pair<string, string>{"|1.0>;", "Unexpected argument complex"}));
+                             // 25
+                             pair<string, string>{"|1.0>;", "Unexpected argument complex"},
+                             pair<string, string>{"qmdd(<0|);", "Expected ket, got (1x2)"},
+                             pair<string, string>{"qmdd(1);", "Unexpected argument integer"},
+                             pair<string, string>{"|0> * qmdd(|0>);", "Expected square matrix of size power of 2, got (2x1)"},
+                             pair<string, string>{"amplitude(X(0), density(|0>), 0);", "Unexpected arguments circuit, density, integer"},
+                             // 30
+                             pair<string, string>{"amplitude(X(0), -1, 0);", "Expected non negative basis state, got (-1)"},
+                             pair<string, string>{"amplitude(X(0), |0> + |1>, 0);", "Expected basis state of one non zero amplitude, got (2)"},
+                             pair<string, string>{"hybrid(CNOT(1,0), 0, 2);", "Expected cut in range 1...1, got (2)"},
+                             pair<string, string>{"damp(density(|0>), 0, 2);", "Expected probability in range 0...1, got (2)"},
+                             pair<string, string>{"damp(|0>, 0, 0.1);", "Unexpected arguments matrix, integer, complex"},
+                             // 35
+                             pair<string, string>{"trajectories(X(0), 0, 0.1, 0, 0, 0);", "Expected at least 1 trajectory, got (0)"},
+                             pair<string, string>{"trajectories(X(0), 0, 0, 2, 0, 1);", "Expected probability in range 0...1, got (2)"},
+                             pair<string, string>{"trajectories(X(0), 0, 0, 0, |0>, 1);", "Unexpected arguments circuit, integer, integer, integer, matrix, integer"},
+                             pair<string, string>{"sample(|0>, 0);", "Expected at least 1 shot, got (0)"},
+                             pair<string, string>{"sample(X(0), 1);", "Unexpected arguments circuit, integer"},
+                             // 40
+                             pair<string, string>{"sample(<0|, 1);", "Expected ket, got (1x2)"},
+                             pair<string, string>{"topk(|0>, 0);", "Expected at least 1 basis state, got (0)"},
+                             pair<string, string>{"topk(<0|, 1);", "Expected ket, got (1x2)"},
+                             pair<string, string>{"measure(|0>, -1);", "Expected qubit >= 0, got (-1)"},
+                             pair<string, string>{"measure((|0> - |0>), 0);", "Expected non zero state"},
+                             // 45
+                             pair<string, string>{"measure(|1>, 64);", "Qubit index out of range 0...63, got (64)"},
+                             pair<string, string>{"measure(sparse(|1>), 70);", "Qubit index out of range 0...63, got (70)"},
+                             pair<string, string>{"normalise(|0> - |0>);", "Expected non zero vector"},
+                             pair<string, string>{"inner(|0>, |2>);", "Expected same size matrices, got (2x1) and (4x1)"},
+                             pair<string, string>{"PX(-1);", "Expected qubit >= 0, got (-1)"},
+                             // 50
+                             pair<string, string>{"expect(|0>, |0>);", "Unexpected arguments matrix, matrix"},
+                             pair<string, string>{"RX(|0>, 1);", "Unexpected arguments matrix, integer"},
+                             pair<string, string>{"RY(0, |0>);", "Unexpected arguments integer, matrix"},
+                             pair<string, string>{"RZ(-1, 1);", "Expected qubit >= 0, got (-1)"},
+                             pair<string, string>{"PHASE(0, i);", "Expected real angle, got (0,1)"},
+                             // 55
+                             pair<string, string>{"U3(0, 1, 2, |0>);", "Unexpected arguments integer, integer, integer, matrix"},
+                             pair<string, string>{"controlled(1, 0, 1);", "Unexpected arguments integer, integer, integer"},
+                             pair<string, string>{"controlled(X(0), 0, |0>);", "Unexpected arguments circuit, integer, matrix"},
+                             pair<string, string>{"controlled(|0>, 0, 1);", "Expected square gate matrix of size power of 2, got (2x1)"},
+                             pair<string, string>{"controlled(SWAP(0,1), 0, 1);", "Expected at least 3 qubits, got (2)"},
+                             // 60
+                             pair<string, string>{"controlled(X(0), -1, 1);", "Expected qubit >= 0, got (-1)"},
+                             pair<string, string>{"controlled(X(0), 1, 1);", "Expected all different indices [1, 1]"},
+                             pair<string, string>{"QFT(0, |0>);", "Unexpected arguments integer, matrix"},
+                             pair<string, string>{"IQFT(-1);", "Expected qubit >= 0, got (-1)"},
+                             pair<string, string>{"QFT(1, 1);", "Expected all different indices [1, 1]"},
+                             // 65
+                             pair<string, string>{"HN(0, |0>);", "Unexpected arguments integer, matrix"},
+                             pair<string, string>{"oracle(0, 1);", "Unexpected arguments integer, integer"},
+                             pair<string, string>{"oracle(|4>, 0, 1);", "Expected ket of at most 4 rows, got (8x1)"},
+                             pair<string, string>{"oracle(<0|, 0);", "Expected ket of at most 2 rows, got (1x2)"},
+                             pair<string, string>{"oracle(|0>, -1);", "Expected qubit >= 0, got (-1)"},
+                             // 70
+                             pair<string, string>{"oracle(|0>, 1, 1);", "Expected all different indices [1, 1]"},
+                             pair<string, string>{"batch(|0>, 1);", "Unexpected arguments matrix, integer"},
+                             pair<string, string>{"batch(|0>, <1|);", "Expected ket, got (1x2)"},
+                             pair<string, string>{"column(batch(|0>, |1>), 2);", "Expected column 0...1, got (2)"},
+                             pair<string, string>{"column(1, 0);", "Unexpected arguments integer, integer"},
+                             // 75
+                             pair<string, string>{"exp(|0>);", "Expected square matrix, got (2x1)"},
+                             pair<string, string>{"expv(|0>, PZ(0), |0>);", "Unexpected arguments matrix, pauli, matrix"},
+                             pair<string, string>{"expv(1, PZ(0), <0|);", "Expected ket, got (1x2)"},
+                             pair<string, string>{"expv(1, |0>, |0>);", "Expected 2x2 matrix, got (2x1)"},
+                             pair<string, string>{"pow(|0>, 2);", "Expected square matrix, got (2x1)"},
+                             // 80
+                             pair<string, string>{"pow(X(0), -1);", "Expected non negative exponent, got (-1)"},
+                             pair<string, string>{"pow(|0>, i);", "Unexpected arguments matrix, complex"},
+                             pair<string, string>{"ptrace(1, 0);", "Unexpected arguments integer, integer"},
+                             pair<string, string>{"ptrace(|1>, -1);", "Expected qubit >= 0, got (-1)"}));
 
 static const Matrix KET0(2, 1, {1, 0});
 static const Matrix KET3(4, 1, {0, 0, 0, 1});
@@ -378,4 +453,106 @@ INSTANTIATE_TEST_SUITE_P(testProcessor,
                              pair<string, Value *>{"<0| . |0>;", new ListValue(SOURCE, {new ComplexValue(SOURCE, 1)})},
                              pair<string, Value *>{"|1> . <0|;", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {0, 0, 1, 0}))})},
                              pair<string, Value *>{"1.2;", new ListValue(SOURCE, {new ComplexValue(SOURCE, 1.2)})},
-                             pair<string, Value *>{"1;", new ListValue(SOURCE, {new IntValue(SOURCE, 1)})}));
+                             pair<string, Value *>{"1;", new ListValue(SOURCE, {new IntValue(SOURCE, 1)})},
+                             // 95
+                             pair<string, Value *>{"sparse(|1>);", new ListValue(SOURCE, {new StateValue(SOURCE, make_shared<SparseState>(ketBase(1)))})},
+                             pair<string, Value *>{"CNOT(1,0) * sparse(|1>);", new ListValue(SOURCE, {new StateValue(SOURCE, make_shared<SparseState>(ketBase(3)))})},
+                             pair<string, Value *>{"CNOT(60,0) * X(2) * sparse(|1>);", new ListValue(SOURCE, {new StateValue(SOURCE, SparseState(ketBase(1)).transform(Circuit(cnotGate(60, 0)) * Circuit(xGate(2))))})},
+                             pair<string, Value *>{"CNOT(60,0) * X(2);", new ListValue(SOURCE, {new CircuitValue(SOURCE, Circuit(cnotGate(60, 0)) * Circuit(xGate(2)))})},
+                             pair<string, Value *>{"CNOT(1,0) * CNOT(2,1) * |1>;", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(3))})},
+                             // 100
+                             pair<string, Value *>{"S(0)^;", new ListValue(SOURCE, {new MatrixValue(SOURCE, S0.dagger())})},
+                             pair<string, Value *>{"(H(0) * sparse(|0>))^;", new ListValue(SOURCE, {new MatrixValue(SOURCE, PLUS_KET.dagger())})},
+                             pair<string, Value *>{"CNOT(60,0) * X(2) * qmdd(|1>);", new ListValue(SOURCE, {new StateValue(SOURCE, make_shared<SparseState>(ketBase(1))->transform(Circuit(cnotGate(60, 0)) * Circuit(xGate(2))))})},
+                             pair<string, Value *>{"H(1) * qmdd(|0>);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(4, 1, {HALF_SQRT2, 0, HALF_SQRT2, 0}))})},
+                             pair<string, Value *>{"qubit1(1,2) * CNOT(1,0) * H(0) * qmdd(|0>);", new ListValue(SOURCE, {new StateValue(SOURCE, make_shared<SparseState>(ketBase(3) * HALF_SQRT2))})},
+                             // 105
+                             pair<string, Value *>{"qubit1(1,2) * CNOT(1,0) * H(0) * sparse(|0>);", new ListValue(SOURCE, {new StateValue(SOURCE, make_shared<SparseState>(ketBase(3) * HALF_SQRT2))})},
+                             pair<string, Value *>{"amplitude(CNOT(40,0) * X(0), 1, 0);", new ListValue(SOURCE, {new ComplexValue(SOURCE, 0)})},
+                             pair<string, Value *>{"amplitude(CNOT(1,0) * X(0), 3, 0);", new ListValue(SOURCE, {new ComplexValue(SOURCE, 1)})},
+                             pair<string, Value *>{"amplitude(CNOT(1,0), 3, 1);", new ListValue(SOURCE, {new ComplexValue(SOURCE, 1)})},
+                             pair<string, Value *>{"amplitude(CNOT(40,0) * X(0), CNOT(40,0) * X(0) * sparse(|0>), |0>);", new ListValue(SOURCE, {new ComplexValue(SOURCE, 1)})},
+                             // 110
+                             pair<string, Value *>{"amplitude(X(33), X(33) * sparse(|1>), |1>);", new ListValue(SOURCE, {new ComplexValue(SOURCE, 1)})},
+                             pair<string, Value *>{"hybrid(CNOT(3,0) * X(0), 0, 2);", new ListValue(SOURCE, {new StateValue(SOURCE, make_shared<SparseState>(ketBase(9)))})},
+                             pair<string, Value *>{"density(|1>);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {0, 0, 0, 1}))})},
+                             pair<string, Value *>{"X(0) * density(|1>);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {1, 0, 0, 0}))})},
+                             pair<string, Value *>{"qubit1(0,1) . damp(density(|1>), 0, 1);", new ListValue(SOURCE, {new ComplexValue(SOURCE, 0)})},
+                             // 115
+                             pair<string, Value *>{"qubit1(1,2) . (X(1) * density(|1>));", new ListValue(SOURCE, {new ComplexValue(SOURCE, 1)})},
+                             pair<string, Value *>{"dephase(density(|0>), 0, 1);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {1, 0, 0, 0}))})},
+                             pair<string, Value *>{"depolarize(density(|0>), 0, 0);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {1, 0, 0, 0}))})},
+                             pair<string, Value *>{"trajectories(CNOT(1,0) * X(0), 0, 0, 0, 0, 3);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {1, 0, 1, 0}))})},
+                             pair<string, Value *>{"trajectories(CNOT(1,0), |1>, 0, 0, 1, 3);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {1, 0, 1, 0}))})},
+                             // 120
+                             pair<string, Value *>{"trajectories(X(1), 1, 0, 1, 0, 3);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {1, 0, 0, 0}))})},
+                             pair<string, Value *>{"CNOT(1,0) * X(0) * shard(|0>);", new ListValue(SOURCE, {new StateValue(SOURCE, make_shared<SparseState>(ketBase(3)))})},
+                             pair<string, Value *>{"CNOT(1,0) * X(0) * mapped(|0>);", new ListValue(SOURCE, {new StateValue(SOURCE, make_shared<SparseState>(ketBase(3)))})},
+                             pair<string, Value *>{"CNOT(2,0) * (product(|1>) x product(|1>));", new ListValue(SOURCE, {new StateValue(SOURCE, make_shared<SparseState>(ketBase(7)))})},
+                             pair<string, Value *>{"sparse(|1>) x sparse(|1>);", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(3))})},
+                             // 125
+                             pair<string, Value *>{"sample(CNOT(1,0) * X(0) * sparse(|0>), 10);", new ListValue(SOURCE, {new ListValue(SOURCE, {new ListValue(SOURCE, {new StateValue(SOURCE, make_shared<SparseState>(ketBase(3))), new IntValue(SOURCE, 10)})})})},
+                             pair<string, Value *>{"sample(|2>, 5);", new ListValue(SOURCE, {new ListValue(SOURCE, {new ListValue(SOURCE, {new StateValue(SOURCE, make_shared<SparseState>(ketBase(2))), new IntValue(SOURCE, 5)})})})},
+                             pair<string, Value *>{"sample(X(63) * sparse(|1>), 3);", new ListValue(SOURCE, {new ListValue(SOURCE, {new ListValue(SOURCE, {new StateValue(SOURCE, SparseState(ketBase(1)).transform(Circuit(xGate(63)))), new IntValue(SOURCE, 3)})})})},
+                             pair<string, Value *>{"topk(CNOT(1,0) * X(0) * sparse(|0>), 2);", new ListValue(SOURCE, {new ListValue(SOURCE, {new ListValue(SOURCE, {new StateValue(SOURCE, make_shared<SparseState>(ketBase(3))), new ComplexValue(SOURCE, 1), new ComplexValue(SOURCE, 1)})})})},
+                             pair<string, Value *>{"topk(|0> + |1> * 2, 2);", new ListValue(SOURCE, {new ListValue(SOURCE, {new ListValue(SOURCE, {new StateValue(SOURCE, make_shared<SparseState>(ketBase(1))), new ComplexValue(SOURCE, 2), new ComplexValue(SOURCE, 4)}), new ListValue(SOURCE, {new StateValue(SOURCE, make_shared<SparseState>(ketBase(0))), new ComplexValue(SOURCE, 1), new ComplexValue(SOURCE, 1)})})})},
+                             // 130
+                             pair<string, Value *>{"topk(X(63) * sparse(|1>), 1);", new ListValue(SOURCE, {new ListValue(SOURCE, {new ListValue(SOURCE, {new StateValue(SOURCE, SparseState(ketBase(1)).transform(Circuit(xGate(63)))), new ComplexValue(SOURCE, 1), new ComplexValue(SOURCE, 1)})})})},
+                             pair<string, Value *>{"measure(|2>, 1);", new ListValue(SOURCE, {new ListValue(SOURCE, {new IntValue(SOURCE, 1), new MatrixValue(SOURCE, ketBase(2))})})},
+                             pair<string, Value *>{"measure(X(1) * sparse(|0>), 0);", new ListValue(SOURCE, {new ListValue(SOURCE, {new IntValue(SOURCE, 0), new StateValue(SOURCE, make_shared<SparseState>(ketBase(2)))})})},
+                             pair<string, Value *>{"normalise(|0> * 2);", new ListValue(SOURCE, {new MatrixValue(SOURCE, KET0)})},
+                             pair<string, Value *>{"norm(|0> * 3 - |1> * 4);", new ListValue(SOURCE, {new ComplexValue(SOURCE, 5)})},
+                             // 135
+                             pair<string, Value *>{"norm(-3);", new ListValue(SOURCE, {new IntValue(SOURCE, 3)})},
+                             pair<string, Value *>{"inner(|0> + |1>, |1> * i);", new ListValue(SOURCE, {new ComplexValue(SOURCE, complex<double>(0, 1))})},
+                             pair<string, Value *>{"PX(0) * PY(0);", new ListValue(SOURCE, {new PauliValue(SOURCE, make_shared<PauliSum>(pauliZ(0), complex<double>(0, 1)))})},
+                             pair<string, Value *>{"2 * PZ(1) + PX(0) - PX(0);", new ListValue(SOURCE, {new PauliValue(SOURCE, make_shared<PauliSum>(pauliZ(1), 2))})},
+                             pair<string, Value *>{"expect(PZ(0) . PZ(1) - PZ(0), CNOT(1,0) * X(0) * sparse(|0>));", new ListValue(SOURCE, {new ComplexValue(SOURCE, 2)})},
+                             // 140
+                             pair<string, Value *>{"expect(-PZ(0), |1>);", new ListValue(SOURCE, {new ComplexValue(SOURCE, 1)})},
+                             pair<string, Value *>{"PX(0) . |0>;", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(1))})},
+                             pair<string, Value *>{"RX(0, 0) * |1>;", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(1))})},
+                             pair<string, Value *>{"RZ(1, 0) * |2>;", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(2))})},
+                             pair<string, Value *>{"PHASE(0, 1.5) * |0>;", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(0))})},
+                             // 145
+                             pair<string, Value *>{"U3(0, 0, 0, 0) * |1>;", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(1))})},
+                             pair<string, Value *>{"controlled(X(0), 1, 0);", new ListValue(SOURCE, {new MatrixValue(SOURCE, mx::CNOT(0, 1))})},
+                             pair<string, Value *>{"controlled(X(0), 1, 2, 0);", new ListValue(SOURCE, {new MatrixValue(SOURCE, mx::CCNOT(0, 1, 2))})},
+                             pair<string, Value *>{"controlled(X(0), 1, 2, 3, 0) * |14>;", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(15))})},
+                             pair<string, Value *>{"QFT(1, 0);", new ListValue(SOURCE, {new MatrixValue(SOURCE, createGate(fourierMatrix(2, false), {1, 0}))})},
+                             // 150
+                             pair<string, Value *>{"IQFT(0);", new ListValue(SOURCE, {new MatrixValue(SOURCE, fourierMatrix(1, true))})},
+                             pair<string, Value *>{"HN(1, 0);", new ListValue(SOURCE, {new MatrixValue(SOURCE, createGate(hadamardMatrix(2), {1, 0}))})},
+                             pair<string, Value *>{"H(0) * H(1) * |0>;", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(4, 1, {0.5, 0.5, 0.5, 0.5}))})},
+                             pair<string, Value *>{"oracle(|1> + |2>, 1, 0);", new ListValue(SOURCE, {new MatrixValue(SOURCE, createGate(oracleMatrix(2, {1, 2}), {1, 0}))})},
+                             pair<string, Value *>{"oracle(|3>, 0, 2) * |5>;", new ListValue(SOURCE, {new MatrixValue(SOURCE, -ketBase(5))})},
+                             // 155
+                             pair<string, Value *>{"SWAP(1, 2) * CNOT(2, 0) * |1>;", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(3))})},
+                             pair<string, Value *>{"batch(|1>, |2>);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(4, 2, {0, 0, 1, 0, 0, 1, 0, 0}))})},
+                             pair<string, Value *>{"column(X(0) * CNOT(1, 0) * batch(|0>, |1>, |3>), 1);", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(2))})},
+                             pair<string, Value *>{"column(X(0) * CNOT(1, 0) * batch(|0>, |1>, |3>), 2);", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(0).extendsRows(4))})},
+                             pair<string, Value *>{"exp(0);", new ListValue(SOURCE, {new ComplexValue(SOURCE, 1)})},
+                             // 160
+                             pair<string, Value *>{"exp(|0> x <1|);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {1, 1, 0, 1}))})},
+                             pair<string, Value *>{"exp(PZ(0) * 0);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {1, 0, 0, 1}))})},
+                             pair<string, Value *>{"expv(0, PX(1), |1>);", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(1).extendsRows(4))})},
+                             pair<string, Value *>{"expv(2, |0> x <0|, |0>);", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(0) * exp(2.0))})},
+                             pair<string, Value *>{"expv(2, Z(0), |0>);", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(0) * exp(2.0))})},
+                             // 165
+                             pair<string, Value *>{"pow(2, 10);", new ListValue(SOURCE, {new IntValue(SOURCE, 1024)})},
+                             pair<string, Value *>{"pow(2, 16);", new ListValue(SOURCE, {new IntValue(SOURCE, 65536)})},
+                             pair<string, Value *>{"pow(-2, 31);", new ListValue(SOURCE, {new IntValue(SOURCE, INT_MIN)})},
+                             pair<string, Value *>{"pow(3, 20);", new ListValue(SOURCE, {new ComplexValue(SOURCE, pow(complex<double>(3), 20.0))})},
+                             pair<string, Value *>{"pow(2, -1);", new ListValue(SOURCE, {new ComplexValue(SOURCE, 0.5)})},
+                             // 170
+                             pair<string, Value *>{"pow(|0> x <1|, 2);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {0, 0, 0, 0}))})},
+                             pair<string, Value *>{"pow(X(0), 3) * |0>;", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(1))})},
+                             pair<string, Value *>{"pow(CNOT(1, 0) * X(0), 4) * |0>;", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(0).extendsRows(4))})},
+                             pair<string, Value *>{"pow(2 * PZ(1), 2);", new ListValue(SOURCE, {new PauliValue(SOURCE, make_shared<PauliSum>(PauliString(), 4))})},
+                             pair<string, Value *>{"ptrace(|2>, 1);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {0, 0, 0, 1}))})},
+                             // 175
+                             pair<string, Value *>{"ptrace(|2>, 0);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {1, 0, 0, 0}))})},
+                             pair<string, Value *>{"ptrace(|1>, 2, 0);", new ListValue(SOURCE, {new MatrixValue(SOURCE, ketBase(2) * ketBase(2).dagger())})},
+                             pair<string, Value *>{"ptrace(|1> x <1|, 0);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {0, 0, 0, 1}))})},
+                             pair<string, Value *>{"ptrace(CNOT(1, 0), 0);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {2, 0, 0, 0}))})},
+                             pair<string, Value *>{"ptrace(density(|3>), 1);", new ListValue(SOURCE, {new MatrixValue(SOURCE, Matrix(2, 2, {0, 0, 0, 1}))})}));
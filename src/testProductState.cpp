@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include "productState.h"
+#include "sparseState.h"
+
+using namespace std;
+using namespace mx;
+
+TEST(testProductState, factorize)
+{
+    // |1> x (|00> + |11>) / sqrt(2) x |+>
+    const Matrix bell = Matrix(4, 1, {1, 0, 0, 1}) * (1 / sqrt(2.0));
+    const Matrix plus = Matrix(2, 1, {1, 1}) * (1 / sqrt(2.0));
+    const Matrix ket = ketBase(1).cross(bell).cross(plus);
+    const ProductState state(ket);
+
+    EXPECT_EQ(4, state.numQubits());
+    EXPECT_EQ(3, state.numClusters());
+    EXPECT_EQ(2, state.maxClusterQubits());
+    for (size_t i = 0; i < ket.numRows(); i++)
+    {
+        EXPECT_NEAR(ket.cells()[i].real(), state.at(i).real(), 1e-12);
+    }
+}
+
+TEST(testProductState, localGates)
+{
+    ProductState state(ketBase(0));
+    state.apply(Circuit(hGate(0)) * Circuit(xGate(20)) * Circuit(hGate(40)));
+
+    EXPECT_EQ(41, state.numQubits());
+    EXPECT_EQ(1, state.maxClusterQubits());
+    EXPECT_NEAR(0.5, state.at((1ULL << 40) | (1ULL << 20) | 1).real(), 1e-12);
+    EXPECT_EQ(0.0, state.at(1));
+}
+
+TEST(testProductState, entangle)
+{
+    const Circuit c = Circuit(hGate(0)) * Circuit(hGate(2)) * Circuit(cnotGate(1, 0)) * Circuit(ccnotGate(3, 1, 2)) * Circuit(swapGate(4, 0));
+    ProductState state(ketBase(0));
+    state.apply(c);
+
+    EXPECT_EQ(5, state.maxClusterQubits());
+    EXPECT_EQ(to_string(SparseState(ketBase(0)).transform(c)->ket()), to_string(state.ket()));
+}
+
+TEST(testProductState, cross)
+{
+    const ProductState state = ProductState(ketBase(1)).cross(ProductState(ketBase(2)));
+
+    EXPECT_EQ(3, state.numQubits());
+    EXPECT_EQ(1.0, state.at(6));
+    EXPECT_EQ(0.0, state.at(5));
+}
+
+TEST(testProductState, invalid)
+{
+    EXPECT_THROW(ProductState(Matrix(2, 2, {1, 0, 0, 1})), invalid_argument);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include "reversible.h"
+#include "circuit.h"
+#include "testUtils.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+using namespace tu;
+
+TEST(testReversible, ops)
+{
+    // CNOT(0, 1) then X(2)
+    const vector<ReversibleOp> ops{ReversibleOp{2, 1}, ReversibleOp{0, 4}};
+    EXPECT_EQ(4, applyReversible(0, ops));
+    EXPECT_EQ(7, applyReversible(2, ops));
+    EXPECT_EQ(1, applyReversible(5, ops));
+    EXPECT_EQ(to_string((Circuit(xGate(2)) * Circuit(cnotGate(0, 1))).matrix()), to_string(reversibleMatrix(3, ops)));
+}
+
+TEST(testReversible, gateOps)
+{
+    EXPECT_EQ(1, reversibleOps(xGate(1)).size());
+    EXPECT_EQ(4, reversibleOps(xGate(2)).at(0).flips);
+    EXPECT_EQ(2, reversibleOps(cnotGate(0, 1)).at(0).controls);
+    EXPECT_EQ(6, reversibleOps(ccnotGate(0, 1, 2)).at(0).controls);
+    EXPECT_EQ(9, reversibleOps(controlledGate(X_GATE, {0, 3}, {1})).at(0).controls);
+    EXPECT_EQ(3, reversibleOps(swapGate(0, 1)).size());
+    EXPECT_TRUE(reversibleOps(hGate(0)).empty());
+    EXPECT_TRUE(reversibleOps(controlledGate(Z_GATE, {0}, {1})).empty());
+}
+
+TEST(testReversible, gate)
+{
+    const vector<Gate> gates{cnotGate(1, 0), cnotGate(2, 1), ccnotGate(3, 1, 2), swapGate(0, 3), xGate(2)};
+    const Gate rev = reversibleGate(gates);
+    EXPECT_EQ("REV(0,1,2,3)", rev.name());
+    EXPECT_EQ(GateKernel::reversible, rev.kernel());
+    EXPECT_TRUE(rev.isPermutation());
+    EXPECT_FALSE(rev.isDense());
+
+    const Circuit c(gates);
+    EXPECT_EQ(to_string(c.matrix()), to_string(rev.matrix()));
+    EXPECT_EQ(to_string(c.dagger().matrix()), to_string(rev.dagger().matrix()));
+    EXPECT_EQ(to_string(c.matrix()), to_string(reversibleGate({rev}).matrix()));
+
+    ComplexVect act = testCells(5);
+    rev.apply(act);
+    const Matrix exp = c.matrix().extendsCross(32) * Matrix(32, 1, testCells(5));
+    for (size_t i = 0; i < 32; i++)
+    {
+        EXPECT_EQ(exp.cells()[i], act[i]) << i;
+    }
+    EXPECT_THROW(reversibleGate({}), invalid_argument);
+    EXPECT_THROW(reversibleGate({xGate(0), hGate(0)}), invalid_argument);
+}
+
+TEST(testReversible, remap)
+{
+    const Gate rev = reversibleGate({cnotGate(1, 0), xGate(0)}).remap({2, 3}, {0});
+    ComplexVect act = testCells(4);
+    rev.apply(act);
+    const Matrix exp = rev.matrix().extendsCross(16) * Matrix(16, 1, testCells(4));
+    for (size_t i = 0; i < 16; i++)
+    {
+        EXPECT_EQ(exp.cells()[i], act[i]) << i;
+    }
+}
+
+TEST(testReversible, parallel)
+{
+    const size_t n = 18;
+    const ComplexVect cells = testCells(n);
+    const vector<ReversibleOp> ops{ReversibleOp{1, 1ULL << 17}, ReversibleOp{(1ULL << 17) | 2, 1 | 8}, ReversibleOp{0, 1ULL << 5}};
+    ComplexVect act = cells;
+    reversible(act.data(), act.size(), ops, 4);
+    for (size_t i = 0; i < act.size(); i++)
+    {
+        ASSERT_EQ(cells[i], act[applyReversible(i, ops)]) << i;
+    }
+    EXPECT_THROW(reversible(act.data(), 1ULL << 17, ops), invalid_argument);
+}
+
+TEST(testReversible, fused)
+{
+    // Gates are applied from the right
+    const Circuit c = Circuit(xGate(0)) * Circuit(cnotGate(1, 0)) * Circuit(hGate(2)) * Circuit(ccnotGate(2, 0, 1)) * Circuit(swapGate(0, 1)) * Circuit(hGate(0));
+    const Circuit f = c.fused();
+    ASSERT_EQ(4, f.gates().size());
+    EXPECT_EQ(hGate(0).name(), f.gates()[0].name());
+    EXPECT_EQ("REV(0,1,2)", f.gates()[1].name());
+    EXPECT_EQ(hGate(2).name(), f.gates()[2].name());
+    EXPECT_EQ("REV(0,1)", f.gates()[3].name());
+    EXPECT_EQ(to_string(c.matrix()), to_string(f.matrix()));
+}
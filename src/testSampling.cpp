@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include "sampling.h"
+#include "sparseState.h"
+#include "decisionDiagram.h"
+#include "productState.h"
+#include "mappedState.h"
+#include "shardedState.h"
+#include "testUtils.h"
+
+using namespace std;
+using namespace mx;
+using namespace tu;
+
+TEST(testSampling, aliasTable)
+{
+    const AliasTable table({1, 0, 3});
+    mt19937_64 random(1);
+    vector<size_t> counts(3, 0);
+    for (size_t i = 0; i < 40000; i++)
+    {
+        counts[table.sample(random)]++;
+    }
+
+    EXPECT_EQ(3, table.size());
+    EXPECT_EQ(0, counts[1]);
+    EXPECT_NEAR(0.25, counts[0] / 40000.0, 0.01);
+    EXPECT_NEAR(0.75, counts[2] / 40000.0, 0.01);
+}
+
+TEST(testSampling, basisState)
+{
+    const Sampler sampler(SparseState(ketBase(5)));
+    const auto counts = sampler.sample(100);
+
+    ASSERT_EQ(1, counts.size());
+    EXPECT_EQ(5, counts[0].first);
+    EXPECT_EQ(100, counts[0].second);
+}
+
+TEST(testSampling, histogram)
+{
+    const StatePtr state = SparseState(ketBase(0)).transform(Circuit(cnotGate(3, 0)) * Circuit(hGate(0)));
+    const size_t shots = 200000;
+    const auto counts = Sampler(*state).sample(shots);
+
+    ASSERT_EQ(2, counts.size());
+    EXPECT_EQ(0, counts[0].first);
+    EXPECT_EQ(9, counts[1].first);
+    EXPECT_EQ(shots, counts[0].second + counts[1].second);
+    EXPECT_NEAR(0.5, counts[0].second / (double)shots, 0.01);
+}
+
+TEST(testSampling, deterministic)
+{
+    const StatePtr state = SparseState(ketBase(0)).transform(Circuit(hGate(0)) * Circuit(hGate(1)) * Circuit(hGate(2)));
+    const Sampler sampler(*state);
+
+    EXPECT_EQ(sampler.sample(300000, 7, 1), sampler.sample(300000, 7, 4));
+}
+
+TEST(testSampling, dense)
+{
+    const vu::ComplexVect cells{0, sqrt(0.25), 0, sqrt(0.75)};
+    const size_t shots = 100000;
+    const auto counts = Sampler(cells).sample(shots, 3);
+
+    ASSERT_EQ(2, counts.size());
+    EXPECT_EQ(1, counts[0].first);
+    EXPECT_EQ(3, counts[1].first);
+    EXPECT_NEAR(0.25, counts[0].second / (double)shots, 0.01);
+}
+
+TEST(testSampling, topK)
+{
+    const Matrix ket(8, 1, {0.1, 0.3, 0.5, 0.3, 0, 0.2, 0.6, 0.4});
+    const SparseState state(ket);
+    const auto top = topK(state, 3);
+
+    ASSERT_EQ(3, top.size());
+    EXPECT_EQ(6, top[0].first);
+    EXPECT_EQ(2, top[1].first);
+    EXPECT_EQ(7, top[2].first);
+    EXPECT_EQ(0.6, top[0].second);
+
+    EXPECT_EQ(topK(state, 5), topK(ket.cells(), 5, 1));
+    EXPECT_EQ(topK(ket.cells(), 5, 1), topK(ket.cells(), 5, 3));
+    EXPECT_EQ(7, topK(state, 10).size());
+    EXPECT_EQ(7, topK(ket.cells(), 10).size());
+}
+
+TEST(testSampling, collapse)
+{
+    // (|0> + |3>) / sqrt(2) collapses to |0> or |3>
+    vu::ComplexVect cells{sqrt(0.5), 0, 0, sqrt(0.5)};
+    mt19937_64 random(1);
+    const int outcome = collapse(cells, 1, random);
+    const size_t kept = outcome == 1 ? 3 : 0;
+
+    EXPECT_NEAR(1, cells[kept].real(), 1e-12);
+    EXPECT_EQ(0.0, cells[3 - kept]);
+    EXPECT_EQ(0.0, cells[1]);
+}
+
+TEST(testSampling, measure)
+{
+    const StatePtr state = SparseState(ketBase(0)).transform(Circuit(cnotGate(2, 0)) * Circuit(hGate(0)));
+    mt19937_64 random(3);
+    size_t ones = 0;
+    for (size_t i = 0; i < 1000; i++)
+    {
+        const auto [outcome, collapsed] = measure(*state, 2, random);
+        ones += outcome;
+        EXPECT_NEAR(1, norm(collapsed->at(outcome == 1 ? 5 : 0)), 1e-12);
+        EXPECT_EQ(1, collapsed->amplitudes().size());
+    }
+
+    EXPECT_NEAR(500, ones, 60);
+}
+
+TEST(testSampling, project)
+{
+    vu::ComplexVect cells = testCells(3);
+    vu::normalise(cells);
+    const Matrix ket(8, 1, cells);
+    const vector<StatePtr> states{make_shared<SparseState>(ket), make_shared<DDState>(ket), make_shared<ProductState>(ket),
+                                  make_shared<MappedState>(ket, 1), make_shared<ShardedState>(make_shared<LocalTransport>(), ket)};
+    // Each backend projects its own storage as the dense projection
+    for (size_t qubit = 0; qubit < 3; qubit++)
+    {
+        for (int outcome = 0; outcome < 2; outcome++)
+        {
+            double p = 0;
+            vu::ComplexVect exp(8, 0);
+            for (size_t i = 0; i < 8; i++)
+            {
+                if ((int)((i >> qubit) & 1) == outcome)
+                {
+                    p += norm(cells[i]);
+                    exp[i] = cells[i];
+                }
+            }
+            for (complex<double> &cell : exp)
+            {
+                cell /= sqrt(p);
+            }
+            for (const StatePtr &state : states)
+            {
+                expectNear(Matrix(8, 1, exp), state->project(qubit, outcome, p)->ket());
+            }
+        }
+    }
+}
+
+TEST(testSampling, invalid)
+{
+    EXPECT_THROW(AliasTable({0, 0}), invalid_argument);
+    EXPECT_THROW(AliasTable({1, -1}), invalid_argument);
+    EXPECT_THROW(Sampler(SparseState(ketBase(0))).sample(0), invalid_argument);
+    mt19937_64 random(1);
+    EXPECT_THROW(measure(SparseState(2), 0, random), invalid_argument);
+}
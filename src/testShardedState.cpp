@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "shardedState.h"
+#include "sparseState.h"
+
+using namespace std;
+using namespace mx;
+
+/**
+ * Runs the function on each rank of a Unix socket mesh and returns the results
+ * @param size the number of workers
+ * @param f the function
+ */
+template <class T>
+static const vector<T> runWorkers(const size_t size, const function<T(const shared_ptr<Transport> &)> &f)
+{
+    const vector<vector<int>> mesh = SocketTransport::mesh(size);
+    vector<T> results(size);
+    vector<thread> threads;
+    for (size_t rank = 0; rank < size; rank++)
+    {
+        threads.emplace_back([&, rank]()
+                             { results[rank] = f(make_shared<SocketTransport>(rank, mesh[rank])); });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    return results;
+}
+
+TEST(testShardedState, local)
+{
+    ShardedState state(make_shared<LocalTransport>(), ketBase(0));
+    state.apply(Circuit(hGate(0)) * Circuit(cnotGate(2, 0)));
+
+    EXPECT_EQ(3, state.numQubits());
+    EXPECT_EQ(0, state.numGlobal());
+    EXPECT_EQ(to_string(SparseState(ketBase(0)).transform(Circuit(hGate(0)) * Circuit(cnotGate(2, 0)))->ket()),
+              to_string(state.ket()));
+}
+
+TEST(testShardedState, layout)
+{
+    const vector<vu::ComplexVect> shards = runWorkers<vu::ComplexVect>(4, [](const shared_ptr<Transport> &transport)
+                                                                       { return ShardedState(transport, ketBase(9)).shard(); });
+
+    // 5 qubits, 2 global and 3 local qubits
+    EXPECT_EQ(8, shards[0].size());
+    EXPECT_EQ(0.0, shards[0][1]);
+    EXPECT_EQ(1.0, shards[1][1]);
+}
+
+TEST(testShardedState, globalGates)
+{
+    // Gates on global qubits, local qubits and a resize of the register
+    const Circuit c = Circuit(hGate(0)) * Circuit(hGate(3)) * Circuit(cnotGate(3, 1)) * Circuit(cnotGate(0, 2)) * Circuit(swapGate(3, 0)) * Circuit(cnotGate(5, 4)) * Circuit(hGate(5));
+    const string expected = to_string(SparseState(ketBase(16)).transform(c)->ket());
+    const vector<string> results = runWorkers<string>(4, [&c](const shared_ptr<Transport> &transport)
+                                                      {
+        ShardedState state(transport, ketBase(16));
+        state.apply(c);
+        return to_string(state.ket()); });
+
+    for (const string &result : results)
+    {
+        EXPECT_EQ(expected, result);
+    }
+}
+
+TEST(testShardedState, controlled)
+{
+    // Controls and targets on global and local qubits
+    const Circuit c = Circuit(hGate(4)) * Circuit(hGate(0)) * Circuit(controlledGate(H_GATE, {4}, {3})) * Circuit(controlledGate(X_GATE, {0, 3}, {4})) * Circuit(controlledGate(SWAP_GATE, {4}, {0, 1}));
+    const string expected = to_string(SparseState(ketBase(0)).transform(c)->ket());
+    const vector<string> results = runWorkers<string>(4, [&c](const shared_ptr<Transport> &transport)
+                                                      {
+        ShardedState state(transport, ketBase(0));
+        state.apply(c);
+        return to_string(state.ket()); });
+
+    for (const string &result : results)
+    {
+        EXPECT_EQ(expected, result);
+    }
+}
+
+TEST(testShardedState, fourier)
+{
+    // Transform on global and local qubits
+    const Circuit c = Circuit(qftGate({0, 4, 3}, false)) * Circuit(hGate(4)) * Circuit(hGate(2));
+    const Matrix expected = c.matrix() * ketBase(5);
+    const vector<vu::ComplexVect> results = runWorkers<vu::ComplexVect>(4, [&c](const shared_ptr<Transport> &transport)
+                                                                        {
+        ShardedState state(transport, ketBase(5));
+        state.apply(c);
+        return state.ket().cells(); });
+
+    for (const vu::ComplexVect &result : results)
+    {
+        for (size_t i = 0; i < expected.numRows(); i++)
+        {
+            EXPECT_NEAR(0, abs(expected.cells()[i] - result[i]), 1e-12);
+        }
+    }
+}
+
+TEST(testShardedState, wideKernels)
+{
+    // Kernels wider than the 3 local qubits, with a global control
+    const Circuit c = Circuit(qftGate({0, 1, 2, 3, 4}, false)) * Circuit(hnGate({4, 0, 1, 3})) * Circuit(oracleGate({1, 2, 3, 4, 0}, {3, 17, 30})) * Circuit(hnGate({0, 1}).remap({0, 1}, {4})) * Circuit(qftGate({0, 1, 2}, false).remap({0, 1, 2}, {3})) * Circuit(qftGate({4, 2, 0, 1, 3}, true));
+    const Matrix expected = c.matrix() * ketBase(19);
+    const vector<vu::ComplexVect> results = runWorkers<vu::ComplexVect>(4, [&c](const shared_ptr<Transport> &transport)
+                                                                        {
+        ShardedState state(transport, ketBase(19));
+        state.apply(c);
+        return state.ket().cells(); });
+
+    for (const vu::ComplexVect &result : results)
+    {
+        for (size_t i = 0; i < expected.numRows(); i++)
+        {
+            EXPECT_NEAR(0, abs(expected.cells()[i] - result[i]), 1e-12);
+        }
+    }
+}
+
+TEST(testShardedState, at)
+{
+    const vector<complex<double>> results = runWorkers<complex<double>>(2, [](const shared_ptr<Transport> &transport)
+                                                                        {
+        ShardedState state(transport, ketBase(0));
+        state.apply(Circuit(xGate(3)));
+        return state.at(8); });
+
+    EXPECT_EQ(1.0, results[0]);
+    EXPECT_EQ(1.0, results[1]);
+}
+
+TEST(testShardedState, invalidWorkers)
+{
+    const vector<bool> results = runWorkers<bool>(3, [](const shared_ptr<Transport> &transport)
+                                                  {
+        try
+        {
+            ShardedState(transport, ketBase(0));
+            return false;
+        }
+        catch (invalid_argument ex)
+        {
+            return true;
+        } });
+
+    EXPECT_TRUE(results[0]);
+    EXPECT_TRUE(results[2]);
+}
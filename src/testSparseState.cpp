@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+
+#include "sparseState.h"
+#include "testUtils.h"
+
+#define HALF_SQRT2 (sqrt(2) / 2)
+
+using namespace std;
+using namespace mx;
+using namespace tu;
+
+TEST(testSparseState, create)
+{
+    const SparseState s(ketBase(2) + ketBase(0) * 2.0);
+
+    EXPECT_EQ(2, s.numQubits());
+    EXPECT_EQ(2, s.size());
+    EXPECT_EQ(complex<double>(2), s.at(0));
+    EXPECT_EQ(complex<double>(0), s.at(1));
+    EXPECT_EQ(complex<double>(1), s.at(2));
+    EXPECT_EQ("(2) |0> + |2>", to_string(s));
+    EXPECT_EQ(to_string(ketBase(2) + ketBase(0) * 2.0), to_string(s.ket()));
+}
+
+TEST(testSparseState, zero)
+{
+    const SparseState s(3);
+
+    EXPECT_EQ(0, s.size());
+    EXPECT_EQ("(0.0) |7>", to_string(s));
+}
+
+TEST(testSparseState, grow)
+{
+    SparseState s(10);
+    for (uint64_t i = 0; i < 1000; i++)
+    {
+        s.add(i, i + 1.0);
+    }
+    EXPECT_EQ(1000, s.size());
+    for (uint64_t i = 0; i < 1000; i++)
+    {
+        EXPECT_EQ(complex<double>(i + 1.0), s.at(i));
+    }
+}
+
+TEST(testSparseState, cancel)
+{
+    SparseState s(10);
+    s.add(7, 1.0);
+    // Cancelled amplitudes free their slots reused by the next ones
+    for (uint64_t i = 0; i < 1000; i++)
+    {
+        s.add(i + 8, i + 1.0);
+        s.add(i + 8, -(i + 1.0));
+    }
+    EXPECT_EQ(1, s.size());
+    EXPECT_EQ(complex<double>(0), s.at(8));
+    EXPECT_EQ(complex<double>(1), s.at(7));
+    s.add(7, -1.0);
+    EXPECT_EQ(0, s.size());
+    s.add(7, 2.0);
+    EXPECT_EQ(1, s.size());
+    EXPECT_EQ(complex<double>(2), s.at(7));
+    EXPECT_EQ(1, s.amplitudes().size());
+}
+
+TEST(testSparseState, permutation)
+{
+    SparseState s(ketBase(1));
+    s.apply(cnotGate(2, 0));
+
+    EXPECT_EQ(3, s.numQubits());
+    EXPECT_EQ(1, s.size());
+    EXPECT_EQ("|5>", to_string(s));
+
+    s.apply(yGate(0));
+    EXPECT_EQ("(-i) |4>", to_string(s));
+}
+
+TEST(testSparseState, branching)
+{
+    SparseState s(ketBase(0));
+    s.apply(hGate(0));
+
+    EXPECT_EQ(2, s.size());
+    EXPECT_EQ(complex<double>(HALF_SQRT2), s.at(0));
+    EXPECT_EQ(complex<double>(HALF_SQRT2), s.at(1));
+
+    s.apply(hGate(0));
+    EXPECT_EQ(1, s.size());
+    EXPECT_NEAR(1, s.at(0).real(), 1e-12);
+}
+
+TEST(testSparseState, denseEquivalence)
+{
+    const Circuit c = Circuit(hGate(0)) * Circuit(cnotGate(1, 0)) * Circuit(tGate(2)) * Circuit(hGate(2)) * Circuit(swapGate(0, 2)) * Circuit(hGate(1));
+    const Matrix in = ketBase(5);
+    SparseState s(in);
+    s.apply(c);
+    const Matrix exp = c.matrix() * in;
+    const Matrix act = s.ket();
+
+    expectNear(exp, act);
+}
+
+TEST(testSparseState, controlled)
+{
+    const Circuit c = Circuit(hGate(0)) * Circuit(controlledGate(H_GATE, {0}, {2})) * Circuit(controlledGate(X_GATE, {0, 2}, {1})) * Circuit(controlledGate(S_GATE, {1}, {3}));
+    const Matrix in = ketBase(8);
+    SparseState s(in);
+    s.apply(c);
+    const Matrix exp = c.matrix() * in;
+    const Matrix act = s.ket();
+
+    expectNear(exp, act);
+}
+
+TEST(testSparseState, hadamardTransform)
+{
+    const Circuit c = Circuit(hnGate({0, 2})) * Circuit(cnotGate(1, 0)) * Circuit(hnGate({1, 2}));
+    const Matrix in = ketBase(5);
+    SparseState s(in);
+    s.apply(c);
+    const Matrix exp = c.matrix() * in;
+    const Matrix act = s.ket();
+
+    expectNear(exp, act);
+}
+
+TEST(testSparseState, fourier)
+{
+    const Circuit c = Circuit(qftGate({0, 1, 2, 3}, true)) * Circuit(controlledGate(X_GATE, {3}, {1})) * Circuit(qftGate({2, 0, 3}, false).remap({2, 0, 3}, {1})) * Circuit(hGate(1));
+    const Matrix in = ketBase(5).extendsRows(16);
+    SparseState s(in);
+    s.apply(c);
+    expectNear(c.matrix() * in, s.ket());
+
+    // Wider than the dense expansion
+    SparseState wide(ketBase(0));
+    wide.apply(qftGate({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}, false)).apply(qftGate({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}, true));
+    EXPECT_EQ(1, wide.size());
+    EXPECT_NEAR(1, wide.at(0).real(), 1e-9);
+}
+
+TEST(testSparseState, oracle)
+{
+    const Circuit c = Circuit(oracleGate({2, 0}, {1, 2}).remap({2, 0}, {3})) * Circuit(oracleGate({0, 1}, {3})) * Circuit(hnGate({0, 1, 2, 3}));
+    const Matrix in = ketBase(0);
+    SparseState s(in);
+    s.apply(c);
+    const Matrix exp = c.matrix() * ketBase(0).extendsRows(16);
+    const Matrix act = s.ket();
+
+    expectNear(exp, act);
+}
+
+TEST(testSparseState, reversible)
+{
+    const Circuit c = Circuit(reversibleGate({cnotGate(1, 0), ccnotGate(3, 1, 2), swapGate(0, 2)})) * Circuit(hnGate({0, 1, 2}));
+    const Matrix in = ketBase(0).extendsRows(16);
+    SparseState s(in);
+    s.apply(c);
+    const Matrix exp = c.matrix() * in;
+    const Matrix act = s.ket();
+
+    expectNear(exp, act);
+}
+
+TEST(testSparseState, halfAdder)
+{
+    const Circuit ha = Circuit(cnotGate(1, 0)) * Circuit(cnotGate(2, 1)) * Circuit(ccnotGate(3, 1, 2)) * Circuit(cnotGate(1, 0)) * Circuit(ccnotGate(3, 0, 1));
+    for (int in = 0; in < 4; in++)
+    {
+        SparseState s(ketBase(in));
+        s.apply(ha);
+        EXPECT_EQ(to_string(ha.matrix() * ketBase(in)), to_string(s));
+    }
+}
+
+TEST(testSparseState, wideRegister)
+{
+    SparseState s(ketBase(1));
+    s.apply(cnotGate(63, 0))
+        .apply(ccnotGate(40, 63, 0))
+        .apply(swapGate(40, 1))
+        .apply(xGate(0));
+
+    EXPECT_EQ(64, s.numQubits());
+    EXPECT_EQ(1, s.size());
+    EXPECT_EQ(complex<double>(1), s.at((1ULL << 63) | 2));
+    EXPECT_THROW(s.ket(), invalid_argument);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include "tensorNetwork.h"
+
+#define HALF_SQRT2 (sqrt(2) / 2)
+
+using namespace std;
+using namespace mx;
+
+TEST(testTensorNetwork, contract)
+{
+    // Matrix (a) by vector (b): a has indices {col=0, row=1}
+    const Tensor a({0, 1}, {1, 3, 2, 4});
+    const Tensor b({0}, {5, 6});
+    const Tensor c = a.contract(b);
+
+    ASSERT_EQ(1, c.rank());
+    EXPECT_EQ(1, c.indices()[0]);
+    EXPECT_EQ(complex<double>(1 * 5 + 3 * 6), c.cells()[0]);
+    EXPECT_EQ(complex<double>(2 * 5 + 4 * 6), c.cells()[1]);
+}
+
+TEST(testTensorNetwork, outer)
+{
+    const Tensor a({0}, {1, 2});
+    const Tensor b({1}, {3, 4});
+    const Tensor c = a.contract(b);
+
+    ASSERT_EQ(2, c.rank());
+    EXPECT_EQ(complex<double>(8), c.cells()[0b11]);
+    EXPECT_EQ(complex<double>(4), c.cells()[c.indices()[0] == 1 ? 0b01 : 0b10]);
+}
+
+TEST(testTensorNetwork, invalidTensor)
+{
+    EXPECT_THROW(Tensor({0, 1}, {1, 2}), invalid_argument);
+}
+
+TEST(testTensorNetwork, greedyPath)
+{
+    const Circuit bell = Circuit(cnotGate(1, 0)) * Circuit(hGate(0));
+    const TensorNetwork network = TensorNetwork::amplitude(bell, 3, 0);
+    const ContractionPath path = network.greedyPath();
+
+    EXPECT_EQ(network.tensors().size() - 1, path.steps().size());
+    EXPECT_LE(path.peakSize(), 16);
+    EXPECT_NEAR(HALF_SQRT2, network.contract(path).real(), 1e-12);
+}
+
+TEST(testTensorNetwork, optimizePath)
+{
+    Circuit c(hGate(0));
+    for (size_t i = 1; i < 12; i++)
+    {
+        c = Circuit(cnotGate(i, i - 1)) * Circuit(hGate(i)) * c;
+    }
+    const TensorNetwork network = TensorNetwork::amplitude(c, 0, 0);
+    const ContractionPath greedy = network.greedyPath();
+    const ContractionPath best = network.optimizePath(8, 1);
+
+    EXPECT_LE(best.flops(), greedy.flops());
+    EXPECT_NEAR(network.contract(greedy).real(), network.contract(best).real(), 1e-12);
+}
+
+TEST(testTensorNetwork, denseEquivalence)
+{
+    const Circuit c = Circuit(hGate(0)) * Circuit(cnotGate(1, 0)) * Circuit(tGate(2)) * Circuit(hGate(2)) * Circuit(swapGate(0, 2)) * Circuit(hGate(1)) * Circuit(ccnotGate(2, 0, 1)) * Circuit(sGate(0));
+    const Matrix u = c.matrix();
+    for (size_t out = 0; out < 8; out++)
+    {
+        for (size_t in = 0; in < 8; in += 3)
+        {
+            const complex<double> amp = tensorAmplitude(c, out, in);
+            EXPECT_NEAR(u.at(out, in).real(), amp.real(), 1e-12);
+            EXPECT_NEAR(u.at(out, in).imag(), amp.imag(), 1e-12);
+        }
+    }
+}
+
+TEST(testTensorNetwork, wideShallow)
+{
+    // 50 qubits GHZ circuit
+    Circuit ghz(hGate(0));
+    for (size_t i = 1; i < 50; i++)
+    {
+        ghz = Circuit(cnotGate(i, i - 1)) * ghz;
+    }
+
+    EXPECT_NEAR(HALF_SQRT2, tensorAmplitude(ghz, 0, 0).real(), 1e-12);
+    EXPECT_NEAR(HALF_SQRT2, tensorAmplitude(ghz, (1ULL << 50) - 1, 0).real(), 1e-12);
+    EXPECT_NEAR(0, abs(tensorAmplitude(ghz, 1, 0)), 1e-12);
+}
+
+TEST(testTensorNetwork, kernels)
+{
+    const Circuit c = Circuit(qftGate({0, 3, 1}, false)) * Circuit(hnGate({4, 2})) * Circuit(oracleGate({1, 2, 0}, {1, 6})) * Circuit(qftGate({2, 0}, true).remap({2, 0}, {4})) * Circuit(oracleGate({3, 1}, {2}).remap({3, 1}, {0}));
+    const Matrix u = c.matrix();
+    for (size_t out = 0; out < 32; out += 3)
+    {
+        for (size_t in = 0; in < 32; in += 5)
+        {
+            const complex<double> amp = tensorAmplitude(c, out, in);
+            EXPECT_NEAR(u.at(out, in).real(), amp.real(), 1e-12);
+            EXPECT_NEAR(u.at(out, in).imag(), amp.imag(), 1e-12);
+        }
+    }
+}
+
+TEST(testTensorNetwork, wideKernels)
+{
+    // Kernels too large for expansion
+    indices_t qubits;
+    for (size_t i = 0; i < 12; i++)
+    {
+        qubits.push_back(i);
+    }
+
+    EXPECT_NEAR(1.0 / 64, tensorAmplitude(Circuit(hnGate(qubits)), 0, 0).real(), 1e-12);
+    EXPECT_NEAR(1.0 / 64, tensorAmplitude(Circuit(oracleGate(qubits, {3})) * Circuit(hnGate(qubits)), 5, 0).real(), 1e-12);
+    EXPECT_NEAR(-1.0 / 64, tensorAmplitude(Circuit(oracleGate(qubits, {3})) * Circuit(hnGate(qubits)), 3, 0).real(), 1e-12);
+    EXPECT_NEAR(1.0 / 64, abs(tensorAmplitude(Circuit(qftGate(qubits, false)), 7, 3)), 1e-12);
+}
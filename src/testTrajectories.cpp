@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include "trajectories.h"
+#include "densityMatrix.h"
+
+using namespace std;
+using namespace mx;
+
+TEST(testTrajectories, noiseless)
+{
+    const Circuit c = Circuit(cnotGate(1, 0)) * Circuit(xGate(0));
+    const TrajectorySimulator sim(c, 0, NoiseModel{0, 0, 0});
+    const TrajectoryResult result = sim.run(4);
+
+    EXPECT_EQ(4, result.numTrajectories);
+    EXPECT_NEAR(1, result.probabilities[0], 1e-12);
+    EXPECT_NEAR(1, result.probabilities[1], 1e-12);
+    EXPECT_NEAR(0, result.errors[0], 1e-12);
+}
+
+TEST(testTrajectories, deterministic)
+{
+    const Circuit c = Circuit(hGate(1)) * Circuit(cnotGate(1, 0)) * Circuit(hGate(0));
+    const TrajectorySimulator sim(c, 0, NoiseModel{0.1, 0.05, 0.1});
+    const TrajectoryResult a = sim.run(64, 7, 1);
+    const TrajectoryResult b = sim.run(64, 7, 4);
+
+    EXPECT_EQ(a.probabilities, b.probabilities);
+    EXPECT_EQ(a.errors, b.errors);
+}
+
+TEST(testTrajectories, densityAgreement)
+{
+    // The average of trajectories converges to the density matrix probabilities
+    const Circuit c = Circuit(xGate(1)) * Circuit(cnotGate(1, 0)) * Circuit(xGate(0));
+    const double gamma = 0.3;
+    const TrajectorySimulator sim(c, 0, NoiseModel{0, gamma, 0});
+    const TrajectoryResult result = sim.run(2000, 11);
+
+    DensityMatrix rho(ketBase(0));
+    for (const Gate &gate : c.gates())
+    {
+        rho.apply(gate);
+        for (const size_t bit : gate.bits())
+        {
+            rho.dampAmplitude(bit, gamma);
+        }
+    }
+    for (size_t i = 0; i < 2; i++)
+    {
+        EXPECT_GT(result.errors[i], 0);
+        EXPECT_NEAR(rho.probability(i), result.probabilities[i], 4 * result.errors[i]);
+    }
+}
+
+TEST(testTrajectories, invalid)
+{
+    EXPECT_THROW(TrajectorySimulator(Circuit(xGate(0)), 0, NoiseModel{2, 0, 0}), invalid_argument);
+    EXPECT_THROW(TrajectorySimulator(Circuit(xGate(0)), 0, NoiseModel{0, 0, 0}).run(0), invalid_argument);
+}
@@ -0,0 +1,145 @@
+#include <sstream>
+#include <cmath>
+#include <atomic>
+
+#include "trajectories.h"
+
+using namespace std;
+using namespace mx;
+using namespace vu;
+
+static const Matrix DAMP_DECAY(2, 2, {0, 1, 0, 0});
+
+/**
+ * Returns the probability of qubit in state |1>
+ * @param state the state vector
+ * @param qubit the qubit
+ */
+static const double probability1(const ComplexVect &state, const size_t qubit)
+{
+    double result = 0;
+    for (size_t i = 0; i < state.size(); i++)
+    {
+        if ((i >> qubit) & 1)
+        {
+            result += norm(state[i]);
+        }
+    }
+    return result;
+}
+
+TrajectorySimulator::TrajectorySimulator(const Circuit &circuit, const uint64_t in, const NoiseModel &noise)
+    : _circuit(circuit), _in(in), _noise(noise), _numQubits(max(circuit.numQubits(), numBitsByState(in)))
+{
+    for (const double p : {noise.depolarizing, noise.damping, noise.dephasing})
+    {
+        if (!(p >= 0 && p <= 1))
+        {
+            throw invalid_argument(
+                (ostringstream() << "Expected probability in range 0...1, got (" << p << ")")
+                    .str());
+        }
+    }
+    if (_numQubits > MAX_DENSE_QUBITS)
+    {
+        throw invalid_argument(
+            (ostringstream() << "State too large for dense ket: " << _numQubits << " qubits")
+                .str());
+    }
+}
+
+void TrajectorySimulator::applyNoise(ComplexVect &state, const size_t qubit, mt19937_64 &random) const
+{
+    uniform_real_distribution<double> uniform(0, 1);
+    if (_noise.depolarizing > 0 && uniform(random) < _noise.depolarizing)
+    {
+        // Uniform Pauli error
+        static const Matrix *PAULI[] = {&X_GATE, &Y_GATE, &Z_GATE};
+        Gate("E", *PAULI[uniform_int_distribution<int>(0, 2)(random)], {qubit}).apply(state);
+    }
+    if (_noise.damping > 0)
+    {
+        // The decay probability depends on the state
+        const double p = _noise.damping * probability1(state, qubit);
+        if (uniform(random) < p)
+        {
+            Gate("K1", DAMP_DECAY, {qubit}).apply(state);
+        }
+        else
+        {
+            Gate("K0", Matrix(2, 2, {1, 0, 0, sqrt(1 - _noise.damping)}), {qubit}).apply(state);
+        }
+        normalise(state);
+    }
+    if (_noise.dephasing > 0 && uniform(random) < _noise.dephasing)
+    {
+        Gate("E", Z_GATE, {qubit}).apply(state);
+    }
+}
+
+const vector<double> TrajectorySimulator::trajectory(const uint64_t seed) const
+{
+    mt19937_64 random(seed);
+    ComplexVect state(1ULL << _numQubits, 0);
+    state[_in] = 1;
+    for (const Gate &gate : _circuit.gates())
+    {
+        gate.apply(state);
+        for (const size_t bit : gate.qubits())
+        {
+            applyNoise(state, bit, random);
+        }
+    }
+    vector<double> result;
+    for (size_t i = 0; i < _numQubits; i++)
+    {
+        result.push_back(probability1(state, i));
+    }
+    return result;
+}
+
+const TrajectoryResult TrajectorySimulator::run(const size_t numTrajectories, const uint64_t seed, const size_t numThreads) const
+{
+    if (numTrajectories < 1)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected at least 1 trajectory, got (" << numTrajectories << ")")
+                .str());
+    }
+    vector<vector<double>> samples(numTrajectories);
+    atomic<size_t> next(0);
+    const auto task = [this, seed, numTrajectories, &samples, &next]()
+    {
+        for (size_t i = next++; i < numTrajectories; i = next++)
+        {
+            samples[i] = trajectory(streamSeed(seed, i));
+        }
+    };
+    const size_t n = threadCount(numThreads, numTrajectories);
+    parallelFor(n, n, [&task](const size_t from, const size_t to)
+                {
+        for (size_t t = from; t < to; t++)
+        {
+            task();
+        } });
+
+    // Averages in trajectory order to get results independent of the number of threads
+    TrajectoryResult result{numTrajectories, vector<double>(_numQubits, 0), vector<double>(_numQubits, 0)};
+    for (size_t q = 0; q < _numQubits; q++)
+    {
+        double sum = 0;
+        double sum2 = 0;
+        for (const vector<double> &sample : samples)
+        {
+            sum += sample[q];
+            sum2 += sample[q] * sample[q];
+        }
+        const double mean = sum / numTrajectories;
+        const double variance = numTrajectories > 1
+                                    ? max(0.0, (sum2 - numTrajectories * mean * mean) / (numTrajectories - 1))
+                                    : 0;
+        result.probabilities[q] = mean;
+        result.errors[q] = sqrt(variance / numTrajectories);
+    }
+    return result;
+}
@@ -0,0 +1,242 @@
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "transport.h"
+
+using namespace std;
+using namespace mx;
+
+/**
+ * The number of connection attempts to the TCP peers
+ */
+static const int MAX_CONNECT_RETRIES = 300;
+
+static shared_ptr<Transport> processTransport = make_shared<LocalTransport>();
+
+/**
+ * Throws the runtime error with the system error message
+ * @param message the message
+ */
+static void systemError(const string &message)
+{
+    throw runtime_error(message + ": " + strerror(errno));
+}
+
+void Transport::exchange(const size_t peer, const void *sendData, void *recvData, const size_t numBytes)
+{
+    if (rank() < peer)
+    {
+        send(peer, sendData, numBytes);
+        recv(peer, recvData, numBytes);
+    }
+    else
+    {
+        recv(peer, recvData, numBytes);
+        send(peer, sendData, numBytes);
+    }
+}
+
+void LocalTransport::send(const size_t, const void *, const size_t)
+{
+    throw logic_error("Local transport has no peers");
+}
+
+void LocalTransport::recv(const size_t, void *, const size_t)
+{
+    throw logic_error("Local transport has no peers");
+}
+
+SocketTransport::~SocketTransport()
+{
+    for (size_t i = 0; i < _sockets.size(); i++)
+    {
+        if (i != _rank)
+        {
+            close(_sockets[i]);
+        }
+    }
+}
+
+void SocketTransport::send(const size_t peer, const void *data, const size_t numBytes)
+{
+    const char *ptr = (const char *)data;
+    size_t remaining = numBytes;
+    while (remaining > 0)
+    {
+        const ssize_t n = ::send(_sockets.at(peer), ptr, remaining, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            systemError("Transport send failed");
+        }
+        ptr += n;
+        remaining -= n;
+    }
+}
+
+void SocketTransport::recv(const size_t peer, void *data, const size_t numBytes)
+{
+    char *ptr = (char *)data;
+    size_t remaining = numBytes;
+    while (remaining > 0)
+    {
+        const ssize_t n = ::recv(_sockets.at(peer), ptr, remaining, 0);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            systemError("Transport receive failed");
+        }
+        if (n == 0)
+        {
+            throw runtime_error("Transport closed by peer");
+        }
+        ptr += n;
+        remaining -= n;
+    }
+}
+
+const vector<vector<int>> SocketTransport::mesh(const size_t size)
+{
+    vector<vector<int>> result(size, vector<int>(size, -1));
+    for (size_t i = 0; i < size; i++)
+    {
+        for (size_t j = i + 1; j < size; j++)
+        {
+            int fds[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+            {
+                systemError("Socket pair creation failed");
+            }
+            result[i][j] = fds[0];
+            result[j][i] = fds[1];
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the socket connected to the host port
+ * @param host the host
+ * @param port the port
+ */
+static const int connectTo(const string &host, const int port)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    for (int i = 0; i < MAX_CONNECT_RETRIES; i++)
+    {
+        addrinfo *addresses;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) == 0)
+        {
+            for (addrinfo *a = addresses; a != NULL; a = a->ai_next)
+            {
+                const int fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+                if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) == 0)
+                {
+                    freeaddrinfo(addresses);
+                    return fd;
+                }
+                if (fd >= 0)
+                {
+                    close(fd);
+                }
+            }
+            freeaddrinfo(addresses);
+        }
+        // The peer may not listen yet
+        usleep(100000);
+    }
+    throw runtime_error((ostringstream() << "Connection to " << host << ":" << port << " failed").str());
+}
+
+const shared_ptr<SocketTransport> SocketTransport::tcp(const size_t rank, const vector<string> &hosts, const int port)
+{
+    const size_t size = hosts.size();
+    if (rank >= size)
+    {
+        throw invalid_argument(
+            (ostringstream() << "Rank out of range 0..." << (size - 1) << ", got (" << rank << ")")
+                .str());
+    }
+    vector<int> sockets(size, -1);
+    int server = -1;
+    if (rank + 1 < size)
+    {
+        server = socket(AF_INET, SOCK_STREAM, 0);
+        if (server < 0)
+        {
+            systemError("Socket creation failed");
+        }
+        const int on = 1;
+        setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port + rank);
+        if (bind(server, (sockaddr *)&address, sizeof(address)) < 0 || listen(server, size) < 0)
+        {
+            close(server);
+            systemError("Socket listen failed");
+        }
+    }
+    // Connects to the lower ranks sending the own rank
+    for (size_t peer = 0; peer < rank; peer++)
+    {
+        sockets[peer] = connectTo(hosts[peer], port + peer);
+        const uint64_t id = rank;
+        if (::send(sockets[peer], &id, sizeof(id), MSG_NOSIGNAL) != sizeof(id))
+        {
+            systemError("Transport handshake failed");
+        }
+    }
+    // Accepts the higher ranks
+    for (size_t i = rank + 1; i < size; i++)
+    {
+        const int fd = accept(server, NULL, NULL);
+        uint64_t id;
+        if (fd < 0 || ::recv(fd, &id, sizeof(id), MSG_WAITALL) != sizeof(id) || id <= rank || id >= size)
+        {
+            close(server);
+            systemError("Transport handshake failed");
+        }
+        sockets[id] = fd;
+    }
+    if (server >= 0)
+    {
+        close(server);
+    }
+    for (size_t i = 0; i < size; i++)
+    {
+        if (i != rank)
+        {
+            const int on = 1;
+            setsockopt(sockets[i], IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        }
+    }
+    return make_shared<SocketTransport>(rank, sockets);
+}
+
+const shared_ptr<Transport> &mx::defaultTransport(void)
+{
+    return processTransport;
+}
+
+void mx::setDefaultTransport(const shared_ptr<Transport> &transport)
+{
+    processTransport = transport;
+}
@@ -32,6 +32,40 @@ std::ostream &ListValue::write(std::ostream &stream) const
     return stream << ")";
 }
 
+const bool qc::isMatrix(const Value &value)
+{
+    switch (value.type())
+    {
+    case ValueType::matrixValueType:
+    case ValueType::circuitValueType:
+    case ValueType::stateValueType:
+    case ValueType::densityValueType:
+    case ValueType::pauliValueType:
+        return true;
+    default:
+        return false;
+    }
+}
+
+const Matrix qc::matrixOf(const Value &value)
+{
+    switch (value.type())
+    {
+    case ValueType::matrixValueType:
+        return ((const MatrixValue *)&value)->value();
+    case ValueType::circuitValueType:
+        return ((const CircuitValue *)&value)->value().matrix();
+    case ValueType::stateValueType:
+        return ((const StateValue *)&value)->value().ket();
+    case ValueType::densityValueType:
+        return ((const DensityValue *)&value)->value().matrix();
+    case ValueType::pauliValueType:
+        return ((const PauliValue *)&value)->value().matrix();
+    default:
+        throw invalid_argument("Expected matrix value, got " + to_string(value.type()));
+    }
+}
+
 const string to_string(const Value &value)
 {
     stringstream stream;
@@ -61,6 +95,18 @@ const string to_string(const ValueType &type)
     case ValueType::listValueType:
         t = "list";
         break;
+    case ValueType::circuitValueType:
+        t = "circuit";
+        break;
+    case ValueType::stateValueType:
+        t = "state";
+        break;
+    case ValueType::densityValueType:
+        t = "density";
+        break;
+    case ValueType::pauliValueType:
+        t = "pauli";
+        break;
     }
     return t;
 }
@@ -1,3 +1,4 @@
+
 #include "vectutils.h"
 
 using namespace vu;
@@ -132,6 +133,43 @@ ComplexVect &vu::partMul(ComplexVect &d, const size_t dOffset, const size_t numR
     return d;
 }
 
+ComplexVect &vu::blockMul(ComplexVect &d, const ComplexVect &a, const ComplexVect &b,
+                          const size_t numRows, const size_t numInner, const size_t numCols)
+{
+    static const size_t BLOCK_SIZE = 64;
+    d.assign(numRows * numCols, 0);
+    for (size_t i0 = 0; i0 < numRows; i0 += BLOCK_SIZE)
+    {
+        const size_t i1 = min(i0 + BLOCK_SIZE, numRows);
+        for (size_t k0 = 0; k0 < numInner; k0 += BLOCK_SIZE)
+        {
+            const size_t k1 = min(k0 + BLOCK_SIZE, numInner);
+            for (size_t j0 = 0; j0 < numCols; j0 += BLOCK_SIZE)
+            {
+                const size_t j1 = min(j0 + BLOCK_SIZE, numCols);
+                for (size_t i = i0; i < i1; i++)
+                {
+                    for (size_t k = k0; k < k1; k++)
+                    {
+                        const complex<double> aik = a[i * numInner + k];
+                        if (aik == 0.0)
+                        {
+                            continue;
+                        }
+                        const size_t bk = k * numCols;
+                        const size_t di = i * numCols;
+                        for (size_t j = j0; j < j1; j++)
+                        {
+                            d[di + j] += aik * b[bk + j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return d;
+}
+
 const size_t vu::numBitsByState(const size_t state)
 {
     int n = 0;
@@ -142,3 +180,141 @@ const size_t vu::numBitsByState(const size_t state)
     } while ((s >>= 1) != 0);
     return max(n, 1);
 }
+
+/**
+ * The number of cells of the summation blocks
+ */
+static const size_t SUM_BLOCK_SIZE = 1 << 14;
+
+/**
+ * Adds a value to the compensated (Kahan) sum
+ * @param sum the sum
+ * @param c the compensation
+ * @param value the value
+ */
+template <class T>
+static inline void kahanAdd(T &sum, T &c, const T value)
+{
+    const T y = value - c;
+    const T t = sum + y;
+    c = (t - sum) - y;
+    sum = t;
+}
+
+/**
+ * Runs the function on the blocks of cells in parallel
+ * @param size the number of cells
+ * @param f the function of block (from, to)
+ */
+template <class F>
+static void forBlocks(const size_t size, const F &f)
+{
+    const size_t numBlocks = (size + SUM_BLOCK_SIZE - 1) / SUM_BLOCK_SIZE;
+    parallelFor(numBlocks, threadCount(0, numBlocks, size), [&f, size](const size_t from, const size_t to)
+                {
+        for (size_t i = from; i < to; i++)
+        {
+            f(i, i * SUM_BLOCK_SIZE, min(size, (i + 1) * SUM_BLOCK_SIZE));
+        } });
+}
+
+/**
+ * Returns the compensated sum of the block sums in block order (independent of the number of threads)
+ * @param size the number of cells
+ * @param blockSum the function of the sum of block (from, to)
+ */
+template <class T, class F>
+static const T sumBlocks(const size_t size, const F &blockSum)
+{
+    vector<T> partials((size + SUM_BLOCK_SIZE - 1) / SUM_BLOCK_SIZE);
+    forBlocks(size, [&partials, &blockSum](const size_t block, const size_t from, const size_t to)
+              { partials[block] = blockSum(from, to); });
+    T sum = 0;
+    T c = 0;
+    for (const T &partial : partials)
+    {
+        kahanAdd(sum, c, partial);
+    }
+    return sum;
+}
+
+const double vu::norm2(const ComplexVect &a)
+{
+    // Independent compensated lanes over the real and imaginary parts (vectorizable)
+    const double *x = (const double *)a.data();
+    const double sum = sumBlocks<double>(a.size(), [x](const size_t from, const size_t to)
+                                         {
+        double s[4] = {0, 0, 0, 0};
+        double c[4] = {0, 0, 0, 0};
+        size_t i = 2 * from;
+        for (; i + 4 <= 2 * to; i += 4)
+        {
+            for (size_t l = 0; l < 4; l++)
+            {
+                kahanAdd(s[l], c[l], x[i + l] * x[i + l]);
+            }
+        }
+        for (; i < 2 * to; i++)
+        {
+            kahanAdd(s[0], c[0], x[i] * x[i]);
+        }
+        return (s[0] + s[1]) + (s[2] + s[3]); });
+    return sqrt(sum);
+}
+
+const complex<double> vu::inner(const ComplexVect &a, const ComplexVect &b)
+{
+    if (a.size() != b.size())
+    {
+        throw invalid_argument(
+            (ostringstream() << "Expected vectors of same size, got (" << a.size() << ", " << b.size() << ")")
+                .str());
+    }
+    const double *x = (const double *)a.data();
+    const double *y = (const double *)b.data();
+    return sumBlocks<complex<double>>(a.size(), [x, y](const size_t from, const size_t to)
+                                      {
+        // Lanes of real and imaginary parts of even and odd cells
+        double s[4] = {0, 0, 0, 0};
+        double c[4] = {0, 0, 0, 0};
+        size_t i = 2 * from;
+        for (; i + 4 <= 2 * to; i += 4)
+        {
+            kahanAdd(s[0], c[0], x[i] * y[i] + x[i + 1] * y[i + 1]);
+            kahanAdd(s[1], c[1], x[i] * y[i + 1] - x[i + 1] * y[i]);
+            kahanAdd(s[2], c[2], x[i + 2] * y[i + 2] + x[i + 3] * y[i + 3]);
+            kahanAdd(s[3], c[3], x[i + 2] * y[i + 3] - x[i + 3] * y[i + 2]);
+        }
+        for (; i < 2 * to; i += 2)
+        {
+            kahanAdd(s[0], c[0], x[i] * y[i] + x[i + 1] * y[i + 1]);
+            kahanAdd(s[1], c[1], x[i] * y[i + 1] - x[i + 1] * y[i]);
+        }
+        return complex<double>(s[0] + s[2], s[1] + s[3]); });
+}
+
+ComplexVect &vu::normalise(ComplexVect &a)
+{
+    const double n = norm2(a);
+    if (n == 0)
+    {
+        throw invalid_argument("Expected non zero vector");
+    }
+    const double scale = 1 / n;
+    double *x = (double *)a.data();
+    forBlocks(a.size(), [x, scale](const size_t, const size_t from, const size_t to)
+              {
+        for (size_t i = 2 * from; i < 2 * to; i++)
+        {
+            x[i] *= scale;
+        } });
+    return a;
+}
+
+const uint64_t vu::streamSeed(const uint64_t seed, const uint64_t index)
+{
+    uint64_t z = seed + (index + 1) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}